@@ -0,0 +1,213 @@
+#include <flock.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief The parameters of a benchmark run.
+ */
+struct BenchConfig {
+    std::vector<std::size_t> numBoids     = {1000};
+    std::size_t              numPredators = 0;
+    std::size_t              numObstacles = 0;
+    float                    density      = 2.0f; ///< Boids per 100x100 pixel area.
+    std::size_t              numSteps     = 100;
+    std::size_t              numWarmup    = 10;
+    std::size_t              numThreads   = 1;
+    uint64_t                 seed         = 1;
+    boids::UpdateMode        mode         = boids::UpdateMode::DOUBLE_BUFFERED;
+};
+
+/**
+ * @brief The measurements of a single benchmark run.
+ */
+struct BenchResult {
+    std::size_t numBoids;
+    float       sceneSize;
+    double      seconds;
+    double      stepsPerSec;
+    double      nsPerBoidStep;
+    long        peakRssKb;
+};
+
+/**
+ * @brief Print the usage of the benchmark.
+ */
+void printUsage() {
+    std::cerr << "Usage: boids_bench [options]\n"
+              << "  --boids N       Number of boids (default 1000)\n"
+              << "  --predators P   Number of predators (default 0)\n"
+              << "  --obstacles O   Number of obstacles (default 0)\n"
+              << "  --density D     Boids per 100x100 pixel area, sets the scene size (default 2)\n"
+              << "  --steps K       Number of timed steps (default 100)\n"
+              << "  --warmup W      Number of untimed steps before timing (default 10)\n"
+              << "  --threads T     Number of update threads (default 1)\n"
+              << "  --seed S        Random seed (default 1)\n"
+              << "  --in-place      Use the in-place update instead of double buffering\n"
+              << "  --sweep         Sweep the number of boids over 1k, 10k, 100k and 1M\n"
+              << "  --help          Print this message\n";
+}
+
+/**
+ * @brief Parse the command line arguments.
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ * @return Benchmark config.
+ * @throws std::invalid_argument If an argument is unknown or is missing its value.
+ */
+BenchConfig parseArgs(int argc, char* argv[]) {
+    BenchConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help")
+            throw std::invalid_argument("");
+        if (arg == "--sweep") {
+            cfg.numBoids = {1000, 10000, 100000, 1000000};
+            continue;
+        }
+        if (arg == "--in-place") {
+            cfg.mode = boids::UpdateMode::IN_PLACE;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+            throw std::invalid_argument("Missing value for " + arg);
+        const std::string value = argv[++i];
+
+        if (arg == "--boids")
+            cfg.numBoids = {std::stoul(value)};
+        else if (arg == "--predators")
+            cfg.numPredators = std::stoul(value);
+        else if (arg == "--obstacles")
+            cfg.numObstacles = std::stoul(value);
+        else if (arg == "--density")
+            cfg.density = std::stof(value);
+        else if (arg == "--steps")
+            cfg.numSteps = std::stoul(value);
+        else if (arg == "--warmup")
+            cfg.numWarmup = std::stoul(value);
+        else if (arg == "--threads")
+            cfg.numThreads = std::stoul(value);
+        else if (arg == "--seed")
+            cfg.seed = std::stoull(value);
+        else
+            throw std::invalid_argument("Unknown argument " + arg);
+    }
+
+    if (cfg.density <= 0.0f)
+        throw std::invalid_argument("The density must be positive");
+    if (cfg.numSteps == 0)
+        throw std::invalid_argument("The number of steps must be positive");
+    return cfg;
+}
+
+/**
+ * @brief Get the peak resident set size of the process so far.
+ * @return Peak RSS in kilobytes.
+ */
+long getPeakRssKb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/**
+ * @brief Build a flock with a given number of boids, scattered uniformly over a square scene sized
+ * for the configured density, and time a number of update steps.
+ * @param cfg Benchmark config.
+ * @param numBoids Number of boids.
+ * @return Measurements.
+ */
+BenchResult runBenchmark(const BenchConfig& cfg, const std::size_t numBoids) {
+    const float sceneSize = 100.0f * std::sqrt(float(numBoids) / cfg.density);
+
+    const boids::Rect scene(0.0f, 0.0f, sceneSize, sceneSize);
+    boids::Flock      flock(cfg.numThreads, cfg.seed);
+    flock.setSceneBounds(scene);
+    flock.setUpdateMode(cfg.mode);
+
+    flock.spawnUniform(numBoids, scene, boids::BOID);
+    flock.spawnUniform(cfg.numPredators, scene, boids::PREDATOR);
+    flock.spawnUniform(cfg.numObstacles, scene, boids::OBSTACLE);
+
+    for (std::size_t i = 0; i < cfg.numWarmup; ++i) {
+        flock.update();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < cfg.numSteps; ++i) {
+        flock.update();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    BenchResult result;
+    result.numBoids      = numBoids;
+    result.sceneSize     = sceneSize;
+    result.seconds       = std::chrono::duration<double>(end - start).count();
+    result.stepsPerSec   = double(cfg.numSteps) / result.seconds;
+    result.nsPerBoidStep = result.seconds * 1e9 / (double(cfg.numSteps) * double(numBoids));
+    result.peakRssKb     = getPeakRssKb();
+    return result;
+}
+
+/**
+ * @brief Write the benchmark config and results as JSON.
+ * @param os Stream to write to.
+ * @param cfg Benchmark config.
+ * @param results Measurements, one per number of boids.
+ */
+void writeJson(std::ostream& os, const BenchConfig& cfg, const std::vector<BenchResult>& results) {
+    os << "{\n"
+       << "  \"predators\": " << cfg.numPredators << ",\n"
+       << "  \"obstacles\": " << cfg.numObstacles << ",\n"
+       << "  \"density\": " << cfg.density << ",\n"
+       << "  \"steps\": " << cfg.numSteps << ",\n"
+       << "  \"warmup\": " << cfg.numWarmup << ",\n"
+       << "  \"threads\": " << cfg.numThreads << ",\n"
+       << "  \"seed\": " << cfg.seed << ",\n"
+       << "  \"mode\": \""
+       << (cfg.mode == boids::UpdateMode::IN_PLACE ? "in_place" : "double_buffered") << "\",\n"
+       << "  \"results\": [";
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        os << (i == 0 ? "\n" : ",\n") << "    {\"boids\": " << r.numBoids
+           << ", \"scene_size\": " << r.sceneSize << ", \"seconds\": " << r.seconds
+           << ", \"steps_per_sec\": " << r.stepsPerSec
+           << ", \"ns_per_boid_step\": " << r.nsPerBoidStep
+           << ", \"peak_rss_kb\": " << r.peakRssKb << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchConfig cfg;
+    try {
+        cfg = parseArgs(argc, argv);
+    } catch (const std::exception& e) {
+        if (*e.what())
+            std::cerr << e.what() << "\n";
+        printUsage();
+        return 1;
+    }
+
+    // The peak RSS only ever grows, so the runs go from the smallest to the largest flock to keep
+    // each measurement meaningful.
+    std::vector<BenchResult> results;
+    for (const std::size_t numBoids : cfg.numBoids) {
+        std::cerr << "Running " << numBoids << " boids..." << std::endl;
+        results.push_back(runBenchmark(cfg, numBoids));
+    }
+
+    writeJson(std::cout, cfg, results);
+    return 0;
+}
@@ -27,17 +27,20 @@ ButtonGroup::ButtonGroup(QWidget* parent) : QWidget(parent) {
     m_clearBoids = new QPushButton("Clear Boids", this);
     m_clearObs   = new QPushButton("Clear Obstacles", this);
     m_clearPred  = new QPushButton("Clear Predators", this);
+    m_saveTrace  = new QPushButton("Save Trace...", this);
 
     m_layout->addLayout(add_boids_button_layout_);
     m_layout->addWidget(m_clearAll);
     m_layout->addWidget(m_clearBoids);
     m_layout->addWidget(m_clearObs);
     m_layout->addWidget(m_clearPred);
+    m_layout->addWidget(m_saveTrace);
 
     QObject::connect(m_clearAll, &QPushButton::clicked, this, &ButtonGroup::onClearAllPressed);
     QObject::connect(m_clearBoids, &QPushButton::clicked, this, &ButtonGroup::onClearBoidsPressed);
     QObject::connect(m_clearObs, &QPushButton::clicked, this, &ButtonGroup::onClearObsPressed);
     QObject::connect(m_clearPred, &QPushButton::clicked, this, &ButtonGroup::onClearPredPressed);
+    QObject::connect(m_saveTrace, &QPushButton::clicked, this, &ButtonGroup::saveTrace);
 }
 
 void ButtonGroup::onAddBoids1() { emit addBoids(10); }
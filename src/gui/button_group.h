@@ -1,6 +1,6 @@
 #pragma once
 
-#include "boids.h"
+#include "qt_adapter.h"
 #include <QPushButton>
 #include <QVBoxLayout>
 #include <QWidget>
@@ -11,9 +11,9 @@ namespace ui {
  * @class ButtonGroup
  * @brief A custom QWidget that provides buttons for clearing various types of items.
  *
- * This widget contains buttons to clear all items, boids, obstacles, and predators.
- * It emits signals when these buttons are pressed, allowing other parts of the system
- * to respond to these actions.
+ * This widget contains buttons to clear all items, boids, obstacles, and predators, and to save
+ * a timeline trace. It emits signals when these buttons are pressed, allowing other parts of the
+ * system to respond to these actions.
  */
 class ButtonGroup : public QWidget {
     Q_OBJECT
@@ -45,6 +45,9 @@ class ButtonGroup : public QWidget {
     QPushButton* add_boids_2_;
     QPushButton* add_boids_3_;
 
+    // Button for writing out a timeline trace
+    QPushButton* m_saveTrace;
+
   signals:
     /**
      * @brief Add a number of boids the simulation.
@@ -62,6 +65,11 @@ class ButtonGroup : public QWidget {
      */
     void clearBoids(const std::vector<boids::BoidType>& types);
 
+    /**
+     * @brief Signal emitted when the "Save Trace" button is pressed.
+     */
+    void saveTrace();
+
   private slots:
     /**
      * @brief Slot triggered when the first "Add Boids" button is pressed.
@@ -9,11 +9,15 @@ ControlPanelWidget::ControlPanelWidget(QWidget* parent) : QWidget(parent) {
     m_buttonGroup      = std::make_unique<ButtonGroup>(this);
     m_boidCfgGroup     = std::make_unique<ConfigGroup>("Boid Config", this);
     m_predatorCfgGroup = std::make_unique<ConfigGroup>("Predator Config", this);
+    m_simGroup         = std::make_unique<SimGroup>(this);
+    m_perfGroup        = std::make_unique<PerfGroup>(this);
 
     QVBoxLayout* layout = new QVBoxLayout(this);
     layout->addWidget(m_buttonGroup.get());
     layout->addWidget(m_boidCfgGroup.get());
     layout->addWidget(m_predatorCfgGroup.get());
+    layout->addWidget(m_simGroup.get());
+    layout->addWidget(m_perfGroup.get());
     layout->addStretch();
 }
 } // namespace ui
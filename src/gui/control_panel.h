@@ -2,6 +2,8 @@
 
 #include "button_group.h"
 #include "config_group.h"
+#include "perf_group.h"
+#include "sim_group.h"
 #include <QWidget>
 
 namespace ui {
@@ -14,6 +16,8 @@ class ControlPanelWidget : public QWidget {
     std::unique_ptr<ButtonGroup> m_buttonGroup;
     std::unique_ptr<ConfigGroup> m_boidCfgGroup;
     std::unique_ptr<ConfigGroup> m_predatorCfgGroup;
+    std::unique_ptr<SimGroup>    m_simGroup;
+    std::unique_ptr<PerfGroup>   m_perfGroup;
     ControlPanelWidget(QWidget* parent = nullptr);
 };
 
@@ -1,28 +1,22 @@
 #include "dialog.h"
 #include "displaygraphicsview.h"
+#include "qt_adapter.h"
+#include <QFileDialog>
+#include <QMessageBox>
 #include <boids.h>
-#include <random>
-
-/**
- * @brief Generate a random float value within a given range using a uniform distribution.
- * @param min_value The minimum value of the range.
- * @param max_value The maximum value of the range.
- * @return Random value.
- */
-float generateRandomNumber(const float min_value, const float max_value) {
-    std::random_device             rd;
-    std::mt19937                   gen(rd());
-    std::uniform_real_distribution distr(min_value, max_value);
-    return distr(gen);
-}
+#include <chrono>
+#include <trace.h>
 
 Dialog::Dialog(QWidget* parent) : QMainWindow(parent) {
 
+    // Recording is cheap and keeps only the most recent events, so it is left on for the whole
+    // session, ready to be saved at any point.
+    boids::trace::setEnabled(true);
+    BOIDS_TRACE_THREAD_NAME("GUI");
+
     m_flock = std::make_shared<boids::Flock>();
     m_sim   = new SimThread(m_flock, this);
 
-    qRegisterMetaType<QList<boids::Boid>>("QList<boids::Boid>");
-
     m_control = new ui::ControlPanelWidget(this);
     m_control->setFixedWidth(300);
 
@@ -48,52 +42,67 @@ Dialog::~Dialog() {
 void Dialog::resizeEvent(QResizeEvent* event) {
     QMainWindow::resizeEvent(event);
     const QRectF rect = m_graphicsView->mapToScene(m_graphicsView->rect()).boundingRect();
-    m_flock->setSceneBounds(rect);
+    m_flock->post(boids::command::SetSceneBounds{ui::fromQt(rect)});
+}
+
+void Dialog::onFrameReady() {
+    const boids::FlockSnapshot* snapshot = m_sim->takeSnapshot();
+    if (!snapshot)
+        return;
+
+    const auto start = std::chrono::steady_clock::now();
+    m_graphicsView->renderSnapshot(*snapshot);
+    const auto end = std::chrono::steady_clock::now();
+    m_control->m_perfGroup->addFrame(*snapshot, end - start, end - snapshot->time);
 }
 
 void Dialog::onConfigChanged() {
     const auto boidCfg = m_control->m_boidCfgGroup->getConfig();
     const auto predCfg = m_control->m_predatorCfgGroup->getConfig();
-    m_flock->setConfig(boidCfg, boids::BOID);
-    m_flock->setConfig(predCfg, boids::PREDATOR);
+    m_flock->post(boids::command::SetConfig{boidCfg, boids::BOID});
+    m_flock->post(boids::command::SetConfig{predCfg, boids::PREDATOR});
+}
+
+void Dialog::onNumThreadsChanged(const std::size_t numThreads) {
+    m_flock->setNumThreads(numThreads);
 }
 
+void Dialog::onUpdateModeChanged(const boids::UpdateMode mode) { m_flock->setUpdateMode(mode); }
+
 void Dialog::addBoids(const std::size_t count) {
-    const QRectF rect  = m_graphicsView->mapToScene(m_graphicsView->rect()).boundingRect();
-    const float  min_x = rect.left();
-    const float  max_x = rect.right();
-    const float  min_y = rect.top();
-    const float  max_y = rect.bottom();
-
-    for (std::size_t i = 0; i < count; ++i) {
-        const float x = generateRandomNumber(min_x, max_x);
-        const float y = generateRandomNumber(min_y, max_y);
-        createBoid(QPointF(x, y), boids::BoidType::BOID);
-    }
+    const QRectF rect = m_graphicsView->mapToScene(m_graphicsView->rect()).boundingRect();
+    m_flock->post(boids::command::SpawnUniform{count, ui::fromQt(rect), boids::BoidType::BOID});
 }
 
 void Dialog::createBoid(const QPointF& pos, const boids::BoidType& type) {
-    m_flock->addBoid(pos.x(), pos.y(), type);
+    m_flock->post(boids::command::AddBoid{float(pos.x()), float(pos.y()), type});
 }
 
 void Dialog::clearBoids(const std::vector<boids::BoidType>& types) {
-    const auto boids = m_flock->getBoids();
-
     for (const auto& t : types) {
-        m_graphicsView->clearBoids(boids.at(t));
-        m_flock->clearBoids(t);
+        m_flock->post(boids::command::ClearBoidsOfType{t});
     }
 }
 
+void Dialog::saveTrace() {
+    const QString path =
+        QFileDialog::getSaveFileName(this, "Save Trace", "boids_trace.json", "Trace (*.json)");
+    if (path.isEmpty())
+        return;
+    if (!boids::trace::writeChromeTrace(path.toStdString()))
+        QMessageBox::warning(this, "Save Trace", "Could not write " + path);
+}
+
 void Dialog::run() {
     m_control->m_boidCfgGroup->setConfig(m_flock->getConfig(boids::BOID));
     m_control->m_predatorCfgGroup->setConfig(m_flock->getConfig(boids::PREDATOR));
+    m_control->m_simGroup->setNumThreads(m_flock->getNumThreads());
+    m_control->m_simGroup->setUpdateMode(m_flock->getUpdateMode());
 
     QObject::connect(m_graphicsView, &ui::DisplayGraphicsView::createItem, this,
                      &Dialog::createBoid);
 
-    QObject::connect(m_sim, &SimThread::update, m_graphicsView,
-                     &ui::DisplayGraphicsView::renderBoids);
+    QObject::connect(m_sim, &SimThread::frameReady, this, &Dialog::onFrameReady);
 
     QObject::connect(m_control->m_boidCfgGroup.get(), &ui::ConfigGroup::configChanged, this,
                      &Dialog::onConfigChanged);
@@ -101,14 +110,23 @@ void Dialog::run() {
     QObject::connect(m_control->m_predatorCfgGroup.get(), &ui::ConfigGroup::configChanged, this,
                      &Dialog::onConfigChanged);
 
+    QObject::connect(m_control->m_simGroup.get(), &ui::SimGroup::numThreadsChanged, this,
+                     &Dialog::onNumThreadsChanged);
+
+    QObject::connect(m_control->m_simGroup.get(), &ui::SimGroup::updateModeChanged, this,
+                     &Dialog::onUpdateModeChanged);
+
     QObject::connect(m_control->m_buttonGroup.get(), &ui::ButtonGroup::clearBoids, this,
                      &Dialog::clearBoids);
 
     QObject::connect(m_control->m_buttonGroup.get(), &ui::ButtonGroup::addBoids, this,
                      &Dialog::addBoids);
 
+    QObject::connect(m_control->m_buttonGroup.get(), &ui::ButtonGroup::saveTrace, this,
+                     &Dialog::saveTrace);
+
     const QRectF rect = m_graphicsView->mapToScene(m_graphicsView->rect()).boundingRect();
-    m_flock->setSceneBounds(rect);
+    m_flock->setSceneBounds(ui::fromQt(rect));
 
     m_sim->start();
 }
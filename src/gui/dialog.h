@@ -28,8 +28,26 @@ class Dialog : public QMainWindow {
     std::shared_ptr<boids::Flock> m_flock;
 
   private slots:
+    /**
+     * @brief Render the latest snapshot published by the simulation thread, if there is one, and
+     * add it to the performance readout.
+     */
+    void onFrameReady();
+
     void onConfigChanged();
 
+    /**
+     * @brief Set the number of threads used to update the flock.
+     * @param numThreads Number of threads.
+     */
+    void onNumThreadsChanged(const std::size_t numThreads);
+
+    /**
+     * @brief Set the mode used to update the flock.
+     * @param mode Update mode.
+     */
+    void onUpdateModeChanged(const boids::UpdateMode mode);
+
     /**
      * @brief Add multiple boids to the simulation.
      *
@@ -54,4 +72,10 @@ class Dialog : public QMainWindow {
      * @param types The types of boids to clear.
      */
     void clearBoids(const std::vector<boids::BoidType>& types);
+
+    /**
+     * @brief Ask for a file name, and write the timeline trace recorded so far to it, for loading
+     * into chrome://tracing or Perfetto.
+     */
+    void saveTrace();
 };
@@ -3,7 +3,10 @@
 #include "boids.h"
 #include <QMouseEvent>
 #include <QtMath>
+#include <algorithm>
+#include <cmath>
 #include <random>
+#include <trace.h>
 
 template <typename T> T generateRandomValue(const T minValue, const T maxValue) {
     std::random_device              rd;        // obtain a random number from hardware
@@ -36,8 +39,8 @@ void DisplayGraphicsView::mousePressEvent(QMouseEvent* event) {
     }
 }
 
-void DisplayGraphicsView::renderBoid(const uint16_t& id, const QPointF& pos, const float& angle,
-                                     const QColor& color) {
+void DisplayGraphicsView::renderBoid(const boids::BoidId& id, const QPointF& pos,
+                                     const float& angle, const QColor& color) {
 
     if (!m_displayItems.contains(id)) {
         m_displayItems[id] = std::make_unique<Boid>(pos, angle, color);
@@ -55,14 +58,14 @@ void DisplayGraphicsView::renderCircle(const QPointF& pos, const float& radius)
     m_scene->addItem(circle);
 }
 
-void DisplayGraphicsView::renderObstacle(const uint16_t& id, const QPointF& pos) {
+void DisplayGraphicsView::renderObstacle(const boids::BoidId& id, const QPointF& pos) {
     if (!m_displayItems.contains(id)) {
         m_displayItems[id] = std::make_unique<Obstacle>(pos, QColor(Qt::lightGray), 8.0f);
         m_scene->addItem(m_displayItems[id].get());
     }
 }
 
-void DisplayGraphicsView::renderPredator(const uint16_t& id, const QPointF& pos,
+void DisplayGraphicsView::renderPredator(const boids::BoidId& id, const QPointF& pos,
                                          const float& angle) {
     if (!m_displayItems.contains(id)) {
         m_displayItems[id] = std::make_unique<Predator>(pos, angle, QColor(Qt::red));
@@ -72,32 +75,48 @@ void DisplayGraphicsView::renderPredator(const uint16_t& id, const QPointF& pos,
     m_displayItems[id]->setRotation(angle);
 }
 
-void DisplayGraphicsView::renderBoids(const QList<boids::Boid>& boids) {
-    for (const boids::Boid& b : boids) {
-        switch (b.getType()) {
-            case boids::BoidType::BOID:
-                renderBoid(b.getId(), b.getPosition(), qRadiansToDegrees(b.getAngle()),
-                           b.getColor());
-                m_displayItems[b.getId()]->setColor(b.getColor());
+void DisplayGraphicsView::renderSnapshot(const boids::FlockSnapshot& snapshot) {
+    BOIDS_TRACE_ZONE("DisplayGraphicsView::renderSnapshot");
+    BOIDS_TRACE_FLOW_END(snapshot.step);
+
+    const boids::FlockState& s = snapshot.state;
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        const QPointF pos(s.x[i], s.y[i]);
+        const float   angle = qRadiansToDegrees(std::atan2(s.vy[i], s.vx[i]));
+        switch (s.type[i]) {
+            case boids::BoidType::BOID: {
+                const QColor color = QColor::fromHsv(int(s.hue[i]), s.saturation[i], s.value[i]);
+                renderBoid(s.id[i], pos, angle, color);
+                m_displayItems[s.id[i]]->setColor(color);
                 break;
+            }
             case boids::OBSTACLE:
-                renderObstacle(b.getId(), b.getPosition());
+                renderObstacle(s.id[i], pos);
                 break;
             case boids::PREDATOR:
-                renderPredator(b.getId(), b.getPosition(), qRadiansToDegrees(b.getAngle()));
+                renderPredator(s.id[i], pos, angle);
                 break;
             default:
                 break;
         }
     }
+
+    // Every boid in the snapshot now has a display item, and the IDs are unique, so there are only
+    // items left over from removed boids if there are more items than boids.
+    if (m_displayItems.size() > s.size())
+        removeStaleItems(s);
 }
 
-void DisplayGraphicsView::clearBoids(const std::vector<boids::Boid>& boids) {
-    for (const auto& boid : boids) {
-        const auto id = boid.getId();
-        m_scene->removeItem(m_displayItems.at(id).get());
-        m_displayItems.at(id).release();
-        m_displayItems.erase(id);
+void DisplayGraphicsView::removeStaleItems(const boids::FlockState& state) {
+    std::vector<boids::BoidId> ids(state.id.begin(), state.id.end());
+    std::sort(ids.begin(), ids.end());
+    for (auto it = m_displayItems.begin(); it != m_displayItems.end();) {
+        if (std::binary_search(ids.begin(), ids.end(), it->first)) {
+            ++it;
+            continue;
+        }
+        m_scene->removeItem(it->second.get());
+        it = m_displayItems.erase(it);
     }
 }
 
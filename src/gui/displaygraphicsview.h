@@ -1,11 +1,12 @@
 #pragma once
 
 #include "boid.h"
+#include "qt_adapter.h"
 #include <boids.h>
+#include <flock.h>
 
 #include <QGraphicsScene>
 #include <QGraphicsView>
-#include <QList>
 #include <QObject>
 
 namespace ui {
@@ -24,7 +25,7 @@ class DisplayGraphicsView : public QGraphicsView {
      * @param pos Position of the Boid.
      * @param angle Heading of the Boid.
      */
-    void renderBoid(const uint16_t& id, const QPointF& pos, const float& angle,
+    void renderBoid(const boids::BoidId& id, const QPointF& pos, const float& angle,
                     const QColor& color);
 
     /**
@@ -38,25 +39,35 @@ class DisplayGraphicsView : public QGraphicsView {
      * @brief Render an Obstacle Boid at a given position.
      * @param pos Position of the obstacle.
      */
-    void renderObstacle(const uint16_t& id, const QPointF& pos);
+    void renderObstacle(const boids::BoidId& id, const QPointF& pos);
 
     /**
      * @brief Render a Predator Boid.
      * @param pos Position of the Boid.
      * @param angle Heading of the Boid.
      */
-    void renderPredator(const uint16_t& id, const QPointF& pos, const float& angle);
+    void renderPredator(const boids::BoidId& id, const QPointF& pos, const float& angle);
+
+    /**
+     * @brief Remove the display items of any boids that are no longer in the flock.
+     * @param state State of the flock.
+     */
+    void removeStaleItems(const boids::FlockState& state);
 
   private:
-    std::map<const uint16_t, std::unique_ptr<Boid>> m_displayItems;
+    std::map<const boids::BoidId, std::unique_ptr<Boid>> m_displayItems;
 
   signals:
     void createItem(const QPointF pos, const boids::BoidType& type = boids::BoidType::BOID);
 
   public slots:
     void mousePressEvent(QMouseEvent* event) override;
-    void renderBoids(const QList<boids::Boid>& boids);
-    void clearBoids(const std::vector<boids::Boid>& boids);
+
+    /**
+     * @brief Render all the boids in a snapshot of the flock.
+     * @param snapshot Snapshot to render.
+     */
+    void renderSnapshot(const boids::FlockSnapshot& snapshot);
 };
 
 } // namespace ui
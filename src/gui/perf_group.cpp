@@ -0,0 +1,99 @@
+#include "perf_group.h"
+#include <QVBoxLayout>
+
+namespace ui {
+
+// How often the labels are refreshed.
+constexpr std::chrono::milliseconds REFRESH_INTERVAL(250);
+
+// Time available to step and render a frame at 60 frames per second, in milliseconds. The step
+// and render times are highlighted when they add up to more than this.
+constexpr double FRAME_BUDGET_MS = 1000.0 / 60.0;
+
+/**
+ * @brief Format a time in milliseconds.
+ * @param ns Time in nanoseconds.
+ * @return Formatted time.
+ */
+QString formatMs(const double ns) { return QString::number(ns / 1e6, 'f', 2) + " ms"; }
+
+PerfGroup::PerfGroup(QWidget* parent)
+    : QWidget(parent), m_frames(0), m_renderTime(0), m_age(0), m_lastStep(0) {
+    m_form = new QFormLayout();
+
+    m_ticksLabel          = createLabel("Ticks/s:");
+    m_stepLabel           = createLabel("Step:");
+    m_commandsLabel       = createLabel("  Commands:");
+    m_gridLabel           = createLabel("  Grid:");
+    m_neighboursLabel     = createLabel("  Neighbours:");
+    m_integrateLabel      = createLabel("  Integrate:");
+    m_renderLabel         = createLabel("Render:");
+    m_ageLabel            = createLabel("Snapshot Age:");
+    m_boidsLabel          = createLabel("Boids:");
+    m_meanNeighboursLabel = createLabel("Avg Neighbours:");
+
+    // The neighbour and integrate times are summed over the threads.
+    m_neighboursLabel->setToolTip("CPU time, summed over all the threads");
+    m_integrateLabel->setToolTip("CPU time, summed over all the threads");
+
+    m_groupBox = new QGroupBox("Performance", this);
+    m_groupBox->setLayout(m_form);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(m_groupBox);
+}
+
+QLabel* PerfGroup::createLabel(const QString& name) {
+    QLabel* label = new QLabel("-", this);
+    m_form->addRow(name, label);
+    return label;
+}
+
+void PerfGroup::addFrame(const boids::FlockSnapshot& snapshot,
+                         const std::chrono::nanoseconds& renderTime,
+                         const std::chrono::nanoseconds& age) {
+    m_frames++;
+    m_renderTime += renderTime;
+    m_age += age;
+
+    const auto elapsed = snapshot.time - m_lastTime;
+    if (elapsed < REFRESH_INTERVAL)
+        return;
+
+    // The step count restarts when the flock is reseeded.
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    const double ticks   = snapshot.step >= m_lastStep ? (snapshot.step - m_lastStep) / seconds : 0;
+    m_ticksLabel->setText(QString::number(ticks, 'f', 0));
+
+    const double renderNs = double(m_renderTime.count()) / m_frames;
+    m_renderLabel->setText(formatMs(renderNs));
+    m_ageLabel->setText(formatMs(double(m_age.count()) / m_frames));
+    m_boidsLabel->setText(QString::number(snapshot.state.size()));
+
+#ifdef BOIDS_STEP_STATS
+    const boids::StepStats& s = snapshot.stats;
+    m_stepLabel->setText(formatMs(s.totalNs));
+    m_commandsLabel->setText(formatMs(s.commandsNs));
+    m_gridLabel->setText(formatMs(s.gridNs));
+    m_neighboursLabel->setText(formatMs(s.neighboursNs));
+    m_integrateLabel->setText(formatMs(s.integrateNs));
+    m_meanNeighboursLabel->setText(QString::number(s.getMeanNeighbours(), 'f', 1));
+
+    // Flag frames that no longer fit in the budget, e.g. after raising the neighbourhood radius.
+    const bool    overBudget = (s.totalNs + renderNs) / 1e6 > FRAME_BUDGET_MS;
+    const QString style      = overBudget ? "color: red" : "";
+    m_stepLabel->setStyleSheet(style);
+    m_renderLabel->setStyleSheet(style);
+#else
+    // The step stats are compiled out of libboids, so only the GUI side can be shown.
+    m_stepLabel->setText("n/a");
+#endif
+
+    m_frames     = 0;
+    m_renderTime = std::chrono::nanoseconds(0);
+    m_age        = std::chrono::nanoseconds(0);
+    m_lastStep   = snapshot.step;
+    m_lastTime   = snapshot.time;
+}
+
+} // namespace ui
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "flock.h"
+#include <QFormLayout>
+#include <QGroupBox>
+#include <QLabel>
+#include <QWidget>
+#include <chrono>
+
+namespace ui {
+
+/**
+ * @brief The PerfGroup class is a GUI widget showing how the simulation and the rendering are
+ * performing: the sim ticks per second, the step time split by phase, the render time, the age of
+ * the snapshot when it was drawn, the boid count and the average neighbours per boid.
+ *
+ * The readout is fed from the snapshots the GUI already receives through the lock-free triple
+ * buffer (see SimThread), which carry the flock's recent step stats, so the sim thread never
+ * waits on it. The labels are only refreshed a few times a second, to keep them readable and cheap.
+ */
+class PerfGroup : public QWidget {
+    Q_OBJECT
+
+  public:
+    /**
+     * @brief Construct a new PerfGroup widget.
+     * @param parent The parent widget.
+     */
+    PerfGroup(QWidget* parent = nullptr);
+
+    /**
+     * @brief Add a rendered frame to the readout.
+     * @param snapshot Snapshot that was rendered.
+     * @param renderTime Time taken to render the snapshot.
+     * @param age Time between the snapshot being taken and it being rendered.
+     */
+    void addFrame(const boids::FlockSnapshot& snapshot, const std::chrono::nanoseconds& renderTime,
+                  const std::chrono::nanoseconds& age);
+
+  private:
+    /**
+     * @brief Add a label to the form.
+     * @param name Name of the row.
+     * @return The label.
+     */
+    QLabel* createLabel(const QString& name);
+
+    QGroupBox*   m_groupBox;
+    QFormLayout* m_form;
+
+    QLabel* m_ticksLabel;
+    QLabel* m_stepLabel;
+    QLabel* m_commandsLabel;
+    QLabel* m_gridLabel;
+    QLabel* m_neighboursLabel;
+    QLabel* m_integrateLabel;
+    QLabel* m_renderLabel;
+    QLabel* m_ageLabel;
+    QLabel* m_boidsLabel;
+    QLabel* m_meanNeighboursLabel;
+
+    // Frames added since the labels were last refreshed.
+    std::size_t                           m_frames;
+    std::chrono::nanoseconds              m_renderTime;
+    std::chrono::nanoseconds              m_age;
+    uint64_t                              m_lastStep;
+    std::chrono::steady_clock::time_point m_lastTime;
+};
+
+} // namespace ui
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <boids.h>
+#include <types.h>
+
+#include <QColor>
+#include <QMetaType>
+#include <QPointF>
+#include <QRectF>
+#include <QVector2D>
+
+// Declare Qt meta types
+Q_DECLARE_METATYPE(boids::BoidType);
+Q_DECLARE_METATYPE(std::vector<boids::BoidType>);
+
+namespace ui {
+
+/**
+ * @brief Convert a libboids vector to a Qt point.
+ * @param v Vector.
+ * @return Qt point.
+ */
+inline QPointF toQPointF(const boids::Vec2& v) { return QPointF(v.x(), v.y()); }
+
+/**
+ * @brief Convert a libboids vector to a Qt vector.
+ * @param v Vector.
+ * @return Qt vector.
+ */
+inline QVector2D toQVector2D(const boids::Vec2& v) { return QVector2D(v.x(), v.y()); }
+
+/**
+ * @brief Convert a libboids rectangle to a Qt rectangle.
+ * @param r Rectangle.
+ * @return Qt rectangle.
+ */
+inline QRectF toQRectF(const boids::Rect& r) {
+    return QRectF(r.left(), r.top(), r.width(), r.height());
+}
+
+/**
+ * @brief Convert a libboids colour to a Qt colour.
+ * @param c Colour.
+ * @return Qt colour.
+ */
+inline QColor toQColor(const boids::Color& c) {
+    return QColor::fromHsv(c.hsvHue(), c.saturation(), c.value(), c.alpha());
+}
+
+/**
+ * @brief Convert a Qt point to a libboids vector.
+ * @param p Qt point.
+ * @return Vector.
+ */
+inline boids::Vec2 fromQt(const QPointF& p) { return boids::Vec2(p.x(), p.y()); }
+
+/**
+ * @brief Convert a Qt vector to a libboids vector.
+ * @param v Qt vector.
+ * @return Vector.
+ */
+inline boids::Vec2 fromQt(const QVector2D& v) { return boids::Vec2(v.x(), v.y()); }
+
+/**
+ * @brief Convert a Qt rectangle to a libboids rectangle.
+ * @param r Qt rectangle.
+ * @return Rectangle.
+ */
+inline boids::Rect fromQt(const QRectF& r) {
+    return boids::Rect(r.left(), r.top(), r.width(), r.height());
+}
+
+/**
+ * @brief Convert a Qt colour to a libboids colour.
+ * @param c Qt colour.
+ * @return Colour.
+ */
+inline boids::Color fromQt(const QColor& c) {
+    return boids::Color::fromHsv(c.hsvHue(), c.hsvSaturation(), c.value(), c.alpha());
+}
+
+} // namespace ui
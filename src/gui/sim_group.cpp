@@ -0,0 +1,53 @@
+#include "sim_group.h"
+#include <QFormLayout>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <thread>
+
+namespace ui {
+
+SimGroup::SimGroup(QWidget* parent) : QWidget(parent) {
+    m_threadsSpinBox = new QSpinBox(this);
+    m_threadsSpinBox->setMinimum(1);
+    m_threadsSpinBox->setMaximum(std::max(1u, std::thread::hardware_concurrency()));
+    m_threadsSpinBox->setToolTip("Only the double-buffered update is split across threads");
+
+    // The flock starts with the in-place update, which always runs on a single thread.
+    m_doubleBufferedCheckBox = new QCheckBox(this);
+    m_doubleBufferedCheckBox->setChecked(false);
+    m_threadsSpinBox->setEnabled(false);
+
+    QFormLayout* form = new QFormLayout();
+    form->addRow("Threads:", m_threadsSpinBox);
+    form->addRow("Double Buffered:", m_doubleBufferedCheckBox);
+
+    m_groupBox = new QGroupBox("Simulation", this);
+    m_groupBox->setLayout(form);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(m_groupBox);
+
+    QObject::connect(m_threadsSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this,
+                     &SimGroup::onThreadsValueChanged);
+    QObject::connect(m_doubleBufferedCheckBox, &QCheckBox::toggled, this,
+                     &SimGroup::onDoubleBufferedToggled);
+}
+
+void SimGroup::setNumThreads(const std::size_t& numThreads) {
+    m_threadsSpinBox->setValue(numThreads);
+}
+
+void SimGroup::setUpdateMode(const boids::UpdateMode& mode) {
+    m_doubleBufferedCheckBox->setChecked(mode == boids::UpdateMode::DOUBLE_BUFFERED);
+    m_threadsSpinBox->setEnabled(mode == boids::UpdateMode::DOUBLE_BUFFERED);
+}
+
+void SimGroup::onThreadsValueChanged(int value) { emit numThreadsChanged(value); }
+
+void SimGroup::onDoubleBufferedToggled(bool checked) {
+    m_threadsSpinBox->setEnabled(checked);
+    emit updateModeChanged(checked ? boids::UpdateMode::DOUBLE_BUFFERED
+                                   : boids::UpdateMode::IN_PLACE);
+}
+
+} // namespace ui
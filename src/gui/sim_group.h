@@ -0,0 +1,71 @@
+#pragma once
+
+#include "flock.h"
+#include <QCheckBox>
+#include <QGroupBox>
+#include <QSpinBox>
+#include <QWidget>
+
+namespace ui {
+
+/**
+ * @brief The SimGroup class is a GUI widget containing the controls for how the simulation is
+ * run (rather than the behaviour of the boids themselves), such as the number of threads used to
+ * update the flock.
+ */
+class SimGroup : public QWidget {
+    Q_OBJECT
+
+  public:
+    /**
+     * @brief Construct a new SimGroup widget.
+     * @param parent The parent widget.
+     */
+    SimGroup(QWidget* parent = nullptr);
+
+    /**
+     * @brief Set the number of threads to display.
+     * @param numThreads Number of threads.
+     */
+    void setNumThreads(const std::size_t& numThreads);
+
+    /**
+     * @brief Set the update mode to display. The number of threads can only be changed in the
+     * double-buffered mode, as the in-place update always runs on a single thread.
+     * @param mode Update mode.
+     */
+    void setUpdateMode(const boids::UpdateMode& mode);
+
+  private:
+    QGroupBox* m_groupBox;
+    QSpinBox*  m_threadsSpinBox;
+    QCheckBox* m_doubleBufferedCheckBox;
+
+  signals:
+    /**
+     * @brief Signal emitted when the number of threads has been changed.
+     * @param numThreads New number of threads.
+     */
+    void numThreadsChanged(const std::size_t numThreads);
+
+    /**
+     * @brief Signal emitted when the update mode has been changed.
+     * @param mode New update mode.
+     */
+    void updateModeChanged(const boids::UpdateMode mode);
+
+  private slots:
+    /**
+     * @brief Slot triggered when the value of the threads spin box changes.
+     * @param value New spin box value.
+     */
+    void onThreadsValueChanged(int value);
+
+    /**
+     * @brief Slot triggered when the double buffered check box is toggled.
+     * @param checked Whether the check box is checked.
+     */
+    void onDoubleBufferedToggled(bool checked);
+};
+
+} // namespace ui
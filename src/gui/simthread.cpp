@@ -1,5 +1,6 @@
 #include "simthread.h"
 #include <QMutex>
+#include <trace.h>
 
 SimThread::SimThread(const std::shared_ptr<boids::Flock> flock, QObject* parent) : QThread(parent) {
     m_stop    = false;
@@ -19,17 +20,25 @@ void SimThread::stopSim() {
 }
 
 void SimThread::run() {
+    BOIDS_TRACE_THREAD_NAME("SimThread");
 
     while (!m_stop) {
         m_boidSim->update();
-
-        QList<boids::Boid> boids;
-        for (const auto& [key, value] : m_boidSim->getBoids()) {
-            for (const auto& v : value) {
-                boids.push_back(v);
-            }
+        {
+            // The flow arrow is picked up by the render of the same step, see renderSnapshot().
+            BOIDS_TRACE_ZONE("SimThread::publish");
+            boids::FlockSnapshot& snapshot = m_snapshots.getWriteBuffer();
+            m_boidSim->getSnapshot(snapshot);
+            BOIDS_TRACE_FLOW_START(snapshot.step);
+            m_snapshots.publish();
         }
-        emit update(boids);
+        emit frameReady();
         this->usleep(10000);
     }
 }
+
+const boids::FlockSnapshot* SimThread::takeSnapshot() {
+    if (!m_snapshots.fetch())
+        return nullptr;
+    return &m_snapshots.getReadBuffer();
+}
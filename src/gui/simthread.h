@@ -1,12 +1,12 @@
 #ifndef SIMTHREAD_H
 #define SIMTHREAD_H
 
-#include <QList>
 #include <QPointF>
 #include <QRectF>
 #include <QThread>
 #include <flock.h>
 #include <memory>
+#include <triple_buffer.h>
 
 /**
  * @brief The SimThread class is used to run the main logic of the Boids simulation.
@@ -17,7 +17,10 @@
  * The class provides an interface allowing you to add new boids (e.g., with a mouse
  * click), to change the size of the display area, or stop the simulaton all together.
  *
- * The thread emits an update() signal, which can be used to trigger a GUI update.
+ * After each step the thread publishes a snapshot of the flock into a lock-free triple buffer and
+ * emits a frameReady() signal, which can be used to trigger a GUI update. The signal carries no
+ * data: the receiver picks up the latest snapshot with takeSnapshot(), so frames that the GUI is
+ * too slow to draw are skipped rather than queued up.
  */
 class SimThread : public QThread {
     Q_OBJECT
@@ -33,8 +36,17 @@ class SimThread : public QThread {
      */
     void run() override;
 
+    /**
+     * @brief Pick up the latest snapshot published by the simulation thread. This must only be
+     * called from a single thread (normally the GUI thread).
+     * @return Pointer to the snapshot, which stays valid until the next call, or nullptr if no new
+     * snapshot has been published since the last call.
+     */
+    const boids::FlockSnapshot* takeSnapshot();
+
   private:
-    bool m_stop;
+    bool                                      m_stop;
+    boids::TripleBuffer<boids::FlockSnapshot> m_snapshots;
 
   public slots:
     /**
@@ -43,7 +55,7 @@ class SimThread : public QThread {
     void stopSim();
 
   signals:
-    void update(const QList<boids::Boid>& boids);
+    void frameReady();
 };
 
 #endif // SIMTHREAD_H
@@ -0,0 +1,340 @@
+#include <flock.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Pointer to one of the float fields of a boids::Config.
+using ConfigMember = float boids::Config::*;
+
+/**
+ * @brief A config value set on the command line, which overrides the flock's default.
+ */
+struct ConfigOverride {
+    boids::BoidType type;
+    ConfigMember    field;
+    float           value;
+};
+
+/**
+ * @brief A config field that can be set on the command line, as --boid-<name> or
+ * --predator-<name>.
+ */
+struct ConfigField {
+    const char*  name;
+    ConfigMember field;
+};
+
+const ConfigField CONFIG_FIELDS[] = {
+    {"radius", &boids::Config::neighbourhoodRadius},
+    {"max-vel", &boids::Config::maxVelocity},
+    {"align", &boids::Config::alignmentScale},
+    {"cohesion", &boids::Config::coheasionScale},
+    {"repel", &boids::Config::repelScale},
+    {"obs-repel", &boids::Config::obstacleRepelScale},
+    {"pred-repel", &boids::Config::predatorRepelScale},
+    {"repel-min-dist", &boids::Config::repelMinDist},
+};
+
+// Names of the boundary modes on the command line, indexed by boids::BoundaryMode.
+const char* const BOUNDARY_NAMES[] = {"periodic", "reflecting", "unbounded"};
+
+/**
+ * @brief Parse the name of a boundary mode.
+ * @param name Name of the mode.
+ * @return Boundary mode.
+ * @throws std::invalid_argument If the name isn't one of BOUNDARY_NAMES.
+ */
+boids::BoundaryMode parseBoundary(const std::string& name) {
+    for (std::size_t i = 0; i < std::size(BOUNDARY_NAMES); ++i) {
+        if (name == BOUNDARY_NAMES[i])
+            return boids::BoundaryMode(i);
+    }
+    throw std::invalid_argument("Unknown boundary " + name);
+}
+
+/**
+ * @brief The parameters of a headless run.
+ */
+struct HeadlessConfig {
+    std::size_t                 numBoids       = 1000;
+    std::size_t                 numPredators   = 0;
+    std::size_t                 numObstacles   = 0;
+    float                       width          = 1000.0f;
+    float                       height         = 1000.0f;
+    std::size_t                 numSteps       = 1000;
+    std::size_t                 numThreads     = 1;
+    uint64_t                    seed           = 1;
+    boids::UpdateMode           mode           = boids::UpdateMode::DOUBLE_BUFFERED;
+    boids::BoundaryMode         boundary       = boids::BoundaryMode::PERIODIC;
+    std::size_t                 snapshotEvery  = 0;    ///< Steps between snapshots, zero for none.
+    std::size_t                 clusterEvery   = 0;    ///< Steps between cluster searches.
+    float                       skin           = 0.0f; ///< Neighbour list skin, zero for none.
+    std::string                 snapshotPrefix = "snapshot";
+    std::string                 statsPath; ///< File to write the final stats to, empty for stdout.
+    std::vector<ConfigOverride> overrides;
+};
+
+/**
+ * @brief Print the usage of the runner.
+ */
+void printUsage() {
+    std::cerr << "Usage: boidsim-headless [options]\n"
+              << "  --boids N               Number of boids (default 1000)\n"
+              << "  --predators P           Number of predators (default 0)\n"
+              << "  --obstacles O           Number of obstacles (default 0)\n"
+              << "  --width W               Scene width (default 1000)\n"
+              << "  --height H              Scene height (default 1000)\n"
+              << "  --steps K               Number of steps to run (default 1000)\n"
+              << "  --threads T             Number of update threads (default 1)\n"
+              << "  --seed S                Random seed (default 1)\n"
+              << "  --in-place              Use the in-place update instead of double buffering\n"
+              << "  --boundary B            Scene edges: periodic, reflecting or unbounded\n"
+              << "                          (default periodic)\n"
+              << "  --snapshot-every K      Write a CSV snapshot of the flock every K steps\n"
+              << "  --snapshot-prefix PATH  Prefix of the snapshot files (default snapshot)\n"
+              << "  --stats PATH            Write the final stats to a file instead of stdout\n"
+              << "  --cluster-every K       Find the clusters of the flock every K steps\n"
+              << "  --skin S                Skin of the cached neighbour lists (default 0, off)\n"
+              << "  --boid-<field> V        Set a field of the boid config\n"
+              << "  --predator-<field> V    Set a field of the predator config\n"
+              << "  --help                  Print this message\n"
+              << "Config fields:";
+    for (const ConfigField& f : CONFIG_FIELDS) {
+        std::cerr << " " << f.name;
+    }
+    std::cerr << "\n";
+}
+
+/**
+ * @brief Parse a config override of the form --boid-<field> or --predator-<field>.
+ * @param arg Argument.
+ * @param value Value of the argument.
+ * @param parsed Set to the override, if the argument is one.
+ * @return True if the argument is a config override.
+ */
+bool parseOverride(const std::string& arg, const std::string& value, ConfigOverride& parsed) {
+    std::string field;
+    if (arg.rfind("--boid-", 0) == 0) {
+        parsed.type = boids::BOID;
+        field       = arg.substr(7);
+    } else if (arg.rfind("--predator-", 0) == 0) {
+        parsed.type = boids::PREDATOR;
+        field       = arg.substr(11);
+    } else {
+        return false;
+    }
+
+    for (const ConfigField& f : CONFIG_FIELDS) {
+        if (field == f.name) {
+            parsed.field = f.field;
+            parsed.value = std::stof(value);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Parse the command line arguments.
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ * @return Run config.
+ * @throws std::invalid_argument If an argument is unknown or is missing its value.
+ */
+HeadlessConfig parseArgs(int argc, char* argv[]) {
+    HeadlessConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help")
+            throw std::invalid_argument("");
+        if (arg == "--in-place") {
+            cfg.mode = boids::UpdateMode::IN_PLACE;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+            throw std::invalid_argument("Missing value for " + arg);
+        const std::string value = argv[++i];
+
+        ConfigOverride parsed;
+        if (arg == "--boids")
+            cfg.numBoids = std::stoul(value);
+        else if (arg == "--predators")
+            cfg.numPredators = std::stoul(value);
+        else if (arg == "--obstacles")
+            cfg.numObstacles = std::stoul(value);
+        else if (arg == "--width")
+            cfg.width = std::stof(value);
+        else if (arg == "--height")
+            cfg.height = std::stof(value);
+        else if (arg == "--steps")
+            cfg.numSteps = std::stoul(value);
+        else if (arg == "--threads")
+            cfg.numThreads = std::stoul(value);
+        else if (arg == "--seed")
+            cfg.seed = std::stoull(value);
+        else if (arg == "--snapshot-every")
+            cfg.snapshotEvery = std::stoul(value);
+        else if (arg == "--snapshot-prefix")
+            cfg.snapshotPrefix = value;
+        else if (arg == "--stats")
+            cfg.statsPath = value;
+        else if (arg == "--cluster-every")
+            cfg.clusterEvery = std::stoul(value);
+        else if (arg == "--boundary")
+            cfg.boundary = parseBoundary(value);
+        else if (arg == "--skin")
+            cfg.skin = std::stof(value);
+        else if (parseOverride(arg, value, parsed))
+            cfg.overrides.push_back(parsed);
+        else
+            throw std::invalid_argument("Unknown argument " + arg);
+    }
+
+    if (cfg.width <= 0.0f || cfg.height <= 0.0f)
+        throw std::invalid_argument("The scene size must be positive");
+    return cfg;
+}
+
+/**
+ * @brief Write the state of the flock as CSV, one boid per row.
+ * @param path Path of the file to write.
+ * @param state Flock state.
+ * @throws std::runtime_error If the file can't be written.
+ */
+void writeSnapshot(const std::string& path, const boids::FlockState& state) {
+    std::ofstream file(path);
+    if (!file)
+        throw std::runtime_error("Could not write " + path);
+
+    file << "id,type,x,y,vx,vy\n";
+    for (std::size_t i = 0; i < state.size(); ++i) {
+        file << state.id[i] << "," << int(state.type[i]) << "," << state.x[i] << "," << state.y[i]
+             << "," << state.vx[i] << "," << state.vy[i] << "\n";
+    }
+}
+
+/**
+ * @brief Write the run config and the final stats as JSON.
+ * @param os Stream to write to.
+ * @param cfg Run config.
+ * @param flock Flock at the end of the run.
+ * @param seconds Wall time of the run.
+ */
+void writeStats(std::ostream& os, const HeadlessConfig& cfg, const boids::Flock& flock,
+                const double seconds) {
+    // Means over the most recent steps. These are all zero if libboids was built without
+    // BOIDS_STEP_STATS.
+    const boids::StepStats mean = flock.getStepStatsWindow().getMean();
+
+    // Collective behaviour of the BOIDs, reduced during the final step, and the clusters of the
+    // most recent search (if any).
+    const boids::FlockMetrics&  m        = flock.getMetrics();
+    const boids::FlockClusters& clusters = flock.getClusters();
+
+    os << "{\n"
+       << "  \"boids\": " << cfg.numBoids << ",\n"
+       << "  \"predators\": " << cfg.numPredators << ",\n"
+       << "  \"obstacles\": " << cfg.numObstacles << ",\n"
+       << "  \"width\": " << cfg.width << ",\n"
+       << "  \"height\": " << cfg.height << ",\n"
+       << "  \"steps\": " << cfg.numSteps << ",\n"
+       << "  \"threads\": " << cfg.numThreads << ",\n"
+       << "  \"seed\": " << cfg.seed << ",\n"
+       << "  \"mode\": \""
+       << (cfg.mode == boids::UpdateMode::IN_PLACE ? "in_place" : "double_buffered") << "\",\n"
+       << "  \"boundary\": \"" << BOUNDARY_NAMES[cfg.boundary] << "\",\n"
+       << "  \"skin\": " << cfg.skin << ",\n"
+       << "  \"seconds\": " << seconds << ",\n"
+       << "  \"steps_per_sec\": " << (seconds > 0.0 ? double(cfg.numSteps) / seconds : 0.0)
+       << ",\n"
+       << "  \"final_boids\": " << flock.getNumBoids() << ",\n"
+       << "  \"window_steps\": " << flock.getStepStatsWindow().size() << ",\n"
+       << "  \"mean_step_ns\": " << mean.totalNs << ",\n"
+       << "  \"mean_commands_ns\": " << mean.commandsNs << ",\n"
+       << "  \"mean_grid_ns\": " << mean.gridNs << ",\n"
+       << "  \"mean_neighbours_ns\": " << mean.neighboursNs << ",\n"
+       << "  \"mean_integrate_ns\": " << mean.integrateNs << ",\n"
+       << "  \"mean_distance_tests\": " << mean.distanceTests << ",\n"
+       << "  \"mean_neighbours_per_boid\": " << mean.getMeanNeighbours() << ",\n"
+       << "  \"max_neighbours\": " << mean.maxNeighbours << ",\n"
+       << "  \"list_builds\": " << mean.listBuilds << ",\n"
+       << "  \"polarisation\": " << m.polarisation << ",\n"
+       << "  \"nearest_distance\": " << m.meanNearestDistance << ",\n"
+       << "  \"angular_momentum\": " << m.angularMomentum << ",\n"
+       << "  \"density\": " << m.density << ",\n"
+       << "  \"local_density\": " << m.localDensity << ",\n"
+       << "  \"clusters\": " << clusters.clusters.size() << ",\n"
+       << "  \"largest_cluster\": "
+       << (clusters.clusters.empty() ? 0 : clusters.clusters.front().size) << "\n"
+       << "}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    HeadlessConfig cfg;
+    try {
+        cfg = parseArgs(argc, argv);
+    } catch (const std::exception& e) {
+        if (*e.what())
+            std::cerr << e.what() << "\n";
+        printUsage();
+        return 1;
+    }
+
+    const boids::Rect scene(0.0f, 0.0f, cfg.width, cfg.height);
+    boids::Flock      flock(cfg.numThreads, cfg.seed);
+    flock.setSceneBounds(scene);
+    flock.setUpdateMode(cfg.mode);
+    flock.setBoundaryMode(cfg.boundary);
+    flock.setClusterInterval(cfg.clusterEvery);
+    flock.setNeighbourSkin(cfg.skin);
+    for (const ConfigOverride& o : cfg.overrides) {
+        boids::Config c = flock.getConfig(o.type);
+        c.*o.field      = o.value;
+        flock.setConfig(c, o.type);
+    }
+
+    flock.spawnUniform(cfg.numBoids, scene, boids::BOID);
+    flock.spawnUniform(cfg.numPredators, scene, boids::PREDATOR);
+    flock.spawnUniform(cfg.numObstacles, scene, boids::OBSTACLE);
+
+    // The steps run back to back, with only the snapshot writes (if any) in between.
+    double seconds = 0.0;
+    try {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t step = 1; step <= cfg.numSteps; ++step) {
+            flock.update();
+            if (cfg.snapshotEvery > 0 && step % cfg.snapshotEvery == 0) {
+                char suffix[32];
+                std::snprintf(suffix, sizeof(suffix), "_%06zu.csv", step);
+                writeSnapshot(cfg.snapshotPrefix + suffix, flock.getState());
+            }
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    if (cfg.statsPath.empty()) {
+        writeStats(std::cout, cfg, flock, seconds);
+    } else {
+        std::ofstream file(cfg.statsPath);
+        if (!file) {
+            std::cerr << "Could not write " << cfg.statsPath << "\n";
+            return 1;
+        }
+        writeStats(file, cfg, flock, seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include "aligned_allocator.h"
+
+#if defined(BOIDS_HUGE_PAGES) && defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace boids {
+
+#ifdef BOIDS_HUGE_PAGES
+// Size of a transparent huge page on x86-64 and most AArch64 kernels.
+constexpr std::size_t HUGE_PAGE_SIZE = std::size_t(2) << 20;
+#endif
+
+/**
+ * @brief Get the alignment of a block. This depends only on the size of the block, so that it can
+ * be worked out again when the block is freed.
+ * @param bytes Size of the block.
+ * @return Alignment in bytes.
+ */
+inline std::size_t getAlignment([[maybe_unused]] const std::size_t& bytes) {
+#ifdef BOIDS_HUGE_PAGES
+    if (bytes >= HUGE_PAGE_SIZE)
+        return HUGE_PAGE_SIZE;
+#endif
+    return CACHE_LINE_SIZE;
+}
+
+void* allocateAligned(const std::size_t& bytes) {
+    const std::size_t alignment = getAlignment(bytes);
+    void*             ptr       = ::operator new(bytes, std::align_val_t(alignment));
+#if defined(BOIDS_HUGE_PAGES) && defined(__linux__)
+    // Only whole huge pages can be backed by one, so the tail of the block is left out. The advice
+    // is only a hint, so a kernel without transparent huge pages just ignores it.
+    if (alignment == HUGE_PAGE_SIZE)
+        madvise(ptr, bytes / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE, MADV_HUGEPAGE);
+#endif
+    return ptr;
+}
+
+void deallocateAligned(void* ptr, const std::size_t& bytes) noexcept {
+    ::operator delete(ptr, std::align_val_t(getAlignment(bytes)));
+}
+
+}; // namespace boids
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace boids {
+
+// Alignment of the long-lived flock arrays and of every arena allocation. This is the size of a
+// cache line, and of an AVX-512 register.
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief Allocate a block of memory aligned to a cache line.
+ *
+ * When libboids is built with BOIDS_HUGE_PAGES, blocks of at least HUGE_PAGE_SIZE are aligned to a
+ * huge page instead, and on Linux the kernel is advised to back them with transparent huge pages.
+ * This cuts the TLB misses of streaming through the arrays of a large flock.
+ *
+ * @param bytes Size of the block.
+ * @return Pointer to the block.
+ * @throws std::bad_alloc If the block can't be allocated.
+ */
+void* allocateAligned(const std::size_t& bytes);
+
+/**
+ * @brief Free a block allocated with allocateAligned().
+ * @param ptr Pointer to the block.
+ * @param bytes Size that the block was allocated with.
+ */
+void deallocateAligned(void* ptr, const std::size_t& bytes) noexcept;
+
+/**
+ * @brief The AlignedAllocator class is a standard allocator that gets its memory from
+ * allocateAligned(), so that each array starts on a cache line (or a huge page).
+ */
+template <typename T> class AlignedAllocator {
+  public:
+    using value_type = T;
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U> AlignedAllocator(const AlignedAllocator<U>&) noexcept {}
+
+    /**
+     * @brief Allocate an array.
+     * @param n Number of elements.
+     * @return Pointer to the array.
+     * @throws std::bad_array_new_length If the size of the array overflows.
+     */
+    T* allocate(const std::size_t n) {
+        if (n > std::size_t(-1) / sizeof(T))
+            throw std::bad_array_new_length();
+        return static_cast<T*>(allocateAligned(n * sizeof(T)));
+    }
+
+    /**
+     * @brief Free an array.
+     * @param ptr Pointer to the array.
+     * @param n Number of elements it was allocated with.
+     */
+    void deallocate(T* ptr, const std::size_t n) noexcept { deallocateAligned(ptr, n * sizeof(T)); }
+
+    template <typename U> bool operator==(const AlignedAllocator<U>&) const noexcept {
+        return true;
+    }
+};
+
+/**
+ * @brief A std::vector whose storage is aligned to a cache line. See AlignedAllocator.
+ */
+template <typename T> using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+}; // namespace boids
@@ -0,0 +1,64 @@
+#include "arena.h"
+
+namespace boids {
+
+/**
+ * @brief Round a number of bytes up to a whole number of cache lines.
+ * @param bytes Number of bytes.
+ * @return Rounded number of bytes.
+ */
+inline std::size_t roundToCacheLine(const std::size_t& bytes) {
+    return (bytes + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+}
+
+Arena::Arena(const std::size_t& capacity) : block_{nullptr, 0}, used_(0), total_(0) {
+    if (capacity > 0) {
+        block_.size = roundToCacheLine(capacity);
+        block_.data = static_cast<std::byte*>(allocateAligned(block_.size));
+    }
+}
+
+Arena::~Arena() {
+    for (const Block& b : overflow_) {
+        deallocateAligned(b.data, b.size);
+    }
+    if (block_.data)
+        deallocateAligned(block_.data, block_.size);
+}
+
+void Arena::reset() {
+    if (!overflow_.empty()) {
+        for (const Block& b : overflow_) {
+            deallocateAligned(b.data, b.size);
+        }
+        overflow_.clear();
+
+        if (block_.data)
+            deallocateAligned(block_.data, block_.size);
+        block_.size = total_;
+        block_.data = static_cast<std::byte*>(allocateAligned(block_.size));
+    }
+    used_  = 0;
+    total_ = 0;
+}
+
+std::size_t Arena::getCapacity() const { return block_.size; }
+
+std::size_t Arena::getUsed() const { return total_; }
+
+void* Arena::allocateBytes(const std::size_t& bytes) {
+    const std::size_t size = roundToCacheLine(bytes);
+    total_ += size;
+    if (used_ + size <= block_.size) {
+        void* ptr = block_.data + used_;
+        used_ += size;
+        return ptr;
+    }
+
+    // The block is full for this step. The overflow only lasts until the next reset(), which grows
+    // the block to fit.
+    overflow_.push_back(Block{static_cast<std::byte*>(allocateAligned(size)), size});
+    return overflow_.back().data;
+}
+
+}; // namespace boids
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "aligned_allocator.h"
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace boids {
+
+/**
+ * @brief The Arena class is a bump allocator for the temporaries of a single step, which are all
+ * freed at once by reset() at the start of the next step.
+ *
+ * Allocations are carved out of one cache line aligned block, and each is rounded up to a whole
+ * number of cache lines. If a step needs more than the block holds, the rest is allocated in
+ * overflow blocks, and the next reset() replaces all of them with a single block large enough for
+ * that step. So once the arena has seen its largest step, it no longer touches the heap.
+ *
+ * An arena is not thread-safe, so each thread needs its own.
+ */
+class Arena {
+  public:
+    /**
+     * @brief Construct a new Arena object.
+     * @param capacity Initial size of the block, in bytes.
+     */
+    explicit Arena(const std::size_t& capacity = 0);
+
+    ~Arena();
+
+    Arena(const Arena&)            = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Allocate an uninitialised array, which stays valid until the next reset().
+     * @param n Number of elements.
+     * @return Array of n elements, aligned to a cache line.
+     */
+    template <typename T> std::span<T> allocate(const std::size_t& n) {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                      "Arena arrays are never constructed or destroyed");
+        static_assert(alignof(T) <= CACHE_LINE_SIZE, "Arena arrays are aligned to a cache line");
+        return std::span<T>(static_cast<T*>(allocateBytes(n * sizeof(T))), n);
+    }
+
+    /**
+     * @brief Free everything allocated since the last reset, and grow the block to fit all of it
+     * if it overflowed.
+     */
+    void reset();
+
+    /**
+     * @brief Get the size of the block.
+     * @return Capacity in bytes.
+     */
+    std::size_t getCapacity() const;
+
+    /**
+     * @brief Get the number of bytes allocated since the last reset, including any overflow.
+     * @return Bytes allocated, rounded up to whole cache lines.
+     */
+    std::size_t getUsed() const;
+
+  private:
+    /**
+     * @brief Allocate a number of bytes.
+     * @param bytes Number of bytes.
+     * @return Pointer to the allocation.
+     */
+    void* allocateBytes(const std::size_t& bytes);
+
+    /**
+     * @brief The Block struct is a block of memory from allocateAligned().
+     */
+    struct Block {
+        std::byte*  data;
+        std::size_t size;
+    };
+
+    Block              block_;
+    std::size_t        used_;  ///< Bytes allocated from block_.
+    std::size_t        total_; ///< Bytes allocated since the last reset, including overflow.
+    std::vector<Block> overflow_;
+};
+
+}; // namespace boids
@@ -1,8 +1,8 @@
 #pragma once
 
-#include <QColor>
-#include <QPoint>
-#include <QVector2D>
+#include "random.h"
+#include "types.h"
+#include <cstdint>
 
 namespace boids {
 
@@ -14,6 +14,13 @@ namespace boids {
  */
 enum BoidType { BOID, PREDATOR, OBSTACLE };
 
+/**
+ * @brief ID of a boid. Within a Flock this is a generational handle: it stays valid for as long as
+ * the boid exists, is never given to a live boid twice, and can be checked for staleness once the
+ * boid has been removed. See SlotMap.
+ */
+using BoidId = uint32_t;
+
 /**
  * @brief The Boid class contains the data pertaining to a single Boid.
  * That is, the ID, the colour, the current position and heading and the current velocity.
@@ -24,7 +31,7 @@ class Boid {
      * @brief Construct a new Boid object at location 0.0, 0.0, with not velocity.
      * @param id ID to assign to the Boid.
      */
-    Boid(const uint16_t& id, const BoidType type = BoidType::BOID);
+    Boid(const BoidId& id, const BoidType type = BoidType::BOID);
 
     /**
      * @brief Construct a new Boid object at a given location with a given ID.
@@ -32,7 +39,18 @@ class Boid {
      * @param x X screen coordinate.
      * @param y Y screen coordinate.
      */
-    Boid(const uint16_t& id, const float x, const float y, const BoidType type = BoidType::BOID);
+    Boid(const BoidId& id, const float x, const float y, const BoidType type = BoidType::BOID);
+
+    /**
+     * @brief Construct a new Boid object at a given location with a given ID, drawing the random
+     * velocity and colour from a given generator.
+     * @param id ID to assign to the Boid.
+     * @param x X screen coordinate.
+     * @param y Y screen coordinate.
+     * @param rng Random number generator.
+     */
+    Boid(const BoidId& id, const float x, const float y, Random& rng,
+         const BoidType type = BoidType::BOID);
 
     /**
      * @brief Construct a new Boid object at a given location, with a given velocity and ID.
@@ -43,7 +61,7 @@ class Boid {
      * @param dx X velocity.
      * @param dy Y velocity.
      */
-    Boid(const uint16_t& id, const float x, const float y, const float dx, const float dy,
+    Boid(const BoidId& id, const float x, const float y, const float dx, const float dy,
          const BoidType type = BoidType::BOID);
 
     /**
@@ -57,19 +75,19 @@ class Boid {
      * @brief Get the RGB colour of the Boid
      * @return Colour
      */
-    QColor getColor() const;
+    Color getColor() const;
 
     /**
      * @brief Get the Boid ID.
      * @return Boid ID.
      */
-    uint16_t getId() const;
+    BoidId getId() const;
 
     /**
      * @brief Get the current position of the Boid.
      * @return Position in the scene.
      */
-    QPointF getPosition() const;
+    Vec2 getPosition() const;
 
     /**
      * @brief Get the type of Boid.
@@ -81,37 +99,32 @@ class Boid {
      * @brief Get the current velocity of the Boid.
      * @return Velocity in the scene.
      */
-    QVector2D getVelocity() const;
+    Vec2 getVelocity() const;
 
     /**
      * @brief Set the Color of the Boid.
      * @param color New colour to set.
      */
-    void setColor(const QColor& color);
+    void setColor(const Color& color);
 
     /**
      * @brief Set the Position of the Boid.
      * @param pos Position in the format (x, y).
      */
-    void setPosition(const QPointF& pos);
+    void setPosition(const Vec2& pos);
 
     /**
      * @brief Set the Velocity of the Boid.
      * @param pos Velocity in the format (vx, vy).
      */
-    void setVelocity(const QVector2D& vel);
+    void setVelocity(const Vec2& vel);
 
   private:
-    uint16_t  id_;
-    QColor    color_;
-    QPointF   position_;
-    QVector2D velocity_;
-    BoidType  type_;
+    BoidId   id_;
+    Color    color_;
+    Vec2     position_;
+    Vec2     velocity_;
+    BoidType type_;
 };
 
 }; // namespace boids
-
-// Declare Qt meta types
-Q_DECLARE_METATYPE(boids::BoidType);
-Q_DECLARE_METATYPE(std::vector<boids::Boid>);
-Q_DECLARE_METATYPE(std::vector<boids::BoidType>);
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace boids {
+
+/**
+ * @brief The ways in which the edges of the scene can behave:
+ * - PERIODIC wraps the scene around into a torus, so a boid leaving one edge comes back in at the
+ *   opposite edge, and sees neighbours across it. This is the legacy behaviour.
+ * - REFLECTING makes the edges walls, which boids bounce off.
+ * - UNBOUNDED lets boids fly out of the scene, which then only sets the size of the grid.
+ */
+enum BoundaryMode { PERIODIC, REFLECTING, UNBOUNDED };
+
+namespace boundary {
+
+/**
+ * @brief Apply the minimum image convention to a displacement along a wrapped axis, so that it
+ * is the shortest displacement across the scene. This matches
+ * utils::shortestDistanceInWrapedSpace() for points within the scene.
+ * @param d Displacement.
+ * @param size Size of the wrapped axis.
+ * @return Wrapped displacement.
+ */
+inline float wrapDisplacement(const float d, const float size) {
+    return std::abs(d) > 0.5f * size ? d - std::copysign(size, d) : d;
+}
+
+// Each boundary policy below has the same static interface, which the kernels and the update are
+// templated on, so that each policy gets its own code with no per-pair test of the boundary:
+// - MODE is the boundary mode of the policy.
+// - WRAPS is true if displacements have to be wrapped across the scene.
+// - displacement() gets the displacement between two points along an axis of the scene.
+// - integrate() moves a new position along an axis back into the scene, adjusting the velocity.
+
+/**
+ * @brief The Periodic struct is the policy for BoundaryMode::PERIODIC.
+ */
+struct Periodic {
+    static constexpr BoundaryMode MODE  = PERIODIC;
+    static constexpr bool         WRAPS = true;
+
+    static float displacement(const float d, const float size) { return wrapDisplacement(d, size); }
+
+    static void integrate(float& pos, float&, const float min, const float max) {
+        pos = utils::wrapValue(pos, min, max);
+    }
+};
+
+/**
+ * @brief The Reflecting struct is the policy for BoundaryMode::REFLECTING. A boid that crosses an
+ * edge is mirrored back into the scene, and its velocity along that axis is reversed.
+ */
+struct Reflecting {
+    static constexpr BoundaryMode MODE  = REFLECTING;
+    static constexpr bool         WRAPS = false;
+
+    static float displacement(const float d, const float) { return d; }
+
+    static void integrate(float& pos, float& vel, const float min, const float max) {
+        const bool below = pos < min;
+        const bool above = pos > max;
+        pos              = below ? 2.0f * min - pos : (above ? 2.0f * max - pos : pos);
+        vel              = below || above ? -vel : vel;
+
+        // A boid can only overshoot by its velocity, but a scene smaller than that would still
+        // leave it outside.
+        pos = std::clamp(pos, min, max);
+    }
+};
+
+/**
+ * @brief The Unbounded struct is the policy for BoundaryMode::UNBOUNDED.
+ */
+struct Unbounded {
+    static constexpr BoundaryMode MODE  = UNBOUNDED;
+    static constexpr bool         WRAPS = false;
+
+    static float displacement(const float d, const float) { return d; }
+
+    static void integrate(float&, float&, const float, const float) {}
+};
+
+/**
+ * @brief Call a function with the policy of a boundary mode, so that the code behind a runtime
+ * choice of mode is specialised for each policy.
+ * @param mode Boundary mode.
+ * @param fn Function called with a Periodic, Reflecting or Unbounded object.
+ * @return Return value of the function.
+ */
+template <typename Fn> decltype(auto) visit(const BoundaryMode& mode, Fn&& fn) {
+    switch (mode) {
+        case REFLECTING:
+            return fn(Reflecting());
+        case UNBOUNDED:
+            return fn(Unbounded());
+        default:
+            return fn(Periodic());
+    }
+}
+
+} // namespace boundary
+}; // namespace boids
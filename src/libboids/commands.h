@@ -0,0 +1,76 @@
+#pragma once
+
+#include "boids.h"
+#include "config.h"
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+
+namespace boids {
+namespace command {
+
+/**
+ * @brief Add a boid of a given type at a given coordinate. See Flock::addBoid().
+ */
+struct AddBoid {
+    float    x    = 0.0f;
+    float    y    = 0.0f;
+    BoidType type = BoidType::BOID;
+};
+
+/**
+ * @brief Add a batch of boids of a given type, scattered uniformly over a rectangle. See
+ * Flock::spawnUniform().
+ */
+struct SpawnUniform {
+    std::size_t n;
+    Rect        rect;
+    BoidType    type = BoidType::BOID;
+};
+
+/**
+ * @brief Remove the boid with a given ID. See Flock::removeBoid().
+ */
+struct RemoveBoid {
+    BoidId id;
+};
+
+/**
+ * @brief Clear all the boids, of every type. See Flock::clearBoids().
+ */
+struct ClearBoids {};
+
+/**
+ * @brief Clear all the boids of a given type. See Flock::clearBoids().
+ */
+struct ClearBoidsOfType {
+    BoidType type;
+};
+
+/**
+ * @brief Set the configuration for a given boid type. See Flock::setConfig().
+ */
+struct SetConfig {
+    Config   cfg;
+    BoidType type = BoidType::BOID;
+};
+
+/**
+ * @brief Set the scene bounds. See Flock::setSceneBounds().
+ */
+struct SetSceneBounds {
+    Rect bounds;
+};
+
+}; // namespace command
+
+/**
+ * @brief A change to a Flock that can be posted from any thread, and is applied by the thread
+ * that updates the flock at the start of its next update. See Flock::post().
+ */
+using Command = std::variant<command::AddBoid, command::SpawnUniform, command::RemoveBoid,
+                             command::ClearBoids, command::ClearBoidsOfType, command::SetConfig,
+                             command::SetSceneBounds>;
+
+}; // namespace boids
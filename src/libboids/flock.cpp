@@ -1,73 +1,234 @@
 #include "flock.h"
+#include "kernel.h"
+#include "trace.h"
 #include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <stdexcept>
 
 namespace boids {
 
 /**
- * @brief Update a vector of Boid instances, taking into account the flock of boids,
- * obstacles and the predators.
- * @param boids Vector of Boid instances to update.
- * @param flock Vector of standard Boids.
- * @param predators Vector of Predator Boids.
- * @param obstacles Vector of Obstacle Boids.
- * @param cfg Configuration parameters to use for the update.
- * @param sceneBounds Bounds of the Scene.
+ * @brief Normalise a vector in place, or set it to zero if the length is zero.
+ * @param x X component, normalised in place.
+ * @param y Y component, normalised in place.
  */
-void updateBoids(std::vector<Boid>& boids, const std::vector<Boid>& flock,
-                 const std::vector<Boid>& predators, const std::vector<Boid>& obstacles,
-                 const Config& cfg, const QRectF& sceneBounds) {
-    for (Boid& b : boids) {
-        const std::vector<boids::Boid> neighbours =
-            boids::utils::getBoidNeighbourhood(b, flock, cfg.neighbourhoodRadius, sceneBounds);
-
-        const std::vector<boids::Boid> obstacleNeighbours =
-            boids::utils::getBoidNeighbourhood(b, obstacles, cfg.neighbourhoodRadius, sceneBounds);
-
-        const std::vector<boids::Boid> predatorNeighbours =
-            boids::utils::getBoidNeighbourhood(b, predators, cfg.neighbourhoodRadius, sceneBounds);
-
-        const QVector2D alignVector = boids::utils::calculateAlignmentVector(b, neighbours);
-
-        const QVector2D cohesionVector =
-            boids::utils::calculateCohesionVector(b, neighbours, sceneBounds);
+inline void normalise(float& x, float& y) {
+    const float len = std::sqrt(x * x + y * y);
+    if (len > 0.0f) {
+        x /= len;
+        y /= len;
+    } else {
+        x = 0.0f;
+        y = 0.0f;
+    }
+}
 
-        const QVector2D repelVec =
-            boids::utils::calculateSeparationVector(b, neighbours, cfg.repelMinDist, sceneBounds);
+#ifdef BOIDS_STEP_STATS
+using StepClock = std::chrono::steady_clock;
 
-        const QVector2D obstacleVec = boids::utils::calculateSeparationVector(
-            b, obstacleNeighbours, cfg.repelMinDist * 1.0f, sceneBounds);
+/**
+ * @brief Get the time between two points, in nanoseconds.
+ * @param start Start time.
+ * @param end End time.
+ * @return Elapsed time in nanoseconds.
+ */
+inline uint64_t elapsedNs(const StepClock::time_point& start, const StepClock::time_point& end) {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
 
-        const QVector2D predatorVec = boids::utils::calculateSeparationVector(
-            b, predatorNeighbours, cfg.repelMinDist * 5.0f, sceneBounds);
+/**
+ * @brief Every how many updated boids the split between the neighbourhood and the integration is
+ * timed. Reading the clock costs about as much as integrating a boid, so only a sample is timed.
+ */
+constexpr std::size_t STATS_SAMPLE_INTERVAL = 64;
+#endif
 
-        const QVector2D noiseVec = boids::utils::generateRandomVelocityVector(0.05f);
+/**
+ * @brief Update the boids of a given type in the flock state, taking into account the flock of
+ * boids, obstacles and the predators.
+ *
+ * The neighbourhood is read from the input state and the updated boids are written to the output
+ * state. Passing the same state for both updates the boids in place, so later boids see the
+ * already updated positions of earlier ones.
+ *
+ * @param in Flock state containing all the boids at the current step.
+ * @param out Flock state to write the updated boids to.
+ * @param type Type of boid to update.
+ * @param grid Spatial grid built from the flock state.
+ * @param packed Flock state packed in the slot order of the grid, or nullptr to read the
+ * neighbourhood from the input state directly (needed when updating in place).
+ * @param lists Neighbour lists built for the grid, or nullptr to search the grid. The lists are
+ * read through the packed state, so this needs packed to be set, and the boids are then visited
+ * in slot order, which reads the lists in the order they are stored in.
+ * @param cfg Configuration parameters to use for the update.
+ * @param sceneBounds Bounds of the Scene, which the boids are kept to according to the boundary
+ * policy (see boundary.h) that this is instantiated for.
+ * @param seed Seed of the flock.
+ * @param step Index of the step, which together with the boid ID selects its random stream.
+ * @param begin Index of the first boid to update, or its slot with lists.
+ * @param end Index (or slot) one past the last boid to update.
+ * @param metrics Metric sums of the thread running the update, which the BOIDs are added to.
+ * @param counters Step counters of the thread running the update. These are only updated when
+ * built with BOIDS_STEP_STATS. The whole range is timed at once, and the time is split between
+ * the neighbourhoods and the integration in the proportion measured on every
+ * STATS_SAMPLE_INTERVAL-th updated boid.
+ */
+template <typename Policy>
+void updateBoids(const FlockState& in, FlockState& out, const BoidType& type,
+                 const SpatialGrid& grid, const kernel::PackedNeighbours* packed,
+                 const NeighbourLists* lists, const Config& cfg, const Rect& sceneBounds,
+                 const uint64_t& seed, const uint64_t& step, const std::size_t& begin,
+                 const std::size_t& end, MetricSums& metrics,
+                 [[maybe_unused]] ThreadStepCounters& counters) {
+#ifdef BOIDS_STEP_STATS
+    // The counters are kept locally and added to the thread's once the range is done.
+    const auto         start               = StepClock::now();
+    ThreadStepCounters local;
+    uint64_t           sampledNeighboursNs = 0;
+    uint64_t           sampledIntegrateNs  = 0;
+#endif
+    for (std::size_t n = begin; n < end; ++n) {
+        const std::size_t i = lists ? std::size_t(packed->index[n]) : n;
+        if (in.type[i] != type)
+            continue;
+
+        Random rng(seed, (step << 32) | in.id[i]);
+
+#ifdef BOIDS_STEP_STATS
+        const bool            sample = local.numBoids % STATS_SAMPLE_INTERVAL == 0;
+        StepClock::time_point neighboursStart;
+        if (sample)
+            neighboursStart = StepClock::now();
+#endif
+        kernel::NeighbourhoodSums sums;
+        if (lists)
+            sums = kernel::accumulateNeighbourhood<Policy>(in, i, *packed, lists->getCandidates(n),
+                                                           cfg, sceneBounds);
+        else if (packed)
+            sums = kernel::accumulateNeighbourhood<Policy>(in, i, grid, *packed, cfg, sceneBounds);
+        else
+            sums = kernel::accumulateNeighbourhood<Policy>(in, i, grid, cfg, sceneBounds);
+#ifdef BOIDS_STEP_STATS
+        StepClock::time_point integrateStart;
+        if (sample) {
+            integrateStart = StepClock::now();
+            sampledNeighboursNs += elapsedNs(neighboursStart, integrateStart);
+        }
+        local.numBoids++;
+        local.distanceTests += sums.tested;
+        local.neighbours += sums.count;
+        local.maxNeighbours = std::max<uint64_t>(local.maxNeighbours, sums.count);
+#endif
+        if (type == BoidType::BOID)
+            metrics.add(in.x[i], in.y[i], in.vx[i], in.vy[i], sums.count, sums.nearestSq);
+
+        // The cohesion vector points towards the center of the neighbourhood, with a small fixed
+        // magnitude.
+        float cohesionX = sums.cohesionX;
+        float cohesionY = sums.cohesionY;
+        normalise(cohesionX, cohesionY);
+
+        Vec2 v(in.vx[i], in.vy[i]);
+        v += (Vec2(sums.alignX, sums.alignY) * cfg.alignmentScale);
+        v += (Vec2(cohesionX, cohesionY) * 0.25f * cfg.coheasionScale);
+        v += (Vec2(sums.repelX, sums.repelY) * cfg.repelScale);
+        v += (Vec2(sums.obstacleX, sums.obstacleY) * cfg.obstacleRepelScale);
+        v += (Vec2(sums.predatorX, sums.predatorY) * cfg.predatorRepelScale);
+        v += boids::utils::generateRandomVelocityVector(0.05f, rng);
 
-        const QPointF& p = b.getPosition();
+        boids::utils::clipVectorMangitude(v, 0.1f, cfg.maxVelocity);
 
-        QVector2D v = b.getVelocity();
-        v += (alignVector * cfg.alignmentScale);
-        v += (cohesionVector * cfg.coheasionScale);
-        v += (repelVec * cfg.repelScale);
-        v += (obstacleVec * cfg.obstacleRepelScale);
-        v += (predatorVec * cfg.predatorRepelScale);
-        v += (noiseVec * 1.0f);
+        float x  = in.x[i] + v.x();
+        float y  = in.y[i] + v.y();
+        float vx = v.x();
+        float vy = v.y();
+        Policy::integrate(x, vx, sceneBounds.left(), sceneBounds.right());
+        Policy::integrate(y, vy, sceneBounds.top(), sceneBounds.bottom());
+        out.x[i]  = x;
+        out.y[i]  = y;
+        out.vx[i] = vx;
+        out.vy[i] = vy;
+
+        // Move the hue towards the average of the neighbourhood, weighted by distance.
+        if (sums.count > 0) {
+            const float h     = sums.hue / float(sums.count);
+            const float noise = rng.uniform(-3.0f, 3.0f) * 0.0001f;
+            out.hue[i]        = utils::wrapValue(in.hue[i] - (h * 0.005f) + noise, 0.0f, 359.0f);
+        }
+#ifdef BOIDS_STEP_STATS
+        if (sample)
+            sampledIntegrateNs += elapsedNs(integrateStart, StepClock::now());
+#endif
+    }
+#ifdef BOIDS_STEP_STATS
+    const uint64_t sampledNs = sampledNeighboursNs + sampledIntegrateNs;
+    if (sampledNs > 0) {
+        const uint64_t totalNs = elapsedNs(start, StepClock::now());
+        const uint64_t neighboursNs =
+            uint64_t(double(totalNs) * double(sampledNeighboursNs) / double(sampledNs));
+        counters.neighboursNs += neighboursNs;
+        counters.integrateNs += totalNs - neighboursNs;
+    }
+    counters.numBoids += local.numBoids;
+    counters.distanceTests += local.distanceTests;
+    counters.neighbours += local.neighbours;
+    counters.maxNeighbours = std::max(counters.maxNeighbours, local.maxNeighbours);
+#endif
+};
 
-        boids::utils::clipVectorMangitude(v, 0.1f, cfg.maxVelocity);
+/**
+ * @brief Carry the part of a range of the flock state that updateBoids() doesn't write over to the
+ * back buffer: the hue, ID, type, saturation and value of every boid, and the position and
+ * velocity of the obstacles, which aren't updated. The hue is only written by updateBoids() for
+ * boids with neighbours, so this must have finished for the whole flock before the update starts,
+ * as the update may be split by slot rather than by index.
+ * @param in Current step.
+ * @param out Next step, already the same size as the current one.
+ * @param begin Index of the first boid.
+ * @param end Index one past the last boid.
+ */
+static void carryOver(const FlockState& in, FlockState& out, const std::size_t& begin,
+                      const std::size_t& end) {
+    std::copy(in.hue.begin() + begin, in.hue.begin() + end, out.hue.begin() + begin);
+    std::copy(in.saturation.begin() + begin, in.saturation.begin() + end,
+              out.saturation.begin() + begin);
+    std::copy(in.value.begin() + begin, in.value.begin() + end, out.value.begin() + begin);
+    std::copy(in.id.begin() + begin, in.id.begin() + end, out.id.begin() + begin);
+    std::copy(in.type.begin() + begin, in.type.begin() + end, out.type.begin() + begin);
+    for (std::size_t i = begin; i < end; ++i) {
+        if (in.type[i] != BoidType::OBSTACLE)
+            continue;
+        out.x[i]  = in.x[i];
+        out.y[i]  = in.y[i];
+        out.vx[i] = in.vx[i];
+        out.vy[i] = in.vy[i];
+    }
+}
 
-        b.setPosition(QPointF(p.x() + v.x(), p.y() + v.y()));
-        utils::wrapBoidPosition(b, sceneBounds);
+// Bit set in the random stream of each boid added to the flock, to keep those streams apart from
+// the ones used in the update, which are keyed on the step and the boid ID.
+constexpr uint64_t SPAWN_STREAM = uint64_t(1) << 63;
 
-        b.setVelocity(v);
+// Batches smaller than this are added on the calling thread, as splitting them isn't worth it.
+constexpr std::size_t PARALLEL_SPAWN_MIN = 4096;
 
-        const QColor& colour = boids::utils::calculateBoidColor(b, neighbours);
-        b.setColor(colour);
-    }
-};
+Flock::Flock(const std::size_t numThreads) : Flock(numThreads, std::random_device{}()) {}
 
-Flock::Flock() {
-    idCount_ = 0;
-    boidMap_.clear();
+Flock::Flock(const std::size_t numThreads, const uint64_t seed) {
+    numThreads_       = std::max<std::size_t>(numThreads, 1);
+    updateMode_       = UpdateMode::IN_PLACE;
+    boundaryMode_     = BoundaryMode::PERIODIC;
+    clusterInterval_  = 0;
+    neighbourSkin_    = 0.0f;
+    rejectedCommands_ = 0;
+    state_.clear();
     cfgMap_.clear();
+    threadCounters_.resize(1);
+    threadMetrics_.resize(1);
+    setSeed(seed);
 
     cfgMap_[BoidType::BOID]     = Config();
     cfgMap_[BoidType::PREDATOR] = Config();
@@ -89,41 +250,444 @@ Flock::Flock() {
     cfgMap_[BoidType::PREDATOR].predatorRepelScale  = 5.0f;
 }
 
-int Flock::addBoid(const float x, const float y, const BoidType type) {
-    if (!boidMap_.contains(type)) {
-        boidMap_[type] = std::vector<Boid>();
+BoidId Flock::addBoid(const float x, const float y, const BoidType type) {
+    const Vec2 pos(x, y);
+    return addBoids(std::span<const Vec2>(&pos, 1), type).front();
+}
+
+std::span<const BoidId> Flock::addBoids(std::span<const Vec2> positions, const BoidType type) {
+    return spawn(positions.size(), type,
+                 [positions](std::size_t k, Random&) { return positions[k]; });
+}
+
+std::span<const BoidId> Flock::spawnUniform(const std::size_t& n, const Rect& rect,
+                                            const BoidType type) {
+    return spawn(n, type, [&rect](std::size_t, Random& rng) {
+        const float x = rng.uniform(rect.left(), rect.right());
+        const float y = rng.uniform(rect.top(), rect.bottom());
+        return Vec2(x, y);
+    });
+}
+
+std::span<const BoidId> Flock::spawn(const std::size_t& n, const BoidType& type,
+                                     const std::function<Vec2(std::size_t, Random&)>& position) {
+    if (!canAddBoids(n))
+        throw std::length_error("Flock::spawn(): out of boid IDs");
+
+    const std::size_t first      = state_.size();
+    const uint64_t    firstSpawn = spawnCount_;
+    spawnCount_ += n;
+
+    // Grow the arrays once and hand out the IDs, then fill in each boid from its own random
+    // stream, so that the boids can be generated in any order (and on any thread) and still come
+    // out the same.
+    state_.resize(first + n);
+    neighbourLists_.invalidate();
+    for (std::size_t i = first; i < first + n; ++i) {
+        state_.id[i] = slots_.insert(i);
     }
-    boidMap_[type].push_back(Boid(idCount_, x, y, type));
-    return idCount_++;
+    const auto fill = [&](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t k = begin; k < end; ++k) {
+            const std::size_t i = first + k;
+            Random            rng(seed_, SPAWN_STREAM | (firstSpawn + k));
+            const Vec2        pos = position(k, rng);
+            const Boid        boid(state_.id[i], pos.x(), pos.y(), rng, type);
+            const Vec2        v = boid.getVelocity();
+            const Color       c = boid.getColor();
+
+            state_.x[i]          = pos.x();
+            state_.y[i]          = pos.y();
+            state_.vx[i]         = v.x();
+            state_.vy[i]         = v.y();
+            state_.hue[i]        = std::max(0, c.hsvHue());
+            state_.saturation[i] = c.saturation();
+            state_.value[i]      = c.value();
+            state_.type[i]       = type;
+        }
+    };
+
+    if (n < PARALLEL_SPAWN_MIN)
+        fill(0, n, 0);
+    else
+        getPool().parallelFor(n, fill);
+    return std::span<const BoidId>(state_.id.data() + first, n);
 }
 
-void Flock::clearBoids() { boidMap_.clear(); }
+bool Flock::removeBoid(const BoidId& id) {
+    if (!slots_.contains(id))
+        return false;
+
+    const std::size_t i = slots_.getIndex(id);
+    slots_.erase(id);
+    state_.swapRemove(i);
+    neighbourLists_.invalidate();
+    if (i < state_.size())
+        slots_.setIndex(state_.id[i], i);
+    return true;
+}
+
+bool Flock::canAddBoids(const std::size_t& n) const { return n <= slots_.available(); }
+
+bool Flock::hasBoid(const BoidId& id) const { return slots_.contains(id); }
+
+std::size_t Flock::getIndex(const BoidId& id) const {
+    if (!slots_.contains(id))
+        throw std::invalid_argument("Flock::getIndex(): stale boid ID");
+    return slots_.getIndex(id);
+}
+
+void Flock::clearBoids() {
+    state_.clear();
+    slots_.clear();
+    neighbourLists_.invalidate();
+}
 
 void Flock::clearBoids(const BoidType& type) {
-    if (!boidMap_.contains(type))
-        return;
-    boidMap_.at(type).clear();
+    for (std::size_t i = 0; i < state_.size(); ++i) {
+        if (state_.type[i] == type)
+            slots_.erase(state_.id[i]);
+    }
+    state_.clear(type);
+    neighbourLists_.invalidate();
+
+    // The remaining boids have been compacted, so point their IDs at their new indices.
+    for (std::size_t i = 0; i < state_.size(); ++i) {
+        slots_.setIndex(state_.id[i], i);
+    }
 }
 
-std::map<BoidType, std::vector<Boid>> Flock::getBoids() const { return boidMap_; }
+std::size_t Flock::getNumBoids(const BoidType& type) const {
+    return std::size_t(std::count(state_.type.begin(), state_.type.end(), type));
+}
+
+ConstBoidView Flock::getBoid(const BoidId& id) const { return state_.view(getIndex(id)); }
+
+const FlockState& Flock::getState() const { return state_; }
+
+void Flock::getSnapshot(FlockSnapshot& snapshot) const {
+    snapshot.step    = step_;
+    snapshot.state   = state_;
+    snapshot.stats   = statsWindow_.getMean();
+    snapshot.metrics = metrics_;
+    snapshot.time    = std::chrono::steady_clock::now();
+}
 
 Config Flock::getConfig(const BoidType& type) const { return cfgMap_.at(type); }
 
 void Flock::setConfig(const Config& cfg, const BoidType& type) { cfgMap_[type] = cfg; }
 
-int Flock::getNumBoids() const { return boids::utils::getTotalNumBoids(boidMap_); }
+int Flock::getNumBoids() const { return state_.size(); }
+
+Rect Flock::getSceneBounds() const { return sceneBounds_; }
+
+void Flock::setSceneBounds(const Rect& bounds) { sceneBounds_ = bounds; }
+
+UpdateMode Flock::getUpdateMode() const { return updateMode_; }
+
+void Flock::setUpdateMode(const UpdateMode& mode) { updateMode_ = mode; }
+
+BoundaryMode Flock::getBoundaryMode() const { return boundaryMode_; }
+
+void Flock::setBoundaryMode(const BoundaryMode& mode) { boundaryMode_ = mode; }
+
+float Flock::getNeighbourSkin() const { return neighbourSkin_; }
+
+void Flock::setNeighbourSkin(const float& skin) { neighbourSkin_ = std::max(skin, 0.0f); }
+
+std::size_t Flock::getNumThreads() const { return numThreads_; }
+
+void Flock::setNumThreads(const std::size_t& numThreads) {
+    numThreads_ = std::max<std::size_t>(numThreads, 1);
+}
+
+uint64_t Flock::getSeed() const { return seed_; }
+
+void Flock::setSeed(const uint64_t& seed) {
+    seed_       = seed;
+    step_       = 0;
+    spawnCount_ = 0;
+}
+
+ThreadPool& Flock::getPool() {
+    // The pool is only rebuilt here, between steps, so the thread count can safely be changed
+    // from another thread while the simulation is running.
+    const std::size_t numThreads = numThreads_;
+    if (!pool_ || pool_->getNumThreads() != numThreads) {
+        pool_ = std::make_unique<ThreadPool>(numThreads);
+    }
+    return *pool_;
+}
 
-QRectF Flock::getSceneBounds() const { return sceneBounds_; }
+void Flock::post(Command command) { commands_.push(std::move(command)); }
+
+std::size_t Flock::applyCommands() {
+    std::size_t count = 0;
+    Command     command;
+    while (commands_.tryPop(command)) {
+        // Adding more boids than there are IDs left would throw, so those commands are dropped.
+        const auto*       add      = std::get_if<command::AddBoid>(&command);
+        const auto*       spawn    = std::get_if<command::SpawnUniform>(&command);
+        const std::size_t numAdded = add ? 1 : spawn ? spawn->n : 0;
+        if (!canAddBoids(numAdded)) {
+            ++rejectedCommands_;
+            continue;
+        }
+
+        if (add)
+            addBoid(add->x, add->y, add->type);
+        else if (spawn)
+            spawnUniform(spawn->n, spawn->rect, spawn->type);
+        else if (const auto* c = std::get_if<command::RemoveBoid>(&command))
+            removeBoid(c->id);
+        else if (std::holds_alternative<command::ClearBoids>(command))
+            clearBoids();
+        else if (const auto* c = std::get_if<command::ClearBoidsOfType>(&command))
+            clearBoids(c->type);
+        else if (const auto* c = std::get_if<command::SetConfig>(&command))
+            setConfig(c->cfg, c->type);
+        else if (const auto* c = std::get_if<command::SetSceneBounds>(&command))
+            setSceneBounds(c->bounds);
+        ++count;
+    }
+    return count;
+}
 
-void Flock::setSceneBounds(const QRectF& bounds) { sceneBounds_ = bounds; }
+std::size_t Flock::getNumRejectedCommands() const { return rejectedCommands_; }
 
 void Flock::update() {
-    updateBoids(boidMap_[BoidType::BOID], boidMap_[BoidType::BOID], boidMap_[BoidType::PREDATOR],
-                boidMap_[BoidType::OBSTACLE], cfgMap_[BoidType::BOID], sceneBounds_);
+    BOIDS_TRACE_ZONE("Flock::update");
+
+#ifdef BOIDS_STEP_STATS
+    const auto     start       = StepClock::now();
+    const uint64_t allocations = getThreadAllocations();
+#endif
+
+    // Changes posted from other threads are applied between steps, so they never race the update.
+    {
+        BOIDS_TRACE_ZONE("Flock::applyCommands");
+        applyCommands();
+    }
+
+#ifdef BOIDS_STEP_STATS
+    const auto            commandsEnd = StepClock::now();
+    StepClock::time_point gridEnd;
+#endif
 
-    updateBoids(boidMap_[BoidType::PREDATOR], boidMap_[BoidType::BOID],
-                boidMap_[BoidType::PREDATOR], boidMap_[BoidType::OBSTACLE],
-                cfgMap_[BoidType::PREDATOR], sceneBounds_);
+    const uint64_t step = step_++;
+
+    // Everything taken from the arena during the previous step is freed at once.
+    stepArena_.reset();
+
+    const UpdateMode   mode         = updateMode_;
+    const BoundaryMode boundaryMode = boundaryMode_;
+
+    // Like the metrics, the clusters are found in the state that the step starts from.
+    const std::size_t clusterInterval = clusterInterval_;
+    const bool        findClusters    = clusterInterval > 0 && step % clusterInterval == 0;
+    const float       boidRadius      = cfgMap_[BoidType::BOID].neighbourhoodRadius;
+
+    float radius = 0.0f;
+    float motion = 0.0f;
+    for (const auto& [type, cfg] : cfgMap_) {
+        radius = std::max(radius, cfg.neighbourhoodRadius);
+        motion = std::max(motion, cfg.maxVelocity);
+    }
+
+    // The neighbour lists are only used by the double-buffered update, which doesn't change the
+    // state it searches. Each type's lists reach as far as its own neighbourhood radius plus the
+    // skin, so that BOIDs don't carry the longer lists of the PREDATORs.
+    const float skin = mode == UpdateMode::DOUBLE_BUFFERED ? float(neighbourSkin_) : 0.0f;
+
+    const float boidListRadius     = boidRadius + skin;
+    const float predatorListRadius = cfgMap_[BoidType::PREDATOR].neighbourhoodRadius + skin;
+    const bool  useLists           = skin > 0.0f;
+    bool        buildLists         = false;
+    if (!useLists)
+        neighbourLists_.invalidate();
+
+    if (mode == UpdateMode::IN_PLACE) {
+        // The grid is built once per step, but the boids are updated in place, so a boid may have
+        // moved (by at most its max velocity) since it was bucketed. Pad the cell size with that
+        // distance so that the 3x3 cell block around a boid always contains its whole
+        // neighbourhood. The in-place update is order dependent, so it always runs on one thread.
+        {
+            BOIDS_TRACE_ZONE("Flock::rebuildGrid");
+            grid_.rebuild(state_.x, state_.y, radius + motion, sceneBounds_, &stepArena_);
+        }
+
+#ifdef BOIDS_STEP_STATS
+        gridEnd = StepClock::now();
+        std::fill(threadCounters_.begin(), threadCounters_.end(), ThreadStepCounters());
+#endif
+        std::fill(threadMetrics_.begin(), threadMetrics_.end(), MetricSums());
+
+        const std::size_t n = state_.size();
+        if (findClusters) {
+            BOIDS_TRACE_ZONE("Flock::findClusters");
+            packed_.pack(state_, grid_);
+            clusterFinder_.reset(n);
+            clusterFinder_.link(packed_, grid_, boidRadius, sceneBounds_, 0, n, boundaryMode);
+            clusterFinder_.collect(state_, packed_, sceneBounds_, step, clusters_, boundaryMode);
+        }
+
+        BOIDS_TRACE_ZONE("Flock::updateBoids");
+        MetricSums&         metrics  = threadMetrics_[0];
+        ThreadStepCounters& counters = threadCounters_[0];
+        boundary::visit(boundaryMode, [&](auto policy) {
+            using Policy = decltype(policy);
+            updateBoids<Policy>(state_, state_, BoidType::BOID, grid_, nullptr, nullptr,
+                                cfgMap_[BoidType::BOID], sceneBounds_, seed_, step, 0, n, metrics,
+                                counters);
+            updateBoids<Policy>(state_, state_, BoidType::PREDATOR, grid_, nullptr, nullptr,
+                                cfgMap_[BoidType::PREDATOR], sceneBounds_, seed_, step, 0, n,
+                                metrics, counters);
+        });
+    } else {
+        // Every boid reads the current step and writes to the next one. What the update doesn't
+        // write is first carried over to the back buffer, whose capacity is reused.
+        // The current step doesn't change during the update, so the neighbourhoods are read from
+        // a copy packed in grid order, which the SIMD kernels can stream through. In a periodic
+        // scene the copy also holds a halo of ghosts of the boids along the edges, so that no
+        // displacement has to be wrapped. Only the grid and the halo are built on the calling
+        // thread, while the copy is packed in parallel.
+        //
+        // With neighbour lists, the grid and its slot order are kept for as long as the lists are
+        // valid, i.e. until some boid has moved by more than half the skin since they were built,
+        // and only the state is repacked. The lists are then rebuilt from a grid with cells as
+        // large as the longest list radius.
+        ThreadPool& pool = getPool();
+        if (threadCounters_.size() < pool.getNumThreads()) {
+            threadCounters_.resize(pool.getNumThreads());
+            threadMetrics_.resize(pool.getNumThreads());
+        }
+        const auto pack = [&]() {
+            packed_.resize(grid_);
+            pool.parallelFor(state_.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+                packed_.packSlots(state_, grid_, begin, end);
+            });
+            packed_.packHalo(grid_);
+        };
+        {
+            BOIDS_TRACE_ZONE("Flock::rebuildGrid");
+            if (useLists) {
+                buildLists = !neighbourLists_.matches(state_.size(), boidListRadius,
+                                                      predatorListRadius, sceneBounds_,
+                                                      boundaryMode);
+                if (!buildLists) {
+                    pack();
+                    buildLists = neighbourLists_.getMaxDisplacement(packed_) > 0.5f * skin;
+                }
+                if (buildLists) {
+                    grid_.rebuild(state_.x, state_.y, radius + skin, sceneBounds_, &stepArena_);
+                    pack();
+                }
+            } else {
+                grid_.rebuild(state_.x, state_.y, radius, sceneBounds_, &stepArena_);
+                if (boundaryMode == BoundaryMode::PERIODIC)
+                    grid_.buildHalo();
+                pack();
+            }
+            nextState_.resize(state_.size());
+            pool.parallelFor(state_.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+                carryOver(state_, nextState_, begin, end);
+            });
+        }
+        if (buildLists) {
+            BOIDS_TRACE_ZONE("Flock::buildNeighbourLists");
+            neighbourLists_.beginBuild(grid_, packed_, boidListRadius, predatorListRadius,
+                                       sceneBounds_, boundaryMode);
+            pool.parallelFor(neighbourLists_.getNumBlocks(),
+                             [&](std::size_t begin, std::size_t end, std::size_t) {
+                                 neighbourLists_.build(grid_, packed_, begin, end);
+                             });
+        }
+#ifdef BOIDS_STEP_STATS
+        gridEnd = StepClock::now();
+        std::fill(threadCounters_.begin(), threadCounters_.end(), ThreadStepCounters());
+#endif
+        std::fill(threadMetrics_.begin(), threadMetrics_.end(), MetricSums());
+        if (findClusters)
+            clusterFinder_.reset(state_.size());
+
+        const Config&         boidCfg     = cfgMap_[BoidType::BOID];
+        const Config&         predatorCfg = cfgMap_[BoidType::PREDATOR];
+        const NeighbourLists* lists       = useLists ? &neighbourLists_ : nullptr;
+        pool.parallelFor(state_.size(), [&](std::size_t begin, std::size_t end,
+                                            std::size_t worker) {
+            BOIDS_TRACE_ZONE("Flock::updateBoids");
+            MetricSums&         metrics  = threadMetrics_[worker];
+            ThreadStepCounters& counters = threadCounters_[worker];
+#ifdef BOIDS_STEP_STATS
+            const uint64_t chunkAllocations = getThreadAllocations();
+#endif
+            boundary::visit(boundaryMode, [&](auto policy) {
+                using Policy = decltype(policy);
+                updateBoids<Policy>(state_, nextState_, BoidType::BOID, grid_, &packed_, lists,
+                                    boidCfg, sceneBounds_, seed_, step, begin, end, metrics,
+                                    counters);
+                updateBoids<Policy>(state_, nextState_, BoidType::PREDATOR, grid_, &packed_, lists,
+                                    predatorCfg, sceneBounds_, seed_, step, begin, end, metrics,
+                                    counters);
+            });
+            if (findClusters && lists) {
+                BOIDS_TRACE_ZONE("Flock::linkClusters");
+                clusterFinder_.link(packed_, *lists, boidRadius, sceneBounds_, begin, end,
+                                    boundaryMode);
+            } else if (findClusters) {
+                BOIDS_TRACE_ZONE("Flock::linkClusters");
+                clusterFinder_.link(packed_, grid_, boidRadius, sceneBounds_, begin, end,
+                                    boundaryMode);
+            }
+#ifdef BOIDS_STEP_STATS
+            // The calling thread's allocations are counted over the whole update.
+            if (worker != 0)
+                counters.allocations += getThreadAllocations() - chunkAllocations;
+#endif
+        });
+
+        if (findClusters) {
+            BOIDS_TRACE_ZONE("Flock::collectClusters");
+            clusterFinder_.collect(state_, packed_, sceneBounds_, step, clusters_, boundaryMode);
+        }
+        std::swap(state_, nextState_);
+    }
+
+    const double sceneArea = double(sceneBounds_.width()) * double(sceneBounds_.height());
+    metrics_               = reduceMetrics(threadMetrics_, step, sceneArea, boidRadius);
+
+#ifdef BOIDS_STEP_STATS
+    const auto end = StepClock::now();
+    stepStats_     = StepStats();
+    StepStats& s   = stepStats_;
+    s.step         = step;
+    s.totalNs      = elapsedNs(start, end);
+    s.commandsNs   = elapsedNs(start, commandsEnd);
+    s.gridNs       = elapsedNs(commandsEnd, gridEnd);
+    s.allocations  = getThreadAllocations() - allocations;
+    s.listBuilds   = buildLists ? 1 : 0;
+    for (const ThreadStepCounters& c : threadCounters_) {
+        s.neighboursNs += c.neighboursNs;
+        s.integrateNs += c.integrateNs;
+        s.numBoids += c.numBoids;
+        s.distanceTests += c.distanceTests;
+        s.neighbours += c.neighbours;
+        s.maxNeighbours = std::max(s.maxNeighbours, c.maxNeighbours);
+        s.allocations += c.allocations;
+    }
+    statsWindow_.push(s);
+#endif
 }
 
+const StepStats& Flock::getStepStats() const { return stepStats_; }
+
+const StepStatsWindow& Flock::getStepStatsWindow() const { return statsWindow_; }
+
+const FlockMetrics& Flock::getMetrics() const { return metrics_; }
+
+std::size_t Flock::getClusterInterval() const { return clusterInterval_; }
+
+void Flock::setClusterInterval(const std::size_t& interval) { clusterInterval_ = interval; }
+
+const FlockClusters& Flock::getClusters() const { return clusters_; }
+
 }; // namespace boids
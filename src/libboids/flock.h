@@ -1,23 +1,149 @@
 #pragma once
 
+#include "arena.h"
 #include "boids.h"
+#include "boundary.h"
+#include "commands.h"
 #include "config.h"
-#include <QRectF>
+#include "flock_clusters.h"
+#include "flock_metrics.h"
+#include "flock_state.h"
+#include "kernel.h"
+#include "mpsc_queue.h"
+#include "neighbour_lists.h"
+#include "random.h"
+#include "slot_map.h"
+#include "spatial_grid.h"
+#include "step_stats.h"
+#include "thread_pool.h"
+#include "types.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <span>
 
 namespace boids {
 
+/**
+ * @brief The way in which the Flock is stepped forward:
+ * - IN_PLACE updates each boid in turn, so boids later in the step see the already updated state
+ *   of earlier boids (and predators see the updated boids). This is the legacy behaviour, and the
+ *   default.
+ * - DOUBLE_BUFFERED reads every boid from the current step and writes to the next step, swapping
+ *   the buffers at the end of the update. The result doesn't depend on the update order.
+ */
+enum UpdateMode { IN_PLACE, DOUBLE_BUFFERED };
+
+/**
+ * @brief The FlockSnapshot struct is a copy of the flock taken between two updates, which can be
+ * handed to another thread (e.g. a renderer) while the flock carries on being updated.
+ */
+struct FlockSnapshot {
+    uint64_t     step = 0; ///< Number of updates since the flock was seeded.
+    FlockState   state;    ///< All the boids in the flock.
+    StepStats    stats;    ///< Mean stats of the most recent updates. See getStepStatsWindow().
+    FlockMetrics metrics;  ///< Metrics of the most recent update. See getMetrics().
+
+    // When the snapshot was taken, for measuring how old it is by the time it is used.
+    std::chrono::steady_clock::time_point time;
+};
+
+/**
+ * @brief The Flock class owns all the boids in the simulation and steps them forward.
+ *
+ * The Flock is not thread-safe: its methods must all be called from the thread that calls
+ * update(). The only exceptions are setNumThreads(), setUpdateMode(), setBoundaryMode(),
+ * setClusterInterval(), setNeighbourSkin() and post(). Other threads (e.g. a GUI) change the
+ * flock by posting commands, which are applied in a batch at the start of the next update.
+ */
 class Flock {
   public:
-    Flock();
+    /**
+     * @brief Construct a new Flock object, with a random seed.
+     * @param numThreads Number of threads to split the update across. See setNumThreads().
+     */
+    Flock(const std::size_t numThreads = 1);
+
+    /**
+     * @brief Construct a new Flock object with a given seed, so that the run can be reproduced.
+     * @param numThreads Number of threads to split the update across. See setNumThreads().
+     * @param seed Seed for the random numbers. See setSeed().
+     */
+    Flock(const std::size_t numThreads, const uint64_t seed);
 
     /**
      * @brief Add a boid of a given type to the Flock, at a given coordinate.
      * @param x X coordinate.
      * @param y Y coordinate.
      * @param type Type of boids, defaults to BoidType::BOID.
-     * @return Unique ID for the new boid.
+     * @return Unique ID for the new boid, which stays valid until the boid is removed.
+     * @throws std::length_error if every boid ID is in use or retired. See canAddBoids().
+     */
+    BoidId addBoid(const float x, const float y, const BoidType type = BoidType::BOID);
+
+    /**
+     * @brief Add a batch of boids of a given type to the Flock, one at each of the given positions.
+     *
+     * The storage is grown once for the whole batch, and the random velocities and colours are
+     * generated in bulk, split across the flock's threads for large batches. Each new boid draws
+     * from its own stream, keyed on the number of boids added since the flock was seeded, so the
+     * result is the same as adding the boids one at a time with addBoid().
+     *
+     * @param positions Position of each new boid.
+     * @param type Type of boids, defaults to BoidType::BOID.
+     * @return IDs given to the new boids, in the order of the positions. The span points into the
+     * flock state, so it is only valid until the flock is next modified.
+     * @throws std::length_error if there aren't enough boid IDs left for the whole batch, in which
+     * case no boids are added. See canAddBoids().
      */
-    int addBoid(const float x, const float y, const BoidType type = BoidType::BOID);
+    std::span<const BoidId> addBoids(std::span<const Vec2> positions,
+                                     const BoidType        type = BoidType::BOID);
+
+    /**
+     * @brief Add a batch of boids of a given type to the Flock, scattered uniformly over a
+     * rectangle. See addBoids().
+     * @param n Number of boids to add.
+     * @param rect Rectangle to scatter the boids over.
+     * @param type Type of boids, defaults to BoidType::BOID.
+     * @return IDs given to the new boids. See addBoids().
+     * @throws std::length_error if there aren't enough boid IDs left. See addBoids().
+     */
+    std::span<const BoidId> spawnUniform(const std::size_t& n, const Rect& rect,
+                                         const BoidType type = BoidType::BOID);
+
+    /**
+     * @brief Check whether there are enough boid IDs left to add a batch of boids. A flock that
+     * keeps adding and removing boids for long enough slowly uses up its IDs, as each slot of the
+     * SlotMap is retired once all its generations have been handed out.
+     * @param n Number of boids.
+     * @return True if n more boids can be added.
+     */
+    bool canAddBoids(const std::size_t& n) const;
+
+    /**
+     * @brief Remove the boid with a given ID in O(1). The last boid in the flock state is moved
+     * into its place, but keeps its ID.
+     * @param id ID of the boid.
+     * @return True if the boid was found and removed, false if the ID is stale.
+     */
+    bool removeBoid(const BoidId& id);
+
+    /**
+     * @brief Check whether the boid with a given ID still exists.
+     * @param id ID of the boid.
+     * @return True if the boid exists, false if the ID is stale.
+     */
+    bool hasBoid(const BoidId& id) const;
+
+    /**
+     * @brief Get the index of the boid with a given ID in the flock state. See getState().
+     * @param id ID of the boid.
+     * @return Index of the boid. This is only valid until the flock is next modified.
+     * @throws std::invalid_argument if the ID is stale.
+     */
+    std::size_t getIndex(const BoidId& id) const;
 
     /**
      * @brief Clear all the boids in the flock.
@@ -39,10 +165,37 @@ class Flock {
     int getNumBoids() const;
 
     /**
-     * @brief Get the std::map of boids
-     * @return The std::map containing all the different types of boids.
+     * @brief Get the number of boids of a given type.
+     * @param type Type of boids.
+     * @return Number of boids.
+     */
+    std::size_t getNumBoids(const BoidType& type) const;
+
+    /**
+     * @brief Get a read-only view of the boid with a given ID, which reads straight from the flock
+     * state rather than copying the boid out of it.
+     * @param id ID of the boid.
+     * @return View onto the boid. This is only valid until the flock is next modified.
+     * @throws std::invalid_argument if the ID is stale.
+     */
+    ConstBoidView getBoid(const BoidId& id) const;
+
+    /**
+     * @brief Get the structure of arrays holding all the boids, without copying it.
+     * @return Reference to the flock state. This is only valid until the flock is next modified.
      */
-    std::map<BoidType, std::vector<Boid>> getBoids() const;
+    const FlockState& getState() const;
+
+    /**
+     * @brief Copy the current state, recent stats and metrics of the flock into a snapshot, stamped
+     * with the current time. The snapshot's arrays are assigned to rather than replaced, so reusing
+     * the same snapshot (e.g. the buffers of a TripleBuffer) doesn't allocate once it has grown to
+     * the size of the flock. The state is copied rather than swapped out of the flock, because the
+     * flock still needs it for the next step and for any commands applied before then; the copy is
+     * a single pass over the arrays and small next to the step that produced them.
+     * @param snapshot Snapshot to copy into.
+     */
+    void getSnapshot(FlockSnapshot& snapshot) const;
 
     /**
      * @brief Get the configuration for a given boid type.
@@ -62,26 +215,232 @@ class Flock {
      * @brief Get the scene bounds that the Boids adhere to.
      * @return The scene bounds rectangle.
      */
-    QRectF getSceneBounds() const;
+    Rect getSceneBounds() const;
 
     /**
      * @brief Set the Scene Bounds object
      * @param bounds Scene bounds rectangle object.
      */
-    void setSceneBounds(const QRectF& bounds);
+    void setSceneBounds(const Rect& bounds);
+
+    /**
+     * @brief Get the mode used to step the flock forward.
+     * @return Update mode.
+     */
+    UpdateMode getUpdateMode() const;
+
+    /**
+     * @brief Set the mode used to step the flock forward.
+     * @param mode Update mode.
+     */
+    void setUpdateMode(const UpdateMode& mode);
+
+    /**
+     * @brief Get the way the edges of the scene behave.
+     * @return Boundary mode.
+     */
+    BoundaryMode getBoundaryMode() const;
+
+    /**
+     * @brief Set the way the edges of the scene behave. The update is compiled separately for each
+     * mode, so a scene that isn't periodic doesn't pay for wrapping the displacement to every
+     * neighbour. This is safe to call while the flock is being updated on another thread, and
+     * takes effect from the next update.
+     * @param mode Boundary mode.
+     */
+    void setBoundaryMode(const BoundaryMode& mode);
+
+    /**
+     * @brief Get the skin of the cached neighbour lists. See setNeighbourSkin().
+     * @return Skin distance, or zero if the lists are disabled.
+     */
+    float getNeighbourSkin() const;
+
+    /**
+     * @brief Set the skin of the cached neighbour lists, which the UpdateMode::DOUBLE_BUFFERED
+     * update searches the neighbourhoods through instead of the grid when the skin is positive.
+     *
+     * The lists hold the candidates within the neighbourhood radius of each boid plus the skin,
+     * and are only rebuilt (together with the grid) once some boid has moved by more than half
+     * the skin since the last build, or the flock or scene has changed. Between builds, each
+     * update only filters the cached candidates. A larger skin keeps the lists for more steps, at
+     * the cost of more candidates to filter in each one: a skin of a few steps of maxVelocity is a
+     * good start.
+     * The result is the same as without the lists, up to floating point rounding.
+     *
+     * This is safe to call while the flock is being updated on another thread, and takes effect
+     * from the next update.
+     *
+     * @param skin Skin distance, or zero to disable the lists. Negative values are treated as zero.
+     */
+    void setNeighbourSkin(const float& skin);
+
+    /**
+     * @brief Get the number of threads that the update is split across.
+     * @return Number of threads.
+     */
+    std::size_t getNumThreads() const;
+
+    /**
+     * @brief Set the number of threads that the update is split across. The threads belong to a
+     * persistent pool that is resized at the start of the next update, so this is safe to call
+     * while the flock is being updated on another thread.
+     *
+     * Only the UpdateMode::DOUBLE_BUFFERED update is run in parallel. The in-place update always
+     * runs on the calling thread.
+     *
+     * @param numThreads Number of threads, including the thread calling update(). Values less than
+     * one are treated as one.
+     */
+    void setNumThreads(const std::size_t& numThreads);
+
+    /**
+     * @brief Get the seed of the random numbers used by the flock.
+     * @return Seed.
+     */
+    uint64_t getSeed() const;
+
+    /**
+     * @brief Seed the random numbers used by the flock, and restart the random streams.
+     *
+     * The random velocity and colour of new boids, and the noise added in each update, are all
+     * drawn from streams derived from the seed. The noise for each boid is keyed on its ID and the
+     * number of steps since the flock was seeded, rather than on the thread that updates it or on
+     * where it is stored, so adding the same boids and stepping the same number of times after
+     * setting the same seed gives exactly the same flock, whatever the number of threads.
+     *
+     * @param seed Seed.
+     */
+    void setSeed(const uint64_t& seed);
+
+    /**
+     * @brief Post a command to be applied at the start of the next update. This is lock-free and
+     * can be called from any number of threads at once, including while the flock is being
+     * updated. Commands posted by the same thread are applied in the order they were posted.
+     * @param command Command to post.
+     */
+    void post(Command command);
+
+    /**
+     * @brief Apply all the commands posted so far. This is called at the start of every update,
+     * but can also be called directly to apply the commands without stepping the flock.
+     *
+     * Commands that add more boids than there are IDs left (see canAddBoids()) are rejected
+     * rather than applied, so that running out of IDs never stops the thread updating the flock.
+     * They are counted by getNumRejectedCommands().
+     *
+     * @return Number of commands applied.
+     */
+    std::size_t applyCommands();
 
     /**
-     * @brief Update the boids with a single step. This will update the normal boids, as well as the
-     * predators.
+     * @brief Get the number of posted commands that have been rejected, since the flock was
+     * created. See applyCommands().
+     * @return Number of rejected commands.
+     */
+    std::size_t getNumRejectedCommands() const;
+
+    /**
+     * @brief Apply any posted commands, then update the boids with a single step. This will update
+     * the normal boids, as well as the predators.
      * @throws Exception if a config has not been set for the BoidType::BOID or BoidType::PREDATOR.
      */
     void update();
 
+    /**
+     * @brief Get the timings and counters recorded for the most recent update. These are only
+     * recorded when libboids is built with BOIDS_STEP_STATS defined, and are all zero otherwise.
+     * @return Stats of the most recent update.
+     */
+    const StepStats& getStepStats() const;
+
+    /**
+     * @brief Get the stats of the most recent updates, for averaging over. See getStepStats().
+     * @return Rolling window of stats.
+     */
+    const StepStatsWindow& getStepStatsWindow() const;
+
+    /**
+     * @brief Get the collective behaviour metrics of the most recent update. These are reduced
+     * inside the neighbour search of the update, so they cost no extra pass over the flock.
+     * @return Metrics of the most recent update.
+     */
+    const FlockMetrics& getMetrics() const;
+
+    /**
+     * @brief Get how often the clusters of the flock are found. See getClusters().
+     * @return Number of steps between cluster searches, or zero if they are disabled.
+     */
+    std::size_t getClusterInterval() const;
+
+    /**
+     * @brief Set how often the clusters of the flock are found. The neighbour pairs of the BOIDs
+     * are joined with a union-find as part of the update, split across the same threads and
+     * reusing the same spatial grid. A search costs about as much again as the neighbour search of
+     * the update, so an interval of more than one keeps the average cost down. This is safe to
+     * call while the flock is being updated on another thread.
+     * @param interval Number of steps between cluster searches, or zero to disable them.
+     */
+    void setClusterInterval(const std::size_t& interval);
+
+    /**
+     * @brief Get the clusters found by the most recent search, i.e. the sets of BOIDs that are
+     * connected through a chain of neighbours within the BOID neighbourhood radius. Like the
+     * metrics, the clusters are found in the state that the update started from.
+     * @return Clusters of the most recent search, which may be several steps old. See
+     * setClusterInterval().
+     */
+    const FlockClusters& getClusters() const;
+
   private:
-    std::size_t                           idCount_;
-    QRectF                                sceneBounds_;
-    std::map<BoidType, std::vector<Boid>> boidMap_;
-    std::map<BoidType, Config>            cfgMap_;
+    /**
+     * @brief Add a batch of boids, generating the position of each one with a given function.
+     * @param n Number of boids to add.
+     * @param type Type of boids.
+     * @param position Function called with the index of each boid within the batch and its random
+     * stream, which returns its position.
+     * @return IDs given to the new boids.
+     */
+    std::span<const BoidId> spawn(const std::size_t& n, const BoidType& type,
+                                  const std::function<Vec2(std::size_t, Random&)>& position);
+
+    /**
+     * @brief Get the thread pool, (re)creating it if the number of threads has changed. This must
+     * only be called between steps.
+     * @return Thread pool.
+     */
+    ThreadPool& getPool();
+
+    uint64_t                    seed_;
+    uint64_t                    step_;       ///< Updates since the flock was seeded.
+    uint64_t                    spawnCount_; ///< Boids added since the flock was seeded.
+    Rect                        sceneBounds_;
+    std::atomic<UpdateMode>     updateMode_;
+    std::atomic<BoundaryMode>   boundaryMode_;
+    std::atomic<std::size_t>    numThreads_;
+    std::atomic<std::size_t>    clusterInterval_; ///< Steps between cluster searches, 0 for none.
+    std::atomic<float>          neighbourSkin_;   ///< Skin of the neighbour lists, 0 for none.
+    std::unique_ptr<ThreadPool> pool_;
+    FlockState                  state_;     ///< Current step, which all mutations are applied to.
+    FlockState                  nextState_; ///< Back buffer used in DOUBLE_BUFFERED mode.
+    SlotMap                     slots_;     ///< Maps the ID of each boid to its index in state_.
+    SpatialGrid                 grid_;
+    kernel::PackedNeighbours    packed_; ///< Current step in grid order, for DOUBLE_BUFFERED mode.
+    NeighbourLists              neighbourLists_;
+    std::map<BoidType, Config>  cfgMap_;
+    MpscQueue<Command>          commands_; ///< Commands posted since the last update.
+    std::size_t                 rejectedCommands_;
+    StepStats                   stepStats_;
+    StepStatsWindow             statsWindow_;
+    FlockMetrics                metrics_;
+    ClusterFinder               clusterFinder_;
+    FlockClusters               clusters_;
+    Arena                       stepArena_; ///< Temporaries of the current step.
+
+    // Counters and metric sums of each thread in the pool, which are reduced into stepStats_ and
+    // metrics_ at the end of each update.
+    std::vector<ThreadStepCounters> threadCounters_;
+    std::vector<MetricSums>         threadMetrics_;
 };
 
 }; // namespace boids
@@ -0,0 +1,199 @@
+#include "flock_clusters.h"
+#include "utils.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+namespace boids {
+
+// Slot of a root that hasn't been given a cluster yet.
+constexpr uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+
+void ClusterFinder::reset(const std::size_t& numSlots) {
+    parent_.resize(numSlots);
+    for (std::size_t i = 0; i < numSlots; ++i) {
+        parent_[i] = uint32_t(i);
+    }
+}
+
+void ClusterFinder::link(const kernel::PackedNeighbours& packed, const SpatialGrid& grid,
+                         const float& radius, const Rect& bounds, const std::size_t& begin,
+                         const std::size_t& end, const BoundaryMode& boundaryMode) {
+    boundary::visit(boundaryMode, [&](auto policy) {
+        linkRange<decltype(policy)>(packed, grid, radius, bounds, begin, end);
+    });
+}
+
+template <typename Policy>
+void ClusterFinder::linkRange(const kernel::PackedNeighbours& packed, const SpatialGrid& grid,
+                              const float& radius, const Rect& bounds, const std::size_t& begin,
+                              const std::size_t& end) {
+    const float radiusSq = radius * radius;
+    const float width    = bounds.width();
+    const float height   = bounds.height();
+
+    std::size_t ranges[2 * SpatialGrid::MAX_RANGES];
+    for (std::size_t k = begin; k < end; ++k) {
+        if (packed.type[k] != BoidType::BOID)
+            continue;
+
+        // Each pair is found from both ends, so only the end with the smaller slot adds it. Most
+        // neighbours are already in the same set, so the roots are compared before uniting.
+        const float       px        = packed.x[k];
+        const float       py        = packed.y[k];
+        const std::size_t numRanges = grid.getSlotRanges(Vec2(px, py), ranges);
+        uint32_t          root      = find(uint32_t(k));
+        for (std::size_t r = 0; r < numRanges; ++r) {
+            for (std::size_t j = std::max(ranges[2 * r], k + 1); j < ranges[2 * r + 1]; ++j) {
+                if (packed.type[j] != BoidType::BOID)
+                    continue;
+                const float dx = Policy::displacement(packed.x[j] - px, width);
+                const float dy = Policy::displacement(packed.y[j] - py, height);
+                if (dx * dx + dy * dy > radiusSq || find(uint32_t(j)) == root)
+                    continue;
+                unite(root, uint32_t(j));
+                root = find(root);
+            }
+        }
+    }
+}
+
+void ClusterFinder::link(const kernel::PackedNeighbours& packed, const NeighbourLists& lists,
+                         const float& radius, const Rect& bounds, const std::size_t& begin,
+                         const std::size_t& end, const BoundaryMode& boundaryMode) {
+    boundary::visit(boundaryMode, [&](auto policy) {
+        linkRange<decltype(policy)>(packed, lists, radius, bounds, begin, end);
+    });
+}
+
+template <typename Policy>
+void ClusterFinder::linkRange(const kernel::PackedNeighbours& packed, const NeighbourLists& lists,
+                              const float& radius, const Rect& bounds, const std::size_t& begin,
+                              const std::size_t& end) {
+    const float radiusSq = radius * radius;
+    const float width    = bounds.width();
+    const float height   = bounds.height();
+
+    for (std::size_t k = begin; k < end; ++k) {
+        if (packed.type[k] != BoidType::BOID)
+            continue;
+
+        // The lists are symmetric, so as with the grid only the end with the smaller slot adds
+        // each pair.
+        const float px   = packed.x[k];
+        const float py   = packed.y[k];
+        uint32_t    root = find(uint32_t(k));
+        for (const int32_t slot : lists.getCandidates(k)) {
+            const std::size_t j = std::size_t(slot);
+            if (j < k || packed.type[j] != BoidType::BOID)
+                continue;
+            const float dx = Policy::displacement(packed.x[j] - px, width);
+            const float dy = Policy::displacement(packed.y[j] - py, height);
+            if (dx * dx + dy * dy > radiusSq || find(uint32_t(j)) == root)
+                continue;
+            unite(root, uint32_t(j));
+            root = find(root);
+        }
+    }
+}
+
+void ClusterFinder::unite(uint32_t a, uint32_t b) {
+    while (true) {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+            return;
+        if (a < b)
+            std::swap(a, b);
+
+        // a is the root with the larger index. If it is no longer a root, another thread has
+        // linked it in the meantime, so start again from its new root.
+        uint32_t expected = a;
+        if (parentOf(a).compare_exchange_weak(expected, b, std::memory_order_relaxed))
+            return;
+    }
+}
+
+uint32_t ClusterFinder::find(uint32_t i) {
+    while (true) {
+        const uint32_t p = parentOf(i).load(std::memory_order_relaxed);
+        if (p == i)
+            return i;
+
+        // Point the slot at its grandparent. Only roots are ever linked, so a slot that isn't a
+        // root only ever moves further up its tree, and a plain store can't undo the work of
+        // another thread.
+        const uint32_t gp = parentOf(p).load(std::memory_order_relaxed);
+        if (gp != p)
+            parentOf(i).store(gp, std::memory_order_relaxed);
+        i = gp;
+    }
+}
+
+std::atomic_ref<uint32_t> ClusterFinder::parentOf(const uint32_t& i) {
+    return std::atomic_ref<uint32_t>(parent_[i]);
+}
+
+void ClusterFinder::collect(const FlockState& state, const kernel::PackedNeighbours& packed,
+                            const Rect& bounds, const uint64_t& step, FlockClusters& clusters,
+                            const BoundaryMode& boundaryMode) {
+    // This only runs once per search, so the boundary is tested rather than specialised. An axis
+    // of infinite size never wraps.
+    const bool  periodic = boundaryMode == PERIODIC;
+    const float width    = periodic ? bounds.width() : std::numeric_limits<float>::infinity();
+    const float height   = periodic ? bounds.height() : std::numeric_limits<float>::infinity();
+
+    const std::size_t n = std::min(state.size(), parent_.size());
+    clusters.step       = step;
+    clusters.clusters.clear();
+    slot_.assign(n, NO_SLOT);
+    sums_.clear();
+    // Every BOID could be a cluster of its own, so reserving for that means the vectors stop
+    // growing once the flock does, however the flock splits up.
+    clusters.clusters.reserve(n);
+    sums_.reserve(4 * n);
+
+    // Every cluster is rooted at its first slot, so it is given a place in the cluster vector when
+    // the root is reached, before any of the other BOIDs in it.
+    for (std::size_t k = 0; k < n; ++k) {
+        if (packed.type[k] != BoidType::BOID)
+            continue;
+        const uint32_t root = find(uint32_t(k));
+        if (slot_[root] == NO_SLOT) {
+            slot_[root] = uint32_t(clusters.clusters.size());
+            clusters.clusters.emplace_back();
+            clusters.clusters.back().root = std::size_t(packed.index[root]);
+            sums_.insert(sums_.end(), 4, 0.0);
+        }
+
+        const uint32_t c    = slot_[root];
+        double*        sums = &sums_[4 * c];
+        clusters.clusters[c].size++;
+        sums[0] += boundary::wrapDisplacement(packed.x[k] - packed.x[root], width);
+        sums[1] += boundary::wrapDisplacement(packed.y[k] - packed.y[root], height);
+        sums[2] += state.vx[packed.index[k]];
+        sums[3] += state.vy[packed.index[k]];
+    }
+
+    for (std::size_t c = 0; c < clusters.clusters.size(); ++c) {
+        Cluster&      cluster = clusters.clusters[c];
+        const double* sums    = &sums_[4 * c];
+        const double  size    = double(cluster.size);
+
+        cluster.x  = state.x[cluster.root] + float(sums[0] / size);
+        cluster.y  = state.y[cluster.root] + float(sums[1] / size);
+        cluster.vx = float(sums[2] / size);
+        cluster.vy = float(sums[3] / size);
+        if (periodic) {
+            cluster.x = utils::wrapValue(cluster.x, bounds.left(), bounds.right());
+            cluster.y = utils::wrapValue(cluster.y, bounds.top(), bounds.bottom());
+        }
+    }
+
+    std::sort(clusters.clusters.begin(), clusters.clusters.end(),
+              [](const Cluster& a, const Cluster& b) {
+                  return a.size != b.size ? a.size > b.size : a.root < b.root;
+              });
+}
+
+}; // namespace boids
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "boundary.h"
+#include "flock_state.h"
+#include "kernel.h"
+#include "neighbour_lists.h"
+#include "spatial_grid.h"
+#include "types.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace boids {
+
+/**
+ * @brief The Cluster struct describes a single sub-flock, i.e. a set of BOIDs that are connected
+ * through a chain of neighbours, each within the neighbourhood radius of the next.
+ */
+struct Cluster {
+    std::size_t root = 0; ///< Index in the flock state of the first BOID in grid order.
+    std::size_t size = 0; ///< Number of BOIDs in the cluster.
+
+    /**
+     * Centroid. In a periodic scene this is wrapped into the scene, and each BOID is taken at its
+     * shortest displacement from the root, so it is only meaningful for clusters smaller than half
+     * the scene.
+     */
+    float x = 0.0f;
+    float y = 0.0f;
+
+    float vx = 0.0f; ///< Mean velocity.
+    float vy = 0.0f;
+};
+
+/**
+ * @brief The FlockClusters struct holds the clusters of the BOIDs in the flock at a single step.
+ */
+struct FlockClusters {
+    uint64_t             step = 0; ///< Index of the step, counted since the flock was seeded.
+    std::vector<Cluster> clusters; ///< Clusters, largest first. Lone BOIDs are clusters of one.
+};
+
+/**
+ * @brief The ClusterFinder class finds the clusters of a flock with a lock-free union-find over
+ * the slots of a spatial grid, which any number of threads can add the neighbour pairs of their
+ * share of the slots to at once.
+ *
+ * The sets are kept by slot rather than by boid index, so that the boids in the same and
+ * neighbouring cells, which are the ones that get joined, are next to each other in memory. Each
+ * union links the root with the larger slot under the one with the smaller slot, with a single
+ * compare and swap that is retried if another thread got there first. So every cluster ends up
+ * rooted at its first slot, whatever order the pairs are added in, and the clusters come out the
+ * same for any number of threads.
+ */
+class ClusterFinder {
+  public:
+    /**
+     * @brief Start a new search, with every slot in a set of its own. This must not be called
+     * while pairs are being added.
+     * @param numSlots Number of slots in the grid, i.e. the number of boids.
+     */
+    void reset(const std::size_t& numSlots);
+
+    /**
+     * @brief Join the sets of each BOID in a range of slots with the BOIDs within a radius of it.
+     * This can be called from several threads at once, for different ranges.
+     * @param packed Flock state packed in the slot order of the grid.
+     * @param grid Spatial grid with cells at least as large as the radius.
+     * @param radius Neighbourhood radius.
+     * @param bounds Bounds of the scene.
+     * @param begin First slot.
+     * @param end Slot one past the last.
+     * @param boundaryMode Boundary of the scene, which decides whether pairs are found across its
+     * edges.
+     */
+    void link(const kernel::PackedNeighbours& packed, const SpatialGrid& grid, const float& radius,
+              const Rect& bounds, const std::size_t& begin, const std::size_t& end,
+              const BoundaryMode& boundaryMode = PERIODIC);
+
+    /**
+     * @brief Join the sets of each BOID in a range of slots with the BOIDs within a radius of it,
+     * taking the candidates from neighbour lists rather than from the grid. This can be called
+     * from several threads at once, for different ranges.
+     * @param packed Flock state packed in the slot order that the lists were built for.
+     * @param lists Neighbour lists that are still valid for the radius, see NeighbourLists.
+     * @param radius Neighbourhood radius.
+     * @param bounds Bounds of the scene.
+     * @param begin First slot.
+     * @param end Slot one past the last.
+     * @param boundaryMode Boundary of the scene, which decides whether pairs are found across its
+     * edges.
+     */
+    void link(const kernel::PackedNeighbours& packed, const NeighbourLists& lists,
+              const float& radius, const Rect& bounds, const std::size_t& begin,
+              const std::size_t& end, const BoundaryMode& boundaryMode = PERIODIC);
+
+    /**
+     * @brief Join the sets of two slots.
+     * @param a First slot.
+     * @param b Second slot.
+     */
+    void unite(uint32_t a, uint32_t b);
+
+    /**
+     * @brief Find the root of the set that a slot belongs to, halving the path to it on the way.
+     * @param i Slot.
+     * @return Root slot.
+     */
+    uint32_t find(uint32_t i);
+
+    /**
+     * @brief Summarise the clusters once all the pairs have been added. The cluster vector is
+     * assigned to rather than replaced, so it doesn't allocate once it has grown.
+     * @param state Flock state the grid was built from.
+     * @param packed Flock state packed in the slot order of the grid.
+     * @param bounds Bounds of the scene.
+     * @param step Index of the step.
+     * @param clusters Clusters to write to.
+     * @param boundaryMode Boundary of the scene, which decides whether the centroids are wrapped.
+     */
+    void collect(const FlockState& state, const kernel::PackedNeighbours& packed,
+                 const Rect& bounds, const uint64_t& step, FlockClusters& clusters,
+                 const BoundaryMode& boundaryMode = PERIODIC);
+
+  private:
+    /**
+     * @brief Implement link() for a boundary policy from boundary.h.
+     */
+    template <typename Policy>
+    void linkRange(const kernel::PackedNeighbours& packed, const SpatialGrid& grid,
+                   const float& radius, const Rect& bounds, const std::size_t& begin,
+                   const std::size_t& end);
+
+    /**
+     * @brief Implement the neighbour list overload of link() for a boundary policy.
+     */
+    template <typename Policy>
+    void linkRange(const kernel::PackedNeighbours& packed, const NeighbourLists& lists,
+                   const float& radius, const Rect& bounds, const std::size_t& begin,
+                   const std::size_t& end);
+
+    /**
+     * @brief Get atomic access to the parent of a slot.
+     * @param i Slot.
+     * @return Atomic reference to the parent.
+     */
+    std::atomic_ref<uint32_t> parentOf(const uint32_t& i);
+
+    std::vector<uint32_t> parent_; ///< Parent of each slot, updated through std::atomic_ref.
+    std::vector<uint32_t> slot_;   ///< Index into the cluster vector of each root, when collecting.
+    std::vector<double>   sums_;   ///< Offset and velocity sums of each cluster, when collecting.
+};
+
+}; // namespace boids
@@ -0,0 +1,69 @@
+#include "flock_metrics.h"
+#include <cmath>
+#include <numbers>
+
+namespace boids {
+
+void MetricSums::add(const float px, const float py, const float pvx, const float pvy,
+                     const std::size_t count, const float nearestSq) {
+    const double speed = std::sqrt(double(pvx) * pvx + double(pvy) * pvy);
+    if (speed > 0.0) {
+        headingX += pvx / speed;
+        headingY += pvy / speed;
+    }
+    x += px;
+    y += py;
+    vx += pvx;
+    vy += pvy;
+    momentum += double(px) * pvy - double(py) * pvx;
+    if (std::isfinite(nearestSq)) {
+        nearest += std::sqrt(double(nearestSq));
+        numNearest++;
+    }
+    neighbours += count;
+    numBoids++;
+}
+
+FlockMetrics reduceMetrics(std::span<const MetricSums> sums, const uint64_t& step,
+                           const double& sceneArea, const double& radius) {
+    MetricSums total;
+    for (const MetricSums& s : sums) {
+        total.headingX += s.headingX;
+        total.headingY += s.headingY;
+        total.x += s.x;
+        total.y += s.y;
+        total.vx += s.vx;
+        total.vy += s.vy;
+        total.momentum += s.momentum;
+        total.nearest += s.nearest;
+        total.numBoids += s.numBoids;
+        total.numNearest += s.numNearest;
+        total.neighbours += s.neighbours;
+    }
+
+    FlockMetrics m;
+    m.step     = step;
+    m.numBoids = total.numBoids;
+    if (total.numBoids == 0)
+        return m;
+
+    const double n       = double(total.numBoids);
+    const double heading = std::hypot(total.headingX, total.headingY);
+    m.polarisation       = heading / n;
+    if (total.numNearest > 0)
+        m.meanNearestDistance = total.nearest / double(total.numNearest);
+
+    // The momentum about the centroid c is sum((r - c) x v) = sum(r x v) - c x sum(v), so it can be
+    // reduced in the same pass as the centroid itself.
+    const double cx   = total.x / n;
+    const double cy   = total.y / n;
+    m.angularMomentum = (total.momentum - (cx * total.vy - cy * total.vx)) / n;
+
+    if (sceneArea > 0.0)
+        m.density = n / sceneArea;
+    if (radius > 0.0)
+        m.localDensity = double(total.neighbours) / n / (std::numbers::pi * radius * radius);
+    return m;
+}
+
+}; // namespace boids
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace boids {
+
+/**
+ * @brief The FlockMetrics struct holds the collective behaviour of the BOIDs in the flock (i.e.,
+ * not counting the obstacles or predators) at a single step.
+ *
+ * The metrics are reduced inside the neighbour pass of Flock::update(), from the state that the
+ * step reads, so they describe the flock as it was at the start of the step. With
+ * UpdateMode::IN_PLACE, boids later in the step see the already updated state of earlier ones, so
+ * the neighbour based metrics are slightly skewed in the same way as the update itself.
+ */
+struct FlockMetrics {
+    uint64_t step     = 0; ///< Index of the step, counted since the flock was seeded.
+    uint64_t numBoids = 0; ///< Number of BOIDs the metrics are taken over.
+
+    /**
+     * Order parameter: the length of the mean unit heading, from 0 when the headings cancel out to
+     * 1 when every boid is heading the same way.
+     */
+    double polarisation = 0.0;
+
+    /**
+     * Mean distance to the nearest BOID neighbour, over the boids that have at least one
+     * neighbour within their neighbourhood radius. Zero if none of them do.
+     */
+    double meanNearestDistance = 0.0;
+
+    /**
+     * Mean angular momentum (the Z component of r x v) about the centroid of the boids, per boid.
+     * This is positive for an anti-clockwise mill in scene coordinates. The positions are taken as
+     * they are, without unwrapping them across the edges of the scene.
+     */
+    double angularMomentum = 0.0;
+
+    double density      = 0.0; ///< Boids per unit area of the scene.
+    double localDensity = 0.0; ///< Mean BOID neighbours per unit area of the neighbourhood.
+};
+
+/**
+ * @brief The MetricSums struct holds the sums that a single thread accumulates over its share of
+ * the boids, from which the FlockMetrics are calculated. It fills whole cache lines, so that the
+ * threads don't write to the same line.
+ */
+struct alignas(64) MetricSums {
+    double   headingX   = 0.0; ///< Sum of the unit headings.
+    double   headingY   = 0.0;
+    double   x          = 0.0; ///< Sum of the positions.
+    double   y          = 0.0;
+    double   vx         = 0.0; ///< Sum of the velocities.
+    double   vy         = 0.0;
+    double   momentum   = 0.0; ///< Sum of the Z component of r x v, about the origin.
+    double   nearest    = 0.0; ///< Sum of the distances to the nearest neighbour.
+    uint64_t numBoids   = 0;
+    uint64_t numNearest = 0; ///< Number of boids with a nearest neighbour.
+    uint64_t neighbours = 0; ///< Sum of the BOID neighbour counts.
+
+    /**
+     * @brief Add a boid to the sums.
+     * @param px X position.
+     * @param py Y position.
+     * @param pvx X velocity.
+     * @param pvy Y velocity.
+     * @param count Number of BOID neighbours.
+     * @param nearestSq Squared distance to the nearest BOID neighbour, or infinity if there are
+     * none.
+     */
+    void add(const float px, const float py, const float pvx, const float pvy,
+             const std::size_t count, const float nearestSq);
+};
+
+/**
+ * @brief Reduce the sums of each thread into the metrics of the flock.
+ * @param sums Sums of each thread.
+ * @param step Index of the step.
+ * @param sceneArea Area of the scene.
+ * @param radius Neighbourhood radius of the BOIDs.
+ * @return Metrics of the flock.
+ */
+FlockMetrics reduceMetrics(std::span<const MetricSums> sums, const uint64_t& step,
+                           const double& sceneArea, const double& radius);
+
+}; // namespace boids
@@ -0,0 +1,186 @@
+#include "flock_state.h"
+#include <algorithm>
+#include <math.h>
+
+namespace boids {
+
+/**
+ * @brief Remove the elements of a vector that are flagged for removal, preserving the order of
+ * the remaining elements.
+ * @param vec Vector to compact.
+ * @param remove Flags, one per element, of the elements to remove.
+ */
+template <typename T> void compact(AlignedVector<T>& vec, const std::vector<bool>& remove) {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < vec.size(); ++i) {
+        if (!remove[i])
+            vec[n++] = vec[i];
+    }
+    vec.resize(n);
+}
+
+/**
+ * @brief Move the last element of a vector into a given index, and drop the last element.
+ * @param vec Vector.
+ * @param i Index to move the last element into.
+ */
+template <typename T> void swapRemoveElement(AlignedVector<T>& vec, const std::size_t& i) {
+    vec[i] = vec.back();
+    vec.pop_back();
+}
+
+void FlockState::push(const Boid& boid) {
+    const Vec2&  p = boid.getPosition();
+    const Vec2&  v = boid.getVelocity();
+    const Color& c = boid.getColor();
+
+    x.push_back(p.x());
+    y.push_back(p.y());
+    vx.push_back(v.x());
+    vy.push_back(v.y());
+    hue.push_back(std::max(0, c.hsvHue()));
+    saturation.push_back(c.saturation());
+    value.push_back(c.value());
+    id.push_back(boid.getId());
+    type.push_back(boid.getType());
+}
+
+void FlockState::clear() {
+    x.clear();
+    y.clear();
+    vx.clear();
+    vy.clear();
+    hue.clear();
+    saturation.clear();
+    value.clear();
+    id.clear();
+    type.clear();
+}
+
+void FlockState::clear(const BoidType& t) {
+    std::vector<bool> remove(size());
+    for (std::size_t i = 0; i < size(); ++i) {
+        remove[i] = (type[i] == t);
+    }
+
+    compact(x, remove);
+    compact(y, remove);
+    compact(vx, remove);
+    compact(vy, remove);
+    compact(hue, remove);
+    compact(saturation, remove);
+    compact(value, remove);
+    compact(id, remove);
+    compact(type, remove);
+}
+
+void FlockState::swapRemove(const std::size_t& i) {
+    swapRemoveElement(x, i);
+    swapRemoveElement(y, i);
+    swapRemoveElement(vx, i);
+    swapRemoveElement(vy, i);
+    swapRemoveElement(hue, i);
+    swapRemoveElement(saturation, i);
+    swapRemoveElement(value, i);
+    swapRemoveElement(id, i);
+    swapRemoveElement(type, i);
+}
+
+void FlockState::reserve(const std::size_t& n) {
+    x.reserve(n);
+    y.reserve(n);
+    vx.reserve(n);
+    vy.reserve(n);
+    hue.reserve(n);
+    saturation.reserve(n);
+    value.reserve(n);
+    id.reserve(n);
+    type.reserve(n);
+}
+
+void FlockState::resize(const std::size_t& n) {
+    x.resize(n);
+    y.resize(n);
+    vx.resize(n);
+    vy.resize(n);
+    hue.resize(n);
+    saturation.resize(n);
+    value.resize(n);
+    id.resize(n);
+    type.resize(n);
+}
+
+std::size_t FlockState::size() const { return x.size(); }
+
+BoidView FlockState::view(const std::size_t& i) { return BoidView(this, i); }
+
+ConstBoidView FlockState::view(const std::size_t& i) const { return ConstBoidView(this, i); }
+
+template <typename State>
+BasicBoidView<State>::BasicBoidView(State* state, const std::size_t& index)
+    : state_(state), index_(index) {}
+
+template <typename State> float BasicBoidView<State>::getAngle() const {
+    return std::atan2(state_->vy[index_], state_->vx[index_]);
+}
+
+template <typename State> Color BasicBoidView<State>::getColor() const {
+    Color c;
+    c.setHsv(int(state_->hue[index_]), state_->saturation[index_], state_->value[index_]);
+    return c;
+}
+
+template <typename State> BoidId BasicBoidView<State>::getId() const {
+    return state_->id[index_];
+}
+
+template <typename State> Vec2 BasicBoidView<State>::getPosition() const {
+    return Vec2(state_->x[index_], state_->y[index_]);
+}
+
+template <typename State> BoidType BasicBoidView<State>::getType() const {
+    return state_->type[index_];
+}
+
+template <typename State> Vec2 BasicBoidView<State>::getVelocity() const {
+    return Vec2(state_->vx[index_], state_->vy[index_]);
+}
+
+template <typename State>
+void BasicBoidView<State>::setColor(const Color& color)
+    requires(!std::is_const_v<State>)
+{
+    state_->hue[index_]        = std::max(0, color.hsvHue());
+    state_->saturation[index_] = color.saturation();
+    state_->value[index_]      = color.value();
+}
+
+template <typename State>
+void BasicBoidView<State>::setPosition(const Vec2& pos)
+    requires(!std::is_const_v<State>)
+{
+    state_->x[index_] = pos.x();
+    state_->y[index_] = pos.y();
+}
+
+template <typename State>
+void BasicBoidView<State>::setVelocity(const Vec2& vel)
+    requires(!std::is_const_v<State>)
+{
+    state_->vx[index_] = vel.x();
+    state_->vy[index_] = vel.y();
+}
+
+template <typename State> Boid BasicBoidView<State>::toBoid() const {
+    Boid b(getId(), state_->x[index_], state_->y[index_], state_->vx[index_], state_->vy[index_],
+           getType());
+    b.setColor(getColor());
+    return b;
+}
+
+// The only two kinds of view, so the members are defined here rather than in the header. The
+// setters are left out of the read-only one, as their constraints aren't met.
+template class BasicBoidView<FlockState>;
+template class BasicBoidView<const FlockState>;
+
+}; // namespace boids
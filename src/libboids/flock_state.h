@@ -0,0 +1,190 @@
+#pragma once
+
+#include "aligned_allocator.h"
+#include "boids.h"
+#include "types.h"
+#include <cstdint>
+#include <type_traits>
+
+namespace boids {
+
+class FlockState;
+template <typename State> class BasicBoidView;
+
+/**
+ * @brief View onto a boid that can read and modify it.
+ */
+using BoidView = BasicBoidView<FlockState>;
+
+/**
+ * @brief View onto a boid that can only read it.
+ */
+using ConstBoidView = BasicBoidView<const FlockState>;
+
+/**
+ * @brief The FlockState class stores all the boids of a Flock as a structure of arrays.
+ *
+ * The data used every step (position, velocity and hue) is kept in tightly packed float arrays,
+ * while the data that is rarely touched (ID, type, saturation and value) lives in separate arrays.
+ * Boids of all types share the same arrays. New boids are added at the end, and removing a single
+ * boid moves the last boid into its place, so the order of the boids is not otherwise meaningful.
+ * Every array starts on a cache line, so that the threads splitting the arrays between them and
+ * the vector kernels reading them don't straddle lines at the start.
+ */
+class FlockState {
+  public:
+    AlignedVector<float>    x;          ///< X position.
+    AlignedVector<float>    y;          ///< Y position.
+    AlignedVector<float>    vx;         ///< X velocity.
+    AlignedVector<float>    vy;         ///< Y velocity.
+    AlignedVector<float>    hue;        ///< HSV hue, in the range [0, 359].
+    AlignedVector<uint8_t>  saturation; ///< HSV saturation.
+    AlignedVector<uint8_t>  value;      ///< HSV value.
+    AlignedVector<BoidId>   id;         ///< Boid ID.
+    AlignedVector<BoidType> type;       ///< Boid type.
+
+    /**
+     * @brief Add a Boid to the end of the state.
+     * @param boid Boid to add.
+     */
+    void push(const Boid& boid);
+
+    /**
+     * @brief Remove all the boids.
+     */
+    void clear();
+
+    /**
+     * @brief Remove all the boids of a given type, preserving the order of the remaining boids.
+     * @param t Type of boids to remove.
+     */
+    void clear(const BoidType& t);
+
+    /**
+     * @brief Remove the boid at a given index in O(1), by moving the last boid into its place.
+     * @param i Index of the boid to remove.
+     */
+    void swapRemove(const std::size_t& i);
+
+    /**
+     * @brief Reserve capacity in all the arrays.
+     * @param n Number of boids to reserve space for.
+     */
+    void reserve(const std::size_t& n);
+
+    /**
+     * @brief Resize all the arrays. New boids are zero-initialised, and must be filled in by the
+     * caller.
+     * @param n Number of boids.
+     */
+    void resize(const std::size_t& n);
+
+    /**
+     * @brief Get the number of boids in the state.
+     * @return Number of boids.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Get a view of a single boid in the state.
+     * @param i Index of the boid.
+     * @return View onto the boid.
+     */
+    BoidView view(const std::size_t& i);
+
+    /**
+     * @brief Get a read-only view of a single boid in the state.
+     * @param i Index of the boid.
+     * @return View onto the boid.
+     */
+    ConstBoidView view(const std::size_t& i) const;
+};
+
+/**
+ * @brief The BasicBoidView class is a lightweight proxy onto a single boid within a FlockState.
+ *
+ * It offers the same accessors as the Boid class, but reads and writes straight through to the
+ * underlying arrays. A view is invalidated when boids are added to or removed from the state.
+ * A ConstBoidView, onto a const FlockState, has no setters, so a copy of it can't be used to
+ * modify the state either.
+ *
+ * @tparam State FlockState, or const FlockState for a read-only view.
+ */
+template <typename State> class BasicBoidView {
+  public:
+    /**
+     * @brief Construct a new BasicBoidView object.
+     * @param state State that the boid belongs to.
+     * @param index Index of the boid within the state.
+     */
+    BasicBoidView(State* state, const std::size_t& index);
+
+    /**
+     * @brief Get the heading angle of the boid, in the range (-PI, PI).
+     * @return Heading angle in radians.
+     */
+    float getAngle() const;
+
+    /**
+     * @brief Get the RGB colour of the Boid
+     * @return Colour
+     */
+    Color getColor() const;
+
+    /**
+     * @brief Get the Boid ID.
+     * @return Boid ID.
+     */
+    BoidId getId() const;
+
+    /**
+     * @brief Get the current position of the Boid.
+     * @return Position in the scene.
+     */
+    Vec2 getPosition() const;
+
+    /**
+     * @brief Get the type of Boid.
+     * @return const BoidType
+     */
+    BoidType getType() const;
+
+    /**
+     * @brief Get the current velocity of the Boid.
+     * @return Velocity in the scene.
+     */
+    Vec2 getVelocity() const;
+
+    /**
+     * @brief Set the Color of the Boid.
+     * @param color New colour to set.
+     */
+    void setColor(const Color& color)
+        requires(!std::is_const_v<State>);
+
+    /**
+     * @brief Set the Position of the Boid.
+     * @param pos Position in the format (x, y).
+     */
+    void setPosition(const Vec2& pos)
+        requires(!std::is_const_v<State>);
+
+    /**
+     * @brief Set the Velocity of the Boid.
+     * @param vel Velocity in the format (vx, vy).
+     */
+    void setVelocity(const Vec2& vel)
+        requires(!std::is_const_v<State>);
+
+    /**
+     * @brief Copy the boid into a standalone Boid object.
+     * @return Boid object.
+     */
+    Boid toBoid() const;
+
+  private:
+    State*      state_;
+    std::size_t index_;
+};
+
+}; // namespace boids
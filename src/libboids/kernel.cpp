@@ -0,0 +1,487 @@
+#include "kernel.h"
+#include "kernel_simd.h"
+#include "utils.h"
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+#include <stdexcept>
+
+namespace boids {
+namespace kernel {
+
+/**
+ * @brief Detect the widest instruction set supported by the host CPU.
+ * @return Instruction set.
+ */
+InstructionSet detectInstructionSet() {
+    for (const InstructionSet isa : {AVX512, AVX2, SSE}) {
+        if (isSupported(isa))
+            return isa;
+    }
+    return SCALAR;
+}
+
+/**
+ * @brief Get the instruction set currently selected for the packed kernel.
+ * @return Reference to the selected instruction set.
+ */
+std::atomic<InstructionSet>& selectedInstructionSet() {
+    static std::atomic<InstructionSet> isa(detectInstructionSet());
+    return isa;
+}
+
+bool isSupported(const InstructionSet& isa) {
+    switch (isa) {
+        case SCALAR:
+            return true;
+#ifdef BOIDS_KERNEL_X86
+        case SSE:
+            return __builtin_cpu_supports("sse4.1");
+        case AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+InstructionSet getInstructionSet() { return selectedInstructionSet(); }
+
+void setInstructionSet(const InstructionSet& isa) {
+    if (!isSupported(isa))
+        throw std::invalid_argument("The instruction set is not supported on this host");
+    selectedInstructionSet() = isa;
+}
+
+/**
+ * @brief Resize an array of the packed state, growing it with some headroom, and fill the padding
+ * at its end with a value. The number of ghost slots changes from step to step, so without the
+ * headroom the arrays would be reallocated whenever it reached a new high.
+ * @param values Array to resize.
+ * @param size New size of the array.
+ * @param padding Index of the first padding element.
+ * @param value Value to fill the padding with.
+ */
+template <typename T>
+static void resizeWithHeadroom(AlignedVector<T>& values, const std::size_t& size,
+                               const std::size_t& padding, const T& value) {
+    if (values.capacity() < size)
+        values.reserve(size + size / 4);
+    values.resize(size);
+    std::fill(values.begin() + padding, values.end(), value);
+}
+
+void PackedNeighbours::pack(const FlockState& state, const SpatialGrid& grid) {
+    resize(grid);
+    packSlots(state, grid, 0, grid.getEntries().size());
+    packHalo(grid);
+}
+
+void PackedNeighbours::resize(const SpatialGrid& grid) {
+    const std::size_t padding = grid.getEntries().size() + grid.getNumGhosts();
+    const std::size_t padded  = padding + detail::PACK_PADDING;
+
+    resizeWithHeadroom(x, padded, padding, 0.0f);
+    resizeWithHeadroom(y, padded, padding, 0.0f);
+    resizeWithHeadroom(nvx, padded, padding, 0.0f);
+    resizeWithHeadroom(nvy, padded, padding, 0.0f);
+    resizeWithHeadroom(hue, padded, padding, 0.0f);
+    resizeWithHeadroom<int32_t>(type, padded, padding, BoidType::OBSTACLE);
+    resizeWithHeadroom<int32_t>(index, padded, padding, -1);
+    halo = grid.hasHalo();
+}
+
+void PackedNeighbours::packSlots(const FlockState& state, const SpatialGrid& grid,
+                                 const std::size_t& begin, const std::size_t& end) {
+    const std::vector<std::size_t>& entries = grid.getEntries();
+    for (std::size_t k = begin; k < end; ++k) {
+        const std::size_t i         = entries[k];
+        const Vec2        pos       = Vec2(state.x[i], state.y[i]);
+        const Vec2        packedPos = halo ? grid.getHaloPosition(pos) : pos;
+        x[k]                        = packedPos.x();
+        y[k]                        = packedPos.y();
+        hue[k]                      = state.hue[i];
+        type[k]                     = state.type[i];
+        index[k]                    = int32_t(i);
+
+        const float speed = std::sqrt(state.vx[i] * state.vx[i] + state.vy[i] * state.vy[i]);
+        nvx[k]            = speed > 0.0f ? state.vx[i] / speed : 0.0f;
+        nvy[k]            = speed > 0.0f ? state.vy[i] / speed : 0.0f;
+    }
+}
+
+void PackedNeighbours::packHalo(const SpatialGrid& grid) {
+    const std::size_t n = grid.getEntries().size();
+
+    // Each ghost copies a slot packed above, moved across the scene.
+    grid.forEachHaloCell([&](const std::size_t& ghost, const std::size_t& source,
+                             const std::size_t& count, const float& dx, const float& dy) {
+        for (std::size_t s = 0; s < count; ++s) {
+            const std::size_t k = n + ghost + s;
+            const std::size_t j = source + s;
+            x[k]                = x[j] + dx;
+            y[k]                = y[j] + dy;
+            nvx[k]              = nvx[j];
+            nvy[k]              = nvy[j];
+            hue[k]              = hue[j];
+            type[k]             = type[j];
+            index[k]            = index[j];
+        }
+    });
+}
+
+template <typename Policy>
+NeighbourhoodSums accumulateNeighbourhood(const FlockState& state, const std::size_t& i,
+                                          const SpatialGrid& grid, const Config& cfg,
+                                          const Rect& bounds) {
+    const float left   = bounds.left();
+    const float right  = bounds.right();
+    const float top    = bounds.top();
+    const float bottom = bounds.bottom();
+
+    const float px  = state.x[i];
+    const float py  = state.y[i];
+    const float hue = state.hue[i];
+
+    const float radiusSq   = cfg.neighbourhoodRadius * cfg.neighbourhoodRadius;
+    const float repelSq    = cfg.repelMinDist * cfg.repelMinDist;
+    const float predatorSq = 25.0f * repelSq;
+
+    NeighbourhoodSums sums;
+    grid.forEachCandidate(Vec2(px, py), [&](const std::size_t& n) {
+        if (n == i)
+            return;
+#ifdef BOIDS_STEP_STATS
+        sums.tested++;
+#endif
+
+        // Displacement from the boid to the neighbour.
+        float dx = state.x[n] - px;
+        float dy = state.y[n] - py;
+        if constexpr (Policy::WRAPS) {
+            dx = utils::shortestDistanceInWrapedSpace(px, state.x[n], left, right);
+            dy = utils::shortestDistanceInWrapedSpace(py, state.y[n], top, bottom);
+        }
+        const float distSq = dx * dx + dy * dy;
+        if (distSq > radiusSq)
+            return;
+
+        const float dist    = std::sqrt(distSq);
+        const float invDist = dist > 0.0f ? 1.0f / dist : 0.0f;
+
+        // Separation pushes the boid away from the neighbour, or along the X axis if they are at
+        // the same position.
+        const float awayX = dist > 0.0f ? -dx * invDist : 1.0f;
+        const float awayY = dist > 0.0f ? -dy * invDist : 0.0f;
+
+        switch (state.type[n]) {
+            case BoidType::BOID: {
+                sums.count++;
+                sums.nearestSq = std::min(sums.nearestSq, distSq);
+                sums.cohesionX += dx;
+                sums.cohesionY += dy;
+
+                const float vx    = state.vx[n];
+                const float vy    = state.vy[n];
+                const float speed = std::sqrt(vx * vx + vy * vy);
+                if (speed > 0.0f) {
+                    sums.alignX += vx / speed * invDist;
+                    sums.alignY += vy / speed * invDist;
+                }
+
+                sums.hue +=
+                    utils::shortestDistanceInWrapedSpace(state.hue[n], hue, 0.0f, 359.0f) * invDist;
+
+                if (distSq <= repelSq) {
+                    sums.repelX += awayX;
+                    sums.repelY += awayY;
+                }
+                break;
+            }
+            case BoidType::OBSTACLE:
+                if (distSq <= repelSq) {
+                    sums.obstacleX += awayX;
+                    sums.obstacleY += awayY;
+                }
+                break;
+            case BoidType::PREDATOR:
+                if (distSq <= predatorSq) {
+                    sums.predatorX += awayX;
+                    sums.predatorY += awayY;
+                }
+                break;
+        }
+    });
+
+    return sums;
+}
+
+/**
+ * @brief Accumulate the packed neighbours in a set of slot ranges, using the selected instruction
+ * set.
+ */
+template <typename Policy>
+static void accumulateRanges(const PackedNeighbours& packed, const detail::KernelParams& params,
+                             const std::size_t* ranges, const std::size_t& numRanges,
+                             NeighbourhoodSums& sums) {
+    switch (selectedInstructionSet().load(std::memory_order_relaxed)) {
+#ifdef BOIDS_KERNEL_X86
+        case AVX512:
+            detail::accumulateRangesAvx512<Policy>(packed, params, ranges, numRanges, sums);
+            break;
+        case AVX2:
+            detail::accumulateRangesAvx2<Policy>(packed, params, ranges, numRanges, sums);
+            break;
+        case SSE:
+            detail::accumulateRangesSse<Policy>(packed, params, ranges, numRanges, sums);
+            break;
+#endif
+        default:
+            detail::accumulateRangesScalar<Policy>(packed, params, ranges, numRanges, sums);
+            break;
+    }
+}
+
+template <typename Policy>
+NeighbourhoodSums accumulateNeighbourhood(const FlockState& state, const std::size_t& i,
+                                          const SpatialGrid& grid, const PackedNeighbours& packed,
+                                          const Config& cfg, const Rect& bounds) {
+    detail::KernelParams params;
+    params.px         = state.x[i];
+    params.py         = state.y[i];
+    params.hue        = state.hue[i];
+    params.self       = int32_t(i);
+    params.radiusSq   = cfg.neighbourhoodRadius * cfg.neighbourhoodRadius;
+    params.repelSq    = cfg.repelMinDist * cfg.repelMinDist;
+    params.predatorSq = 25.0f * params.repelSq;
+    params.width      = bounds.width();
+    params.height     = bounds.height();
+
+    // With a halo, the boids across the edges of a periodic scene are read from their ghosts,
+    // which are already shifted to the side of the boid, so the displacements are plain
+    // subtractions.
+    const bool halo = Policy::WRAPS && packed.halo;
+    if (halo) {
+        const Vec2 pos = grid.getHaloPosition(Vec2(params.px, params.py));
+        params.px      = pos.x();
+        params.py      = pos.y();
+    }
+
+    std::size_t       ranges[2 * SpatialGrid::MAX_RANGES];
+    const std::size_t numRanges = halo ? grid.getHaloSlotRanges(Vec2(params.px, params.py), ranges)
+                                       : grid.getSlotRanges(Vec2(params.px, params.py), ranges);
+
+    NeighbourhoodSums sums;
+#ifdef BOIDS_STEP_STATS
+    // Every candidate in the ranges is tested, apart from the boid itself.
+    for (std::size_t r = 0; r < numRanges; ++r) {
+        sums.tested += ranges[2 * r + 1] - ranges[2 * r];
+    }
+    sums.tested -= std::min<std::size_t>(sums.tested, 1);
+#endif
+    if (halo) {
+        accumulateRanges<boundary::Unbounded>(packed, params, ranges, numRanges, sums);
+    } else {
+        accumulateRanges<Policy>(packed, params, ranges, numRanges, sums);
+    }
+    return sums;
+}
+
+/**
+ * @brief Accumulate a list of packed slots, using the selected instruction set.
+ */
+template <typename Policy>
+static void accumulateList(const PackedNeighbours& packed, const detail::KernelParams& params,
+                           const std::span<const int32_t>& candidates, NeighbourhoodSums& sums) {
+    const int32_t*    data  = candidates.data();
+    const std::size_t count = candidates.size();
+    switch (selectedInstructionSet().load(std::memory_order_relaxed)) {
+#ifdef BOIDS_KERNEL_X86
+        case AVX512:
+            detail::accumulateListAvx512<Policy>(packed, params, data, count, sums);
+            break;
+        case AVX2:
+            detail::accumulateListAvx2<Policy>(packed, params, data, count, sums);
+            break;
+        case SSE:
+            detail::accumulateListSse<Policy>(packed, params, data, count, sums);
+            break;
+#endif
+        default:
+            detail::accumulateListScalar<Policy>(packed, params, data, count, sums);
+            break;
+    }
+}
+
+template <typename Policy>
+NeighbourhoodSums accumulateNeighbourhood(const FlockState& state, const std::size_t& i,
+                                          const PackedNeighbours& packed,
+                                          const std::span<const int32_t>& candidates,
+                                          const Config& cfg, const Rect& bounds) {
+    detail::KernelParams params;
+    params.px         = state.x[i];
+    params.py         = state.y[i];
+    params.hue        = state.hue[i];
+    params.self       = int32_t(i);
+    params.radiusSq   = cfg.neighbourhoodRadius * cfg.neighbourhoodRadius;
+    params.repelSq    = cfg.repelMinDist * cfg.repelMinDist;
+    params.predatorSq = 25.0f * params.repelSq;
+    params.width      = bounds.width();
+    params.height     = bounds.height();
+
+    NeighbourhoodSums sums;
+#ifdef BOIDS_STEP_STATS
+    sums.tested = candidates.size();
+#endif
+    accumulateList<Policy>(packed, params, candidates, sums);
+    return sums;
+}
+
+/**
+ * @brief Filter a set of slot ranges, using the selected instruction set.
+ */
+template <typename Policy>
+static std::size_t filterRanges(const PackedNeighbours& packed, const detail::KernelParams& params,
+                                const std::size_t* ranges, const std::size_t& numRanges,
+                                int32_t* out) {
+    switch (selectedInstructionSet().load(std::memory_order_relaxed)) {
+#ifdef BOIDS_KERNEL_X86
+        case AVX512:
+            return detail::filterRangesAvx512<Policy>(packed, params, ranges, numRanges, out);
+        case AVX2:
+            return detail::filterRangesAvx2<Policy>(packed, params, ranges, numRanges, out);
+        case SSE:
+            return detail::filterRangesSse<Policy>(packed, params, ranges, numRanges, out);
+#endif
+        default:
+            return detail::filterRangesScalar<Policy>(packed, params, ranges, numRanges, out);
+    }
+}
+
+template <typename Policy>
+std::size_t findSlotsWithin(const PackedNeighbours& packed, const std::size_t& slot,
+                            const float& radius, const Rect& bounds, const std::size_t* ranges,
+                            const std::size_t& numRanges, int32_t* out) {
+    detail::KernelParams params = {};
+    params.px                   = packed.x[slot];
+    params.py                   = packed.y[slot];
+    params.self                 = packed.index[slot];
+    params.radiusSq             = radius * radius;
+    params.width                = bounds.width();
+    params.height               = bounds.height();
+    return filterRanges<Policy>(packed, params, ranges, numRanges, out);
+}
+
+namespace detail {
+
+/**
+ * @brief Accumulate a single packed slot, which is not the boid itself.
+ */
+template <typename Policy>
+static inline void accumulateSlot(const PackedNeighbours& packed, const KernelParams& params,
+                                  const std::size_t& k, NeighbourhoodSums& sums) {
+    const float dx     = Policy::displacement(packed.x[k] - params.px, params.width);
+    const float dy     = Policy::displacement(packed.y[k] - params.py, params.height);
+    const float distSq = dx * dx + dy * dy;
+    if (distSq > params.radiusSq)
+        return;
+
+    const float dist    = std::sqrt(distSq);
+    const float invDist = dist > 0.0f ? 1.0f / dist : 0.0f;
+    const float awayX   = dist > 0.0f ? -dx * invDist : 1.0f;
+    const float awayY   = dist > 0.0f ? -dy * invDist : 0.0f;
+
+    switch (packed.type[k]) {
+        case BoidType::BOID:
+            sums.count++;
+            sums.nearestSq = std::min(sums.nearestSq, distSq);
+            sums.cohesionX += dx;
+            sums.cohesionY += dy;
+            sums.alignX += packed.nvx[k] * invDist;
+            sums.alignY += packed.nvy[k] * invDist;
+            sums.hue += wrapDisplacement(params.hue - packed.hue[k], 359.0f) * invDist;
+            if (distSq <= params.repelSq) {
+                sums.repelX += awayX;
+                sums.repelY += awayY;
+            }
+            break;
+        case BoidType::OBSTACLE:
+            if (distSq <= params.repelSq) {
+                sums.obstacleX += awayX;
+                sums.obstacleY += awayY;
+            }
+            break;
+        case BoidType::PREDATOR:
+            if (distSq <= params.predatorSq) {
+                sums.predatorX += awayX;
+                sums.predatorY += awayY;
+            }
+            break;
+    }
+}
+
+template <typename Policy>
+void accumulateRangesScalar(const PackedNeighbours& packed, const KernelParams& params,
+                            const std::size_t* ranges, const std::size_t numRanges,
+                            NeighbourhoodSums& sums) {
+    for (std::size_t r = 0; r < numRanges; ++r) {
+        for (std::size_t k = ranges[2 * r]; k < ranges[2 * r + 1]; ++k) {
+            if (packed.index[k] != params.self)
+                accumulateSlot<Policy>(packed, params, k, sums);
+        }
+    }
+}
+
+template <typename Policy>
+void accumulateListScalar(const PackedNeighbours& packed, const KernelParams& params,
+                          const int32_t* candidates, const std::size_t count,
+                          NeighbourhoodSums& sums) {
+    for (std::size_t c = 0; c < count; ++c) {
+        accumulateSlot<Policy>(packed, params, std::size_t(candidates[c]), sums);
+    }
+}
+
+template <typename Policy>
+std::size_t filterRangesScalar(const PackedNeighbours& packed, const KernelParams& params,
+                               const std::size_t* ranges, const std::size_t numRanges,
+                               int32_t* out) {
+    // Every slot is written, but the count only moves past the ones that pass, so the loop has no
+    // branch to mispredict.
+    std::size_t count = 0;
+    for (std::size_t r = 0; r < numRanges; ++r) {
+        for (std::size_t k = ranges[2 * r]; k < ranges[2 * r + 1]; ++k) {
+            const float dx = Policy::displacement(packed.x[k] - params.px, params.width);
+            const float dy = Policy::displacement(packed.y[k] - params.py, params.height);
+            out[count]     = int32_t(k);
+            count += std::size_t((packed.index[k] != params.self) &
+                                 (dx * dx + dy * dy <= params.radiusSq));
+        }
+    }
+    return count;
+}
+
+} // namespace detail
+
+// Every kernel is instantiated for every boundary policy.
+#define BOIDS_INSTANTIATE_KERNELS(Policy)                                                          \
+    template NeighbourhoodSums accumulateNeighbourhood<Policy>(                                    \
+        const FlockState&, const std::size_t&, const SpatialGrid&, const Config&, const Rect&);    \
+    template NeighbourhoodSums accumulateNeighbourhood<Policy>(                                    \
+        const FlockState&, const std::size_t&, const SpatialGrid&, const PackedNeighbours&,        \
+        const Config&, const Rect&);                                                               \
+    template NeighbourhoodSums accumulateNeighbourhood<Policy>(                                    \
+        const FlockState&, const std::size_t&, const PackedNeighbours&,                            \
+        const std::span<const int32_t>&, const Config&, const Rect&);                              \
+    template std::size_t findSlotsWithin<Policy>(const PackedNeighbours&, const std::size_t&,      \
+                                                 const float&, const Rect&, const std::size_t*,    \
+                                                 const std::size_t&, int32_t*);
+
+BOIDS_INSTANTIATE_KERNELS(boundary::Periodic)
+BOIDS_INSTANTIATE_KERNELS(boundary::Reflecting)
+BOIDS_INSTANTIATE_KERNELS(boundary::Unbounded)
+#undef BOIDS_INSTANTIATE_KERNELS
+
+} // namespace kernel
+} // namespace boids
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "aligned_allocator.h"
+#include "boundary.h"
+#include "config.h"
+#include "flock_state.h"
+#include "spatial_grid.h"
+#include "types.h"
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace boids {
+namespace kernel {
+
+/**
+ * @brief The instruction sets that the packed neighbourhood kernel has been implemented for:
+ * - SCALAR is plain C++, processing one candidate at a time. This is available on every host.
+ * - SSE uses SSE4.1, processing 4 candidates at a time.
+ * - AVX2 processes 8 candidates at a time.
+ * - AVX512 uses AVX-512F, processing 16 candidates at a time.
+ */
+enum InstructionSet { SCALAR, SSE, AVX2, AVX512 };
+
+/**
+ * @brief The sums accumulated over the neighbourhood of a single boid, from which the steering
+ * vectors and the new hue are calculated.
+ */
+struct NeighbourhoodSums {
+    std::size_t count     = 0;    ///< Number of BOID neighbours.
+    float       alignX    = 0.0f; ///< Sum of the neighbour headings, weighted by inverse distance.
+    float       alignY    = 0.0f;
+    float       cohesionX = 0.0f; ///< Sum of the displacements to the neighbours.
+    float       cohesionY = 0.0f;
+    float       repelX    = 0.0f; ///< Separation from the BOID neighbours.
+    float       repelY    = 0.0f;
+    float       obstacleX = 0.0f; ///< Separation from the OBSTACLE neighbours.
+    float       obstacleY = 0.0f;
+    float       predatorX = 0.0f; ///< Separation from the PREDATOR neighbours.
+    float       predatorY = 0.0f;
+    float       hue       = 0.0f; ///< Sum of the hue differences, weighted by inverse distance.
+    std::size_t tested    = 0;    ///< Candidates tested, only counted with BOIDS_STEP_STATS.
+
+    // Squared distance to the nearest BOID neighbour, or infinity if there are none.
+    float nearestSq = std::numeric_limits<float>::infinity();
+};
+
+/**
+ * @brief The PackedNeighbours class holds a copy of the flock state in the slot order of a
+ * SpatialGrid, so that the candidates of each cell are contiguous in memory and can be streamed
+ * through with SIMD instructions.
+ *
+ * The arrays start on a cache line, and are padded at the end so that a full vector can always be
+ * loaded from the last slot.
+ *
+ * If the grid has a halo (see SpatialGrid::buildHalo()), the ghost slots follow the slots of the
+ * grid, with their positions shifted across the scene and the index of the boid they copy.
+ */
+class PackedNeighbours {
+  public:
+    AlignedVector<float>   x;     ///< X position.
+    AlignedVector<float>   y;     ///< Y position.
+    AlignedVector<float>   nvx;   ///< X component of the unit heading (zero if not moving).
+    AlignedVector<float>   nvy;   ///< Y component of the unit heading (zero if not moving).
+    AlignedVector<float>   hue;   ///< HSV hue.
+    AlignedVector<int32_t> type;  ///< Boid type.
+    AlignedVector<int32_t> index; ///< Index of the boid in the flock state.
+
+    bool halo = false; ///< True if the ghost slots of a halo were packed after the grid slots.
+
+    /**
+     * @brief Copy the flock state into the slot order of the grid, followed by the ghost slots if
+     * the grid has a halo. This is the same as calling resize(), packSlots() over every slot and
+     * packHalo() in turn.
+     * @param state Flock state to copy.
+     * @param grid Spatial grid built from the flock state.
+     */
+    void pack(const FlockState& state, const SpatialGrid& grid);
+
+    /**
+     * @brief Size the arrays for the slots and ghost slots of a grid, and fill in the padding after
+     * them. The slots themselves are left to packSlots() and packHalo().
+     * @param grid Spatial grid built from the flock state.
+     */
+    void resize(const SpatialGrid& grid);
+
+    /**
+     * @brief Copy the flock state into a range of the slots of the grid. This can be called from
+     * several threads at once, for different ranges, once resize() has been called.
+     * @param state Flock state to copy.
+     * @param grid Spatial grid passed to resize().
+     * @param begin First slot.
+     * @param end Slot one past the last.
+     */
+    void packSlots(const FlockState& state, const SpatialGrid& grid, const std::size_t& begin,
+                   const std::size_t& end);
+
+    /**
+     * @brief Copy the ghost slots of the grid's halo from the slots they copy, once every slot has
+     * been packed. This does nothing if the grid has no halo.
+     * @param grid Spatial grid passed to resize().
+     */
+    void packHalo(const SpatialGrid& grid);
+};
+
+/**
+ * @brief Accumulate everything needed to update a boid from its neighbourhood, in a single pass.
+ *
+ * Each candidate from the grid is visited once. Candidates outside the neighbourhood radius are
+ * rejected using the squared distance, and the accepted neighbours are accumulated according to
+ * their type:
+ * - BOID neighbours contribute to the alignment, cohesion, separation and hue, and the nearest of
+ *   them is tracked.
+ * - OBSTACLE neighbours contribute to the obstacle separation.
+ * - PREDATOR neighbours contribute to the predator separation.
+ *
+ * The separation for each type only counts neighbours within its own minimum distance (the
+ * `repelMinDist` from the config, or five times that for predators). Neighbours at exactly the same
+ * position don't contribute to the alignment or hue, as their weight would be infinite.
+ *
+ * This reads the flock state directly, so it sees any changes made to the state since the grid was
+ * built (as needed by the in-place update).
+ *
+ * The displacements to the neighbours are taken according to a boundary policy from boundary.h,
+ * which is fixed at compile time so that only a periodic scene pays for wrapping them.
+ *
+ * @param state Flock state to read the boid and its neighbours from.
+ * @param i Index of the boid.
+ * @param grid Spatial grid built from the flock state.
+ * @param cfg Configuration of the boid.
+ * @param bounds Bounds of the scene.
+ * @return Sums over the neighbourhood.
+ */
+template <typename Policy = boundary::Periodic>
+NeighbourhoodSums accumulateNeighbourhood(const FlockState& state, const std::size_t& i,
+                                          const SpatialGrid& grid, const Config& cfg,
+                                          const Rect& bounds);
+
+/**
+ * @brief Accumulate everything needed to update a boid from its neighbourhood, reading the
+ * neighbours from a packed copy of the flock state. This gives the same result as the overload
+ * reading the flock state directly (up to floating point rounding), but runs the distance test,
+ * the wrapping and the accumulation using the selected instruction set. In a periodic scene packed
+ * with a halo, the neighbourhood is read from the halo instead, so no displacement is wrapped.
+ *
+ * @param state Flock state to read the boid from.
+ * @param i Index of the boid.
+ * @param grid Spatial grid built from the flock state.
+ * @param packed Flock state packed in the slot order of the grid.
+ * @param cfg Configuration of the boid.
+ * @param bounds Bounds of the scene.
+ * @return Sums over the neighbourhood.
+ */
+template <typename Policy = boundary::Periodic>
+NeighbourhoodSums accumulateNeighbourhood(const FlockState& state, const std::size_t& i,
+                                          const SpatialGrid& grid, const PackedNeighbours& packed,
+                                          const Config& cfg, const Rect& bounds);
+
+/**
+ * @brief Accumulate everything needed to update a boid from a cached list of candidates, such as
+ * a Verlet list from NeighbourLists, reading them from a packed copy of the flock state. Only the
+ * candidates within the neighbourhood radius are accumulated, so the list can hold more than the
+ * neighbourhood. The packed copy must not have a halo, as the displacements are taken with the
+ * boundary policy.
+ *
+ * @param state Flock state to read the boid from.
+ * @param i Index of the boid.
+ * @param packed Flock state packed in the slot order of a grid.
+ * @param candidates Packed slots of the candidates, not including the boid itself.
+ * @param cfg Configuration of the boid.
+ * @param bounds Bounds of the scene.
+ * @return Sums over the neighbourhood.
+ */
+template <typename Policy = boundary::Periodic>
+NeighbourhoodSums accumulateNeighbourhood(const FlockState& state, const std::size_t& i,
+                                          const PackedNeighbours& packed,
+                                          const std::span<const int32_t>& candidates,
+                                          const Config& cfg, const Rect& bounds);
+
+/**
+ * @brief Find the packed slots in a set of slot ranges that are within a radius of another slot,
+ * using the selected instruction set. This is the distance test of the neighbourhood kernels on
+ * its own, which NeighbourLists builds its lists with.
+ *
+ * @param packed Flock state packed in the slot order of a grid, without a halo.
+ * @param slot Slot to measure from, which is left out of the result.
+ * @param radius Radius.
+ * @param bounds Bounds of the scene.
+ * @param ranges Array of [begin, end) slot pairs, e.g. from SpatialGrid::getSlotRanges().
+ * @param numRanges Number of ranges.
+ * @param out Array to write the slots to, with room for every slot in the ranges.
+ * @return Number of slots written.
+ */
+template <typename Policy = boundary::Periodic>
+std::size_t findSlotsWithin(const PackedNeighbours& packed, const std::size_t& slot,
+                            const float& radius, const Rect& bounds, const std::size_t* ranges,
+                            const std::size_t& numRanges, int32_t* out);
+
+/**
+ * @brief Get the instruction set used by the packed neighbourhood kernel. By default this is the
+ * widest instruction set supported by the host CPU.
+ * @return Instruction set.
+ */
+InstructionSet getInstructionSet();
+
+/**
+ * @brief Set the instruction set used by the packed neighbourhood kernel.
+ * @param isa Instruction set.
+ * @throws std::invalid_argument If the instruction set isn't supported by the host CPU.
+ */
+void setInstructionSet(const InstructionSet& isa);
+
+/**
+ * @brief Check whether an instruction set is supported by both the build and the host CPU.
+ * @param isa Instruction set.
+ * @return True if the instruction set can be used.
+ */
+bool isSupported(const InstructionSet& isa);
+
+} // namespace kernel
+} // namespace boids
@@ -0,0 +1,829 @@
+#include "kernel_simd.h"
+
+#ifdef BOIDS_KERNEL_X86
+#include <algorithm>
+#include <immintrin.h>
+#include <limits>
+
+// Some versions of GCC warn about the undefined placeholder vectors used inside the AVX-512
+// intrinsics themselves.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace boids {
+namespace kernel {
+namespace detail {
+
+// Each kernel below follows the same steps as accumulateRangesScalar(), for a full vector of
+// candidates at a time:
+// 1. Wrap the displacements to the candidates using the minimum image convention, branch-free.
+//    This step is compiled out for the boundary policies that don't wrap.
+// 2. Build a lane mask of the candidates that are within the radius, are not the boid itself and
+//    are within the current range.
+// 3. Accumulate the masked contributions of each type of neighbour into vector accumulators,
+//    which are only reduced to scalars once all the candidates have been processed. The distance
+//    to the nearest BOID neighbour is kept as a per-lane minimum in the same way.
+//
+// The range and list kernels of each instruction set share these steps, and only differ in how
+// they load a vector of candidates: the range kernels load contiguous slots, while the list
+// kernels gather the slots of a Verlet list. The filter kernels, which build those lists, only
+// run the first two steps, and write out the slots in the mask instead of accumulating them.
+
+/**
+ * @brief Sum the lanes of an SSE vector.
+ */
+__attribute__((target("sse4.1"))) inline float hsum(__m128 v) {
+    __m128 shuf = _mm_movehdup_ps(v);
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf        = _mm_movehl_ps(shuf, sums);
+    sums        = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+}
+
+/**
+ * @brief Get the minimum of the lanes of an SSE vector.
+ */
+__attribute__((target("sse4.1"))) inline float hmin(__m128 v) {
+    v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_min_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+/**
+ * @brief Wrap a vector of displacements along an axis of a given size, using SSE.
+ */
+__attribute__((target("sse4.1"))) inline __m128 wrap(__m128 d, __m128 size, __m128 half,
+                                                      __m128 signMask) {
+    const __m128 outside = _mm_cmpgt_ps(_mm_andnot_ps(signMask, d), half);
+    const __m128 shift   = _mm_or_ps(_mm_and_ps(d, signMask), size);
+    return _mm_blendv_ps(d, _mm_sub_ps(d, shift), outside);
+}
+
+/**
+ * @brief The SseSlots struct loads 4 contiguous packed slots.
+ */
+struct SseSlots {
+    std::size_t k; ///< First slot.
+
+    __attribute__((target("sse4.1"))) __m128 operator()(const AlignedVector<float>& v) const {
+        return _mm_loadu_ps(&v[k]);
+    }
+    __attribute__((target("sse4.1"))) __m128i operator()(const AlignedVector<int32_t>& v) const {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(&v[k]));
+    }
+};
+
+/**
+ * @brief The SseGather struct loads 4 packed slots from anywhere in the arrays. SSE has no gather
+ * instruction, so each lane is loaded on its own.
+ */
+struct SseGather {
+    int32_t slots[4]; ///< Slot of each lane, which is any valid slot for the unused lanes.
+
+    __attribute__((target("sse4.1"))) __m128 operator()(const AlignedVector<float>& v) const {
+        return _mm_setr_ps(v[slots[0]], v[slots[1]], v[slots[2]], v[slots[3]]);
+    }
+    __attribute__((target("sse4.1"))) __m128i operator()(const AlignedVector<int32_t>& v) const {
+        return _mm_setr_epi32(v[slots[0]], v[slots[1]], v[slots[2]], v[slots[3]]);
+    }
+};
+
+/**
+ * @brief The SseKernel struct holds the broadcast parameters and the accumulators of the SSE
+ * kernels.
+ */
+struct SseKernel {
+    __m128      px, py, hue, width, height, halfW, halfH, radiusSq, repelSq, predSq;
+    __m128      alignX, alignY, cohX, cohY, repX, repY, obsX, obsY, predX, predY, hueSum, nearest;
+    std::size_t count = 0;
+
+    __attribute__((target("sse4.1"))) explicit SseKernel(const KernelParams& params) {
+        const __m128 zero = _mm_setzero_ps();
+        px                = _mm_set1_ps(params.px);
+        py                = _mm_set1_ps(params.py);
+        hue               = _mm_set1_ps(params.hue);
+        width             = _mm_set1_ps(params.width);
+        height            = _mm_set1_ps(params.height);
+        halfW             = _mm_set1_ps(0.5f * params.width);
+        halfH             = _mm_set1_ps(0.5f * params.height);
+        radiusSq          = _mm_set1_ps(params.radiusSq);
+        repelSq           = _mm_set1_ps(params.repelSq);
+        predSq            = _mm_set1_ps(params.predatorSq);
+        alignX = alignY = cohX = cohY = repX = repY = zero;
+        obsX = obsY = predX = predY = hueSum = zero;
+        nearest = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    }
+
+    /**
+     * @brief Accumulate a vector of candidates.
+     * @param packed Packed flock state.
+     * @param load Loader of the candidate slots.
+     * @param valid Mask of the lanes that hold a candidate other than the boid itself.
+     */
+    template <typename Policy, typename Load>
+    __attribute__((target("sse4.1"))) void accumulate(const PackedNeighbours& packed,
+                                                       const Load& load, const __m128 valid) {
+        const __m128  signMask = _mm_set1_ps(-0.0f);
+        const __m128  zero     = _mm_setzero_ps();
+        const __m128  one      = _mm_set1_ps(1.0f);
+        const __m128  inf      = _mm_set1_ps(std::numeric_limits<float>::infinity());
+        const __m128i typeBoid = _mm_set1_epi32(BoidType::BOID);
+        const __m128i typeObs  = _mm_set1_epi32(BoidType::OBSTACLE);
+        const __m128i typePred = _mm_set1_epi32(BoidType::PREDATOR);
+
+        __m128 dx = _mm_sub_ps(load(packed.x), px);
+        __m128 dy = _mm_sub_ps(load(packed.y), py);
+        if constexpr (Policy::WRAPS) {
+            dx = wrap(dx, width, halfW, signMask);
+            dy = wrap(dy, height, halfH, signMask);
+        }
+        const __m128 distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        const __m128 mask   = _mm_and_ps(valid, _mm_cmple_ps(distSq, radiusSq));
+        if (_mm_movemask_ps(mask) == 0)
+            return;
+
+        const __m128 dist     = _mm_sqrt_ps(distSq);
+        const __m128 positive = _mm_cmpgt_ps(dist, zero);
+        const __m128 invDist  = _mm_and_ps(positive, _mm_div_ps(one, dist));
+        const __m128 awayX =
+            _mm_blendv_ps(one, _mm_mul_ps(_mm_xor_ps(dx, signMask), invDist), positive);
+        const __m128 awayY = _mm_and_ps(positive, _mm_mul_ps(_mm_xor_ps(dy, signMask), invDist));
+
+        const __m128i type    = load(packed.type);
+        const __m128  isBoid  = _mm_and_ps(mask, _mm_castsi128_ps(_mm_cmpeq_epi32(type, typeBoid)));
+        const __m128  isObs   = _mm_and_ps(mask, _mm_castsi128_ps(_mm_cmpeq_epi32(type, typeObs)));
+        const __m128  isPred  = _mm_and_ps(mask, _mm_castsi128_ps(_mm_cmpeq_epi32(type, typePred)));
+        const __m128  inRepel = _mm_cmple_ps(distSq, repelSq);
+
+        count  += __builtin_popcount(_mm_movemask_ps(isBoid));
+        nearest = _mm_min_ps(nearest, _mm_blendv_ps(inf, distSq, isBoid));
+        cohX    = _mm_add_ps(cohX, _mm_and_ps(isBoid, dx));
+        cohY    = _mm_add_ps(cohY, _mm_and_ps(isBoid, dy));
+        alignX  = _mm_add_ps(alignX, _mm_and_ps(isBoid, _mm_mul_ps(load(packed.nvx), invDist)));
+        alignY  = _mm_add_ps(alignY, _mm_and_ps(isBoid, _mm_mul_ps(load(packed.nvy), invDist)));
+
+        const __m128 hueDiff = wrap(_mm_sub_ps(hue, load(packed.hue)), _mm_set1_ps(359.0f),
+                                    _mm_set1_ps(0.5f * 359.0f), signMask);
+        hueSum = _mm_add_ps(hueSum, _mm_and_ps(isBoid, _mm_mul_ps(hueDiff, invDist)));
+
+        const __m128 boidRepel = _mm_and_ps(isBoid, inRepel);
+        repX                   = _mm_add_ps(repX, _mm_and_ps(boidRepel, awayX));
+        repY                   = _mm_add_ps(repY, _mm_and_ps(boidRepel, awayY));
+
+        const __m128 obsRepel = _mm_and_ps(isObs, inRepel);
+        obsX                  = _mm_add_ps(obsX, _mm_and_ps(obsRepel, awayX));
+        obsY                  = _mm_add_ps(obsY, _mm_and_ps(obsRepel, awayY));
+
+        const __m128 predRepel = _mm_and_ps(isPred, _mm_cmple_ps(distSq, predSq));
+        predX                  = _mm_add_ps(predX, _mm_and_ps(predRepel, awayX));
+        predY                  = _mm_add_ps(predY, _mm_and_ps(predRepel, awayY));
+    }
+
+    /**
+     * @brief Reduce the accumulators into the sums.
+     * @param sums Sums to add to.
+     */
+    __attribute__((target("sse4.1"))) void reduce(NeighbourhoodSums& sums) const {
+        sums.count += count;
+        sums.alignX += hsum(alignX);
+        sums.alignY += hsum(alignY);
+        sums.cohesionX += hsum(cohX);
+        sums.cohesionY += hsum(cohY);
+        sums.repelX += hsum(repX);
+        sums.repelY += hsum(repY);
+        sums.obstacleX += hsum(obsX);
+        sums.obstacleY += hsum(obsY);
+        sums.predatorX += hsum(predX);
+        sums.predatorY += hsum(predY);
+        sums.hue += hsum(hueSum);
+        sums.nearestSq = std::min(sums.nearestSq, hmin(nearest));
+    }
+};
+
+template <typename Policy>
+__attribute__((target("sse4.1"))) void
+accumulateRangesSseImpl(const PackedNeighbours& packed, const KernelParams& params,
+                        const std::size_t* ranges, const std::size_t numRanges,
+                        NeighbourhoodSums& sums) {
+    const __m128i self      = _mm_set1_epi32(params.self);
+    const __m128i laneIndex = _mm_setr_epi32(0, 1, 2, 3);
+
+    SseKernel kernel(params);
+    for (std::size_t r = 0; r < numRanges; ++r) {
+        const std::size_t begin = ranges[2 * r];
+        const std::size_t end   = ranges[2 * r + 1];
+        for (std::size_t k = begin; k < end; k += 4) {
+            const __m128i lanes = _mm_add_epi32(_mm_set1_epi32(int32_t(k)), laneIndex);
+            const __m128  inRange =
+                _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_set1_epi32(int32_t(end)), lanes));
+            const __m128i index =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(&packed.index[k]));
+            const __m128 isSelf = _mm_castsi128_ps(_mm_cmpeq_epi32(index, self));
+            kernel.accumulate<Policy>(packed, SseSlots{k}, _mm_andnot_ps(isSelf, inRange));
+        }
+    }
+    kernel.reduce(sums);
+}
+
+template <typename Policy>
+__attribute__((target("sse4.1"))) void
+accumulateListSseImpl(const PackedNeighbours& packed, const KernelParams& params,
+                      const int32_t* candidates, const std::size_t count, NeighbourhoodSums& sums) {
+    const __m128i laneIndex = _mm_setr_epi32(0, 1, 2, 3);
+
+    SseKernel kernel(params);
+    for (std::size_t k = 0; k < count; k += 4) {
+        const std::size_t n    = std::min<std::size_t>(count - k, 4);
+        SseGather         load = {{0, 0, 0, 0}};
+        std::copy_n(candidates + k, n, load.slots);
+
+        const __m128 valid =
+            _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_set1_epi32(int32_t(n)), laneIndex));
+        kernel.accumulate<Policy>(packed, load, valid);
+    }
+    kernel.reduce(sums);
+}
+
+template <typename Policy>
+__attribute__((target("sse4.1"))) std::size_t
+filterRangesSseImpl(const PackedNeighbours& packed, const KernelParams& params,
+                    const std::size_t* ranges, const std::size_t numRanges, int32_t* out) {
+    const __m128  signMask = _mm_set1_ps(-0.0f);
+    const __m128  px       = _mm_set1_ps(params.px);
+    const __m128  py       = _mm_set1_ps(params.py);
+    const __m128  width    = _mm_set1_ps(params.width);
+    const __m128  height   = _mm_set1_ps(params.height);
+    const __m128  halfW    = _mm_set1_ps(0.5f * params.width);
+    const __m128  halfH    = _mm_set1_ps(0.5f * params.height);
+    const __m128  radiusSq = _mm_set1_ps(params.radiusSq);
+    const __m128i self     = _mm_set1_epi32(params.self);
+
+    std::size_t count = 0;
+    for (std::size_t r = 0; r < numRanges; ++r) {
+        const std::size_t begin = ranges[2 * r];
+        const std::size_t end   = ranges[2 * r + 1];
+        for (std::size_t k = begin; k < end; k += 4) {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(&packed.x[k]), px);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(&packed.y[k]), py);
+            if constexpr (Policy::WRAPS) {
+                dx = wrap(dx, width, halfW, signMask);
+                dy = wrap(dy, height, halfH, signMask);
+            }
+            const __m128  distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            const __m128i index =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(&packed.index[k]));
+            const __m128 isSelf  = _mm_castsi128_ps(_mm_cmpeq_epi32(index, self));
+            const int    inRange = end - k >= 4 ? 0xF : (1 << (end - k)) - 1;
+
+            // SSE has no compress instruction, so the slots that pass are written one at a time.
+            int pass =
+                inRange & _mm_movemask_ps(_mm_andnot_ps(isSelf, _mm_cmple_ps(distSq, radiusSq)));
+            while (pass != 0) {
+                out[count++] = int32_t(k) + __builtin_ctz(pass);
+                pass &= pass - 1;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Sum the lanes of an AVX vector.
+ */
+__attribute__((target("avx2,fma"))) inline float hsum(__m256 v) {
+    return hsum(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+}
+
+/**
+ * @brief Get the minimum of the lanes of an AVX vector.
+ */
+__attribute__((target("avx2,fma"))) inline float hmin(__m256 v) {
+    return hmin(_mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+}
+
+/**
+ * @brief Wrap a vector of displacements along an axis of a given size, using AVX.
+ */
+__attribute__((target("avx2,fma"))) inline __m256 wrap(__m256 d, __m256 size, __m256 half,
+                                                        __m256 signMask) {
+    const __m256 outside = _mm256_cmp_ps(_mm256_andnot_ps(signMask, d), half, _CMP_GT_OQ);
+    const __m256 shift   = _mm256_or_ps(_mm256_and_ps(d, signMask), size);
+    return _mm256_blendv_ps(d, _mm256_sub_ps(d, shift), outside);
+}
+
+/**
+ * @brief The Avx2Slots struct loads 8 contiguous packed slots.
+ */
+struct Avx2Slots {
+    std::size_t k; ///< First slot.
+
+    __attribute__((target("avx2,fma"))) __m256 operator()(const AlignedVector<float>& v) const {
+        return _mm256_loadu_ps(&v[k]);
+    }
+    __attribute__((target("avx2,fma"))) __m256i operator()(const AlignedVector<int32_t>& v) const {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&v[k]));
+    }
+};
+
+/**
+ * @brief The Avx2Gather struct gathers 8 packed slots from anywhere in the arrays.
+ */
+struct Avx2Gather {
+    __m256i slots; ///< Slot of each lane.
+    __m256i valid; ///< Mask of the lanes to load, the others are zero.
+
+    __attribute__((target("avx2,fma"))) __m256 operator()(const AlignedVector<float>& v) const {
+        return _mm256_mask_i32gather_ps(_mm256_setzero_ps(), v.data(), slots,
+                                        _mm256_castsi256_ps(valid), 4);
+    }
+    __attribute__((target("avx2,fma"))) __m256i operator()(const AlignedVector<int32_t>& v) const {
+        return _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), v.data(), slots, valid, 4);
+    }
+};
+
+/**
+ * @brief The Avx2Kernel struct holds the broadcast parameters and the accumulators of the AVX2
+ * kernels.
+ */
+struct Avx2Kernel {
+    __m256      px, py, hue, width, height, halfW, halfH, radiusSq, repelSq, predSq;
+    __m256      alignX, alignY, cohX, cohY, repX, repY, obsX, obsY, predX, predY, hueSum, nearest;
+    std::size_t count = 0;
+
+    __attribute__((target("avx2,fma"))) explicit Avx2Kernel(const KernelParams& params) {
+        const __m256 zero = _mm256_setzero_ps();
+        px                = _mm256_set1_ps(params.px);
+        py                = _mm256_set1_ps(params.py);
+        hue               = _mm256_set1_ps(params.hue);
+        width             = _mm256_set1_ps(params.width);
+        height            = _mm256_set1_ps(params.height);
+        halfW             = _mm256_set1_ps(0.5f * params.width);
+        halfH             = _mm256_set1_ps(0.5f * params.height);
+        radiusSq          = _mm256_set1_ps(params.radiusSq);
+        repelSq           = _mm256_set1_ps(params.repelSq);
+        predSq            = _mm256_set1_ps(params.predatorSq);
+        alignX = alignY = cohX = cohY = repX = repY = zero;
+        obsX = obsY = predX = predY = hueSum = zero;
+        nearest = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    }
+
+    /**
+     * @brief Accumulate a vector of candidates.
+     * @param packed Packed flock state.
+     * @param load Loader of the candidate slots.
+     * @param valid Mask of the lanes that hold a candidate other than the boid itself.
+     */
+    template <typename Policy, typename Load>
+    __attribute__((target("avx2,fma"))) void accumulate(const PackedNeighbours& packed,
+                                                         const Load& load, const __m256 valid) {
+        const __m256  signMask = _mm256_set1_ps(-0.0f);
+        const __m256  zero     = _mm256_setzero_ps();
+        const __m256  one      = _mm256_set1_ps(1.0f);
+        const __m256  inf      = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+        const __m256i typeBoid = _mm256_set1_epi32(BoidType::BOID);
+        const __m256i typeObs  = _mm256_set1_epi32(BoidType::OBSTACLE);
+        const __m256i typePred = _mm256_set1_epi32(BoidType::PREDATOR);
+
+        __m256 dx = _mm256_sub_ps(load(packed.x), px);
+        __m256 dy = _mm256_sub_ps(load(packed.y), py);
+        if constexpr (Policy::WRAPS) {
+            dx = wrap(dx, width, halfW, signMask);
+            dy = wrap(dy, height, halfH, signMask);
+        }
+        const __m256 distSq = _mm256_fmadd_ps(dx, dx, _mm256_mul_ps(dy, dy));
+        const __m256 mask   = _mm256_and_ps(valid, _mm256_cmp_ps(distSq, radiusSq, _CMP_LE_OQ));
+        if (_mm256_movemask_ps(mask) == 0)
+            return;
+
+        const __m256 dist     = _mm256_sqrt_ps(distSq);
+        const __m256 positive = _mm256_cmp_ps(dist, zero, _CMP_GT_OQ);
+        const __m256 invDist  = _mm256_and_ps(positive, _mm256_div_ps(one, dist));
+        const __m256 awayX =
+            _mm256_blendv_ps(one, _mm256_mul_ps(_mm256_xor_ps(dx, signMask), invDist), positive);
+        const __m256 awayY =
+            _mm256_and_ps(positive, _mm256_mul_ps(_mm256_xor_ps(dy, signMask), invDist));
+
+        const __m256i type = load(packed.type);
+        const __m256  isBoid =
+            _mm256_and_ps(mask, _mm256_castsi256_ps(_mm256_cmpeq_epi32(type, typeBoid)));
+        const __m256 isObs =
+            _mm256_and_ps(mask, _mm256_castsi256_ps(_mm256_cmpeq_epi32(type, typeObs)));
+        const __m256 isPred =
+            _mm256_and_ps(mask, _mm256_castsi256_ps(_mm256_cmpeq_epi32(type, typePred)));
+        const __m256 inRepel = _mm256_cmp_ps(distSq, repelSq, _CMP_LE_OQ);
+
+        count  += __builtin_popcount(_mm256_movemask_ps(isBoid));
+        nearest = _mm256_min_ps(nearest, _mm256_blendv_ps(inf, distSq, isBoid));
+        cohX    = _mm256_add_ps(cohX, _mm256_and_ps(isBoid, dx));
+        cohY    = _mm256_add_ps(cohY, _mm256_and_ps(isBoid, dy));
+        alignX =
+            _mm256_add_ps(alignX, _mm256_and_ps(isBoid, _mm256_mul_ps(load(packed.nvx), invDist)));
+        alignY =
+            _mm256_add_ps(alignY, _mm256_and_ps(isBoid, _mm256_mul_ps(load(packed.nvy), invDist)));
+
+        const __m256 hueDiff = wrap(_mm256_sub_ps(hue, load(packed.hue)), _mm256_set1_ps(359.0f),
+                                    _mm256_set1_ps(0.5f * 359.0f), signMask);
+        hueSum = _mm256_add_ps(hueSum, _mm256_and_ps(isBoid, _mm256_mul_ps(hueDiff, invDist)));
+
+        const __m256 boidRepel = _mm256_and_ps(isBoid, inRepel);
+        repX                   = _mm256_add_ps(repX, _mm256_and_ps(boidRepel, awayX));
+        repY                   = _mm256_add_ps(repY, _mm256_and_ps(boidRepel, awayY));
+
+        const __m256 obsRepel = _mm256_and_ps(isObs, inRepel);
+        obsX                  = _mm256_add_ps(obsX, _mm256_and_ps(obsRepel, awayX));
+        obsY                  = _mm256_add_ps(obsY, _mm256_and_ps(obsRepel, awayY));
+
+        const __m256 predRepel = _mm256_and_ps(isPred, _mm256_cmp_ps(distSq, predSq, _CMP_LE_OQ));
+        predX                  = _mm256_add_ps(predX, _mm256_and_ps(predRepel, awayX));
+        predY                  = _mm256_add_ps(predY, _mm256_and_ps(predRepel, awayY));
+    }
+
+    /**
+     * @brief Reduce the accumulators into the sums.
+     * @param sums Sums to add to.
+     */
+    __attribute__((target("avx2,fma"))) void reduce(NeighbourhoodSums& sums) const {
+        sums.count += count;
+        sums.alignX += hsum(alignX);
+        sums.alignY += hsum(alignY);
+        sums.cohesionX += hsum(cohX);
+        sums.cohesionY += hsum(cohY);
+        sums.repelX += hsum(repX);
+        sums.repelY += hsum(repY);
+        sums.obstacleX += hsum(obsX);
+        sums.obstacleY += hsum(obsY);
+        sums.predatorX += hsum(predX);
+        sums.predatorY += hsum(predY);
+        sums.hue += hsum(hueSum);
+        sums.nearestSq = std::min(sums.nearestSq, hmin(nearest));
+    }
+};
+
+template <typename Policy>
+__attribute__((target("avx2,fma"))) void
+accumulateRangesAvx2Impl(const PackedNeighbours& packed, const KernelParams& params,
+                         const std::size_t* ranges, const std::size_t numRanges,
+                         NeighbourhoodSums& sums) {
+    const __m256i self      = _mm256_set1_epi32(params.self);
+    const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    Avx2Kernel kernel(params);
+    for (std::size_t r = 0; r < numRanges; ++r) {
+        const std::size_t begin = ranges[2 * r];
+        const std::size_t end   = ranges[2 * r + 1];
+        for (std::size_t k = begin; k < end; k += 8) {
+            const __m256i lanes = _mm256_add_epi32(_mm256_set1_epi32(int32_t(k)), laneIndex);
+            const __m256  inRange =
+                _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(int32_t(end)), lanes));
+            const __m256i index =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&packed.index[k]));
+            const __m256 isSelf = _mm256_castsi256_ps(_mm256_cmpeq_epi32(index, self));
+            kernel.accumulate<Policy>(packed, Avx2Slots{k}, _mm256_andnot_ps(isSelf, inRange));
+        }
+    }
+    kernel.reduce(sums);
+}
+
+template <typename Policy>
+__attribute__((target("avx2,fma"))) void
+accumulateListAvx2Impl(const PackedNeighbours& packed, const KernelParams& params,
+                       const int32_t* candidates, const std::size_t count,
+                       NeighbourhoodSums& sums) {
+    const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    Avx2Kernel kernel(params);
+    for (std::size_t k = 0; k < count; k += 8) {
+        const __m256i remaining = _mm256_set1_epi32(int32_t(std::min<std::size_t>(count - k, 8)));
+        const __m256i valid     = _mm256_cmpgt_epi32(remaining, laneIndex);
+        const __m256i slots     = _mm256_maskload_epi32(candidates + k, valid);
+        kernel.accumulate<Policy>(packed, Avx2Gather{slots, valid}, _mm256_castsi256_ps(valid));
+    }
+    kernel.reduce(sums);
+}
+
+template <typename Policy>
+__attribute__((target("avx2,fma"))) std::size_t
+filterRangesAvx2Impl(const PackedNeighbours& packed, const KernelParams& params,
+                     const std::size_t* ranges, const std::size_t numRanges, int32_t* out) {
+    const __m256  signMask = _mm256_set1_ps(-0.0f);
+    const __m256  px       = _mm256_set1_ps(params.px);
+    const __m256  py       = _mm256_set1_ps(params.py);
+    const __m256  width    = _mm256_set1_ps(params.width);
+    const __m256  height   = _mm256_set1_ps(params.height);
+    const __m256  halfW    = _mm256_set1_ps(0.5f * params.width);
+    const __m256  halfH    = _mm256_set1_ps(0.5f * params.height);
+    const __m256  radiusSq = _mm256_set1_ps(params.radiusSq);
+    const __m256i self     = _mm256_set1_epi32(params.self);
+
+    std::size_t count = 0;
+    for (std::size_t r = 0; r < numRanges; ++r) {
+        const std::size_t begin = ranges[2 * r];
+        const std::size_t end   = ranges[2 * r + 1];
+        for (std::size_t k = begin; k < end; k += 8) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&packed.x[k]), px);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&packed.y[k]), py);
+            if constexpr (Policy::WRAPS) {
+                dx = wrap(dx, width, halfW, signMask);
+                dy = wrap(dy, height, halfH, signMask);
+            }
+            const __m256  distSq = _mm256_fmadd_ps(dx, dx, _mm256_mul_ps(dy, dy));
+            const __m256i index =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&packed.index[k]));
+            const __m256 isSelf  = _mm256_castsi256_ps(_mm256_cmpeq_epi32(index, self));
+            const int    inRange = end - k >= 8 ? 0xFF : (1 << (end - k)) - 1;
+
+            // AVX2 has no compress instruction either, as with SSE.
+            int pass = inRange & _mm256_movemask_ps(_mm256_andnot_ps(
+                                     isSelf, _mm256_cmp_ps(distSq, radiusSq, _CMP_LE_OQ)));
+            while (pass != 0) {
+                out[count++] = int32_t(k) + __builtin_ctz(pass);
+                pass &= pass - 1;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Wrap a vector of displacements along an axis of a given size, using AVX-512.
+ */
+__attribute__((target("avx512f"))) inline __m512 wrap(__m512 d, __m512 size, __m512 half) {
+    const __mmask16 outside = _mm512_cmp_ps_mask(_mm512_abs_ps(d), half, _CMP_GT_OQ);
+    const __m512    shift   = _mm512_castsi512_ps(_mm512_or_si512(
+        _mm512_and_si512(_mm512_castps_si512(d), _mm512_set1_epi32(int32_t(0x80000000))),
+        _mm512_castps_si512(size)));
+    return _mm512_mask_sub_ps(d, outside, d, shift);
+}
+
+/**
+ * @brief The Avx512Slots struct loads 16 contiguous packed slots.
+ */
+struct Avx512Slots {
+    std::size_t k; ///< First slot.
+
+    __attribute__((target("avx512f"))) __m512 operator()(const AlignedVector<float>& v) const {
+        return _mm512_loadu_ps(&v[k]);
+    }
+    __attribute__((target("avx512f"))) __m512i operator()(const AlignedVector<int32_t>& v) const {
+        return _mm512_loadu_si512(&v[k]);
+    }
+};
+
+/**
+ * @brief The Avx512Gather struct gathers 16 packed slots from anywhere in the arrays.
+ */
+struct Avx512Gather {
+    __m512i   slots; ///< Slot of each lane.
+    __mmask16 valid; ///< Mask of the lanes to load, the others are zero.
+
+    __attribute__((target("avx512f"))) __m512 operator()(const AlignedVector<float>& v) const {
+        return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), valid, slots, v.data(), 4);
+    }
+    __attribute__((target("avx512f"))) __m512i operator()(const AlignedVector<int32_t>& v) const {
+        return _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), valid, slots, v.data(), 4);
+    }
+};
+
+/**
+ * @brief The Avx512Kernel struct holds the broadcast parameters and the accumulators of the
+ * AVX-512 kernels.
+ */
+struct Avx512Kernel {
+    __m512      px, py, hue, width, height, halfW, halfH, radiusSq, repelSq, predSq;
+    __m512      alignX, alignY, cohX, cohY, repX, repY, obsX, obsY, predX, predY, hueSum, nearest;
+    std::size_t count = 0;
+
+    __attribute__((target("avx512f"))) explicit Avx512Kernel(const KernelParams& params) {
+        const __m512 zero = _mm512_setzero_ps();
+        px                = _mm512_set1_ps(params.px);
+        py                = _mm512_set1_ps(params.py);
+        hue               = _mm512_set1_ps(params.hue);
+        width             = _mm512_set1_ps(params.width);
+        height            = _mm512_set1_ps(params.height);
+        halfW             = _mm512_set1_ps(0.5f * params.width);
+        halfH             = _mm512_set1_ps(0.5f * params.height);
+        radiusSq          = _mm512_set1_ps(params.radiusSq);
+        repelSq           = _mm512_set1_ps(params.repelSq);
+        predSq            = _mm512_set1_ps(params.predatorSq);
+        alignX = alignY = cohX = cohY = repX = repY = zero;
+        obsX = obsY = predX = predY = hueSum = zero;
+        nearest = _mm512_set1_ps(std::numeric_limits<float>::infinity());
+    }
+
+    /**
+     * @brief Accumulate a vector of candidates.
+     * @param packed Packed flock state.
+     * @param load Loader of the candidate slots.
+     * @param valid Mask of the lanes that hold a candidate other than the boid itself.
+     */
+    template <typename Policy, typename Load>
+    __attribute__((target("avx512f"))) void accumulate(const PackedNeighbours& packed,
+                                                        const Load& load, const __mmask16 valid) {
+        const __m512  zero     = _mm512_setzero_ps();
+        const __m512  one      = _mm512_set1_ps(1.0f);
+        const __m512i typeBoid = _mm512_set1_epi32(BoidType::BOID);
+        const __m512i typeObs  = _mm512_set1_epi32(BoidType::OBSTACLE);
+        const __m512i typePred = _mm512_set1_epi32(BoidType::PREDATOR);
+
+        __m512 dx = _mm512_sub_ps(load(packed.x), px);
+        __m512 dy = _mm512_sub_ps(load(packed.y), py);
+        if constexpr (Policy::WRAPS) {
+            dx = wrap(dx, width, halfW);
+            dy = wrap(dy, height, halfH);
+        }
+        const __m512    distSq = _mm512_fmadd_ps(dx, dx, _mm512_mul_ps(dy, dy));
+        const __mmask16 mask   = _mm512_mask_cmp_ps_mask(valid, distSq, radiusSq, _CMP_LE_OQ);
+        if (mask == 0)
+            return;
+
+        const __m512    dist     = _mm512_sqrt_ps(distSq);
+        const __mmask16 positive = _mm512_cmp_ps_mask(dist, zero, _CMP_GT_OQ);
+        const __m512    invDist  = _mm512_maskz_div_ps(positive, one, dist);
+        const __m512 awayX = _mm512_mask_mul_ps(one, positive, _mm512_sub_ps(zero, dx), invDist);
+        const __m512 awayY = _mm512_maskz_mul_ps(positive, _mm512_sub_ps(zero, dy), invDist);
+
+        const __m512i   type    = load(packed.type);
+        const __mmask16 isBoid  = _mm512_mask_cmpeq_epi32_mask(mask, type, typeBoid);
+        const __mmask16 isObs   = _mm512_mask_cmpeq_epi32_mask(mask, type, typeObs);
+        const __mmask16 isPred  = _mm512_mask_cmpeq_epi32_mask(mask, type, typePred);
+        const __mmask16 inRepel = _mm512_cmp_ps_mask(distSq, repelSq, _CMP_LE_OQ);
+
+        count  += __builtin_popcount(isBoid);
+        nearest = _mm512_mask_min_ps(nearest, isBoid, nearest, distSq);
+        cohX    = _mm512_mask_add_ps(cohX, isBoid, cohX, dx);
+        cohY    = _mm512_mask_add_ps(cohY, isBoid, cohY, dy);
+        alignX  = _mm512_mask3_fmadd_ps(load(packed.nvx), invDist, alignX, isBoid);
+        alignY  = _mm512_mask3_fmadd_ps(load(packed.nvy), invDist, alignY, isBoid);
+
+        const __m512 hueDiff = wrap(_mm512_sub_ps(hue, load(packed.hue)), _mm512_set1_ps(359.0f),
+                                    _mm512_set1_ps(0.5f * 359.0f));
+        hueSum = _mm512_mask3_fmadd_ps(hueDiff, invDist, hueSum, isBoid);
+
+        const __mmask16 boidRepel = isBoid & inRepel;
+        repX                      = _mm512_mask_add_ps(repX, boidRepel, repX, awayX);
+        repY                      = _mm512_mask_add_ps(repY, boidRepel, repY, awayY);
+
+        const __mmask16 obsRepel = isObs & inRepel;
+        obsX                     = _mm512_mask_add_ps(obsX, obsRepel, obsX, awayX);
+        obsY                     = _mm512_mask_add_ps(obsY, obsRepel, obsY, awayY);
+
+        const __mmask16 predRepel = _mm512_mask_cmp_ps_mask(isPred, distSq, predSq, _CMP_LE_OQ);
+        predX                     = _mm512_mask_add_ps(predX, predRepel, predX, awayX);
+        predY                     = _mm512_mask_add_ps(predY, predRepel, predY, awayY);
+    }
+
+    /**
+     * @brief Reduce the accumulators into the sums.
+     * @param sums Sums to add to.
+     */
+    __attribute__((target("avx512f"))) void reduce(NeighbourhoodSums& sums) const {
+        sums.count += count;
+        sums.alignX += _mm512_reduce_add_ps(alignX);
+        sums.alignY += _mm512_reduce_add_ps(alignY);
+        sums.cohesionX += _mm512_reduce_add_ps(cohX);
+        sums.cohesionY += _mm512_reduce_add_ps(cohY);
+        sums.repelX += _mm512_reduce_add_ps(repX);
+        sums.repelY += _mm512_reduce_add_ps(repY);
+        sums.obstacleX += _mm512_reduce_add_ps(obsX);
+        sums.obstacleY += _mm512_reduce_add_ps(obsY);
+        sums.predatorX += _mm512_reduce_add_ps(predX);
+        sums.predatorY += _mm512_reduce_add_ps(predY);
+        sums.hue += _mm512_reduce_add_ps(hueSum);
+        sums.nearestSq = std::min(sums.nearestSq, _mm512_reduce_min_ps(nearest));
+    }
+};
+
+template <typename Policy>
+__attribute__((target("avx512f"))) void
+accumulateRangesAvx512Impl(const PackedNeighbours& packed, const KernelParams& params,
+                           const std::size_t* ranges, const std::size_t numRanges,
+                           NeighbourhoodSums& sums) {
+    const __m512i self = _mm512_set1_epi32(params.self);
+
+    Avx512Kernel kernel(params);
+    for (std::size_t r = 0; r < numRanges; ++r) {
+        const std::size_t begin = ranges[2 * r];
+        const std::size_t end   = ranges[2 * r + 1];
+        for (std::size_t k = begin; k < end; k += 16) {
+            const std::size_t remaining = end - k;
+            const __mmask16   inRange =
+                remaining >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << remaining) - 1u);
+            const __m512i   index   = _mm512_loadu_si512(&packed.index[k]);
+            const __mmask16 notSelf = _mm512_mask_cmpneq_epi32_mask(inRange, index, self);
+            kernel.accumulate<Policy>(packed, Avx512Slots{k}, notSelf);
+        }
+    }
+    kernel.reduce(sums);
+}
+
+template <typename Policy>
+__attribute__((target("avx512f"))) void
+accumulateListAvx512Impl(const PackedNeighbours& packed, const KernelParams& params,
+                         const int32_t* candidates, const std::size_t count,
+                         NeighbourhoodSums& sums) {
+    Avx512Kernel kernel(params);
+    for (std::size_t k = 0; k < count; k += 16) {
+        const std::size_t remaining = count - k;
+        const __mmask16   valid =
+            remaining >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << remaining) - 1u);
+        const __m512i slots = _mm512_maskz_loadu_epi32(valid, candidates + k);
+        kernel.accumulate<Policy>(packed, Avx512Gather{slots, valid}, valid);
+    }
+    kernel.reduce(sums);
+}
+
+template <typename Policy>
+__attribute__((target("avx512f"))) std::size_t
+filterRangesAvx512Impl(const PackedNeighbours& packed, const KernelParams& params,
+                       const std::size_t* ranges, const std::size_t numRanges, int32_t* out) {
+    const __m512  px        = _mm512_set1_ps(params.px);
+    const __m512  py        = _mm512_set1_ps(params.py);
+    const __m512  width     = _mm512_set1_ps(params.width);
+    const __m512  height    = _mm512_set1_ps(params.height);
+    const __m512  halfW     = _mm512_set1_ps(0.5f * params.width);
+    const __m512  halfH     = _mm512_set1_ps(0.5f * params.height);
+    const __m512  radiusSq  = _mm512_set1_ps(params.radiusSq);
+    const __m512i self      = _mm512_set1_epi32(params.self);
+    const __m512i laneIndex =
+        _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    std::size_t count = 0;
+    for (std::size_t r = 0; r < numRanges; ++r) {
+        const std::size_t begin = ranges[2 * r];
+        const std::size_t end   = ranges[2 * r + 1];
+        for (std::size_t k = begin; k < end; k += 16) {
+            const std::size_t remaining = end - k;
+            const __mmask16   inRange =
+                remaining >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << remaining) - 1u);
+            __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(&packed.x[k]), px);
+            __m512 dy = _mm512_sub_ps(_mm512_loadu_ps(&packed.y[k]), py);
+            if constexpr (Policy::WRAPS) {
+                dx = wrap(dx, width, halfW);
+                dy = wrap(dy, height, halfH);
+            }
+            const __m512    distSq  = _mm512_fmadd_ps(dx, dx, _mm512_mul_ps(dy, dy));
+            const __m512i   index   = _mm512_loadu_si512(&packed.index[k]);
+            const __mmask16 notSelf = _mm512_mask_cmpneq_epi32_mask(inRange, index, self);
+            const __mmask16 pass = _mm512_mask_cmp_ps_mask(notSelf, distSq, radiusSq, _CMP_LE_OQ);
+
+            // The slots that pass are packed together and written with a single store.
+            const __m512i slots = _mm512_add_epi32(_mm512_set1_epi32(int32_t(k)), laneIndex);
+            _mm512_mask_compressstoreu_epi32(out + count, pass, slots);
+            count += __builtin_popcount(pass);
+        }
+    }
+    return count;
+}
+
+// GCC ignores the target attribute of a function template that was declared without it, so the
+// kernels declared in kernel_simd.h forward to the implementations above, which are only declared
+// here. Each kernel is instantiated for every boundary policy.
+#define BOIDS_DEFINE_KERNEL(Name, Candidates)                                                      \
+    template <typename Policy>                                                                     \
+    void Name(const PackedNeighbours& packed, const KernelParams& params, Candidates candidates,   \
+              const std::size_t count, NeighbourhoodSums& sums) {                                  \
+        Name##Impl<Policy>(packed, params, candidates, count, sums);                               \
+    }                                                                                              \
+    template void Name<boundary::Periodic>(const PackedNeighbours&, const KernelParams&,           \
+                                           Candidates, const std::size_t, NeighbourhoodSums&);     \
+    template void Name<boundary::Reflecting>(const PackedNeighbours&, const KernelParams&,         \
+                                             Candidates, const std::size_t, NeighbourhoodSums&);   \
+    template void Name<boundary::Unbounded>(const PackedNeighbours&, const KernelParams&,          \
+                                            Candidates, const std::size_t, NeighbourhoodSums&);
+
+BOIDS_DEFINE_KERNEL(accumulateRangesSse, const std::size_t*)
+BOIDS_DEFINE_KERNEL(accumulateRangesAvx2, const std::size_t*)
+BOIDS_DEFINE_KERNEL(accumulateRangesAvx512, const std::size_t*)
+BOIDS_DEFINE_KERNEL(accumulateListSse, const int32_t*)
+BOIDS_DEFINE_KERNEL(accumulateListAvx2, const int32_t*)
+BOIDS_DEFINE_KERNEL(accumulateListAvx512, const int32_t*)
+#undef BOIDS_DEFINE_KERNEL
+
+#define BOIDS_DEFINE_FILTER(Name)                                                                  \
+    template <typename Policy>                                                                     \
+    std::size_t Name(const PackedNeighbours& packed, const KernelParams& params,                   \
+                     const std::size_t* ranges, const std::size_t numRanges, int32_t* out) {       \
+        return Name##Impl<Policy>(packed, params, ranges, numRanges, out);                         \
+    }                                                                                              \
+    template std::size_t Name<boundary::Periodic>(const PackedNeighbours&, const KernelParams&,    \
+                                                  const std::size_t*, const std::size_t,           \
+                                                  int32_t*);                                       \
+    template std::size_t Name<boundary::Reflecting>(const PackedNeighbours&, const KernelParams&,  \
+                                                    const std::size_t*, const std::size_t,         \
+                                                    int32_t*);                                     \
+    template std::size_t Name<boundary::Unbounded>(const PackedNeighbours&, const KernelParams&,   \
+                                                   const std::size_t*, const std::size_t,          \
+                                                   int32_t*);
+
+BOIDS_DEFINE_FILTER(filterRangesSse)
+BOIDS_DEFINE_FILTER(filterRangesAvx2)
+BOIDS_DEFINE_FILTER(filterRangesAvx512)
+#undef BOIDS_DEFINE_FILTER
+
+} // namespace detail
+} // namespace kernel
+} // namespace boids
+
+#endif // BOIDS_KERNEL_X86
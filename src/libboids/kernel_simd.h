@@ -0,0 +1,131 @@
+#pragma once
+
+#include "boundary.h"
+#include "kernel.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define BOIDS_KERNEL_X86 1
+#endif
+
+namespace boids {
+namespace kernel {
+namespace detail {
+
+/**
+ * @brief Width of the padding at the end of the packed arrays, which is one full vector of the
+ * widest instruction set.
+ */
+constexpr std::size_t PACK_PADDING = 16;
+
+// The hue is wrapped in the same way as the displacements of a periodic scene.
+using boundary::wrapDisplacement;
+
+/**
+ * @brief The per-boid values that are broadcast to every lane of the kernel.
+ */
+struct KernelParams {
+    float   px;         ///< X position of the boid.
+    float   py;         ///< Y position of the boid.
+    float   hue;        ///< Hue of the boid.
+    int32_t self;       ///< Index of the boid, which is excluded from its own neighbourhood.
+    float   radiusSq;   ///< Squared neighbourhood radius.
+    float   repelSq;    ///< Squared separation distance for boids and obstacles.
+    float   predatorSq; ///< Squared separation distance for predators.
+    float   width;      ///< Width of the scene.
+    float   height;     ///< Height of the scene.
+};
+
+/**
+ * @brief Accumulate the neighbourhood sums over ranges of packed slots. The SIMD kernels below do
+ * the same for a full vector of candidates at a time. Every kernel is instantiated for each of the
+ * boundary policies in boundary.h.
+ * @param packed Packed flock state.
+ * @param params Per-boid parameters.
+ * @param ranges Array of [begin, end) slot pairs.
+ * @param numRanges Number of ranges.
+ * @param sums Sums to add to.
+ */
+template <typename Policy>
+void accumulateRangesScalar(const PackedNeighbours& packed, const KernelParams& params,
+                            const std::size_t* ranges, const std::size_t numRanges,
+                            NeighbourhoodSums& sums);
+
+/**
+ * @brief Accumulate the neighbourhood sums over a list of packed slots, which may be anywhere in
+ * the arrays. The list must not hold the boid itself. The SIMD kernels below gather a full vector
+ * of candidates at a time.
+ * @param packed Packed flock state.
+ * @param params Per-boid parameters.
+ * @param candidates Array of slots.
+ * @param count Number of slots.
+ * @param sums Sums to add to.
+ */
+template <typename Policy>
+void accumulateListScalar(const PackedNeighbours& packed, const KernelParams& params,
+                          const int32_t* candidates, const std::size_t count,
+                          NeighbourhoodSums& sums);
+
+/**
+ * @brief Write the packed slots in a set of ranges that are within the neighbourhood radius of the
+ * boid, and are not the boid itself. The SIMD kernels below test a full vector of slots at a time.
+ * Only px, py, self, radiusSq, width and height of the parameters are used.
+ * @param packed Packed flock state.
+ * @param params Per-boid parameters.
+ * @param ranges Array of [begin, end) slot pairs.
+ * @param numRanges Number of ranges.
+ * @param out Array to write the slots to, with room for every slot in the ranges.
+ * @return Number of slots written.
+ */
+template <typename Policy>
+std::size_t filterRangesScalar(const PackedNeighbours& packed, const KernelParams& params,
+                               const std::size_t* ranges, const std::size_t numRanges,
+                               int32_t* out);
+
+#ifdef BOIDS_KERNEL_X86
+template <typename Policy>
+void accumulateRangesSse(const PackedNeighbours& packed, const KernelParams& params,
+                         const std::size_t* ranges, const std::size_t numRanges,
+                         NeighbourhoodSums& sums);
+
+template <typename Policy>
+void accumulateRangesAvx2(const PackedNeighbours& packed, const KernelParams& params,
+                          const std::size_t* ranges, const std::size_t numRanges,
+                          NeighbourhoodSums& sums);
+
+template <typename Policy>
+void accumulateRangesAvx512(const PackedNeighbours& packed, const KernelParams& params,
+                            const std::size_t* ranges, const std::size_t numRanges,
+                            NeighbourhoodSums& sums);
+
+template <typename Policy>
+void accumulateListSse(const PackedNeighbours& packed, const KernelParams& params,
+                       const int32_t* candidates, const std::size_t count, NeighbourhoodSums& sums);
+
+template <typename Policy>
+void accumulateListAvx2(const PackedNeighbours& packed, const KernelParams& params,
+                        const int32_t* candidates, const std::size_t count,
+                        NeighbourhoodSums& sums);
+
+template <typename Policy>
+void accumulateListAvx512(const PackedNeighbours& packed, const KernelParams& params,
+                          const int32_t* candidates, const std::size_t count,
+                          NeighbourhoodSums& sums);
+
+template <typename Policy>
+std::size_t filterRangesSse(const PackedNeighbours& packed, const KernelParams& params,
+                            const std::size_t* ranges, const std::size_t numRanges, int32_t* out);
+
+template <typename Policy>
+std::size_t filterRangesAvx2(const PackedNeighbours& packed, const KernelParams& params,
+                             const std::size_t* ranges, const std::size_t numRanges,
+                             int32_t* out);
+
+template <typename Policy>
+std::size_t filterRangesAvx512(const PackedNeighbours& packed, const KernelParams& params,
+                               const std::size_t* ranges, const std::size_t numRanges,
+                               int32_t* out);
+#endif
+
+} // namespace detail
+} // namespace kernel
+} // namespace boids
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace boids {
+
+/**
+ * @brief The MpscQueue class is an unbounded, lock-free queue that any number of threads can push
+ * to, and a single thread pops from.
+ *
+ * This is Dmitry Vyukov's intrusive MPSC queue. Pushing never blocks or waits: it is one
+ * allocation and one atomic exchange. Popping is done by a single consumer thread, which frees the
+ * nodes. Items pushed by the same thread are popped in the order they were pushed.
+ *
+ * A push that is half way through (it has swapped the head but not yet linked the previous node)
+ * hides the items pushed after it until it completes, so tryPop() can briefly report the queue as
+ * empty while other threads are pushing. Those items are picked up by a later pop.
+ */
+template <typename T> class MpscQueue {
+  public:
+    MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+    /**
+     * @brief Destroy the MpscQueue object, along with any items that were never popped.
+     */
+    ~MpscQueue() {
+        T item;
+        while (tryPop(item)) {
+        }
+    }
+
+    MpscQueue(const MpscQueue&)            = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * @brief Push an item onto the queue. This can be called from any thread.
+     * @param item Item to push.
+     */
+    void push(T item) {
+        Node* node = new Node{std::move(item), nullptr};
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * @brief Pop the oldest item off the queue. This must only be called from the consumer thread.
+     * @param item Set to the popped item, if there was one.
+     * @return True if an item was popped, false if the queue was empty.
+     */
+    bool tryPop(T& item) {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+
+        // Step over the stub node, which holds no item.
+        if (tail == &stub_) {
+            if (!next)
+                return false;
+            tail_ = next;
+            tail  = next;
+            next  = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            tail_ = next;
+            item  = std::move(tail->item);
+            delete tail;
+            return true;
+        }
+
+        // The tail is the last node that has been linked in. It can only be popped once there is a
+        // node behind it, so if no push is in progress put the stub back in the queue.
+        if (tail != head_.load(std::memory_order_acquire))
+            return false;
+        stub_.next.store(nullptr, std::memory_order_relaxed);
+        Node* prev = head_.exchange(&stub_, std::memory_order_acq_rel);
+        prev->next.store(&stub_, std::memory_order_release);
+
+        next = tail->next.load(std::memory_order_acquire);
+        if (!next)
+            return false;
+        tail_ = next;
+        item  = std::move(tail->item);
+        delete tail;
+        return true;
+    }
+
+  private:
+    struct Node {
+        T                  item;
+        std::atomic<Node*> next;
+    };
+
+    // Producers only touch the head and consumers only touch the tail, so keep them on separate
+    // cache lines.
+    alignas(64) std::atomic<Node*> head_;
+    alignas(64) Node*              tail_;
+    Node                           stub_{T(), nullptr};
+};
+
+}; // namespace boids
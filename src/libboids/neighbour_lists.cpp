@@ -0,0 +1,103 @@
+#include "neighbour_lists.h"
+#include <algorithm>
+#include <cmath>
+
+namespace boids {
+
+void NeighbourLists::beginBuild(const SpatialGrid& grid, const kernel::PackedNeighbours& packed,
+                                const float& boidRadius, const float& predatorRadius,
+                                const Rect& bounds, const BoundaryMode& boundaryMode) {
+    const std::size_t n = grid.getEntries().size();
+
+    valid_          = true;
+    numSlots_       = n;
+    boidRadius_     = boidRadius;
+    predatorRadius_ = predatorRadius;
+    boundaryMode_   = boundaryMode;
+    bounds_         = bounds;
+
+    if (buffers_.size() < getNumBlocks())
+        buffers_.resize(getNumBlocks());
+    lists_.assign(n, List());
+    refX_.assign(packed.x.begin(), packed.x.begin() + n);
+    refY_.assign(packed.y.begin(), packed.y.begin() + n);
+}
+
+std::size_t NeighbourLists::getNumBlocks() const {
+    return (numSlots_ + BLOCK_SIZE - 1) / BLOCK_SIZE;
+}
+
+void NeighbourLists::build(const SpatialGrid& grid, const kernel::PackedNeighbours& packed,
+                           const std::size_t& begin, const std::size_t& end) {
+    boundary::visit(boundaryMode_, [&](auto policy) {
+        for (std::size_t block = begin; block < end; ++block) {
+            buildBlock<decltype(policy)>(grid, packed, block);
+        }
+    });
+}
+
+template <typename Policy>
+void NeighbourLists::buildBlock(const SpatialGrid& grid, const kernel::PackedNeighbours& packed,
+                                const std::size_t& block) {
+    const std::size_t begin = block * BLOCK_SIZE;
+    const std::size_t end   = std::min(begin + BLOCK_SIZE, numSlots_);
+
+    // The slots are written straight into the buffer, which is only ever grown to fit the largest
+    // build so far, so that it doesn't have to be cleared or refilled from one build to the next.
+    AlignedVector<int32_t>& buffer = buffers_[block];
+    std::size_t             size   = 0;
+    std::size_t             ranges[2 * SpatialGrid::MAX_RANGES];
+    for (std::size_t k = begin; k < end; ++k) {
+        List& list = lists_[k];
+        list.start = uint32_t(size);
+        if (packed.type[k] == BoidType::OBSTACLE)
+            continue;
+
+        const std::size_t numRanges = grid.getSlotRanges(Vec2(packed.x[k], packed.y[k]), ranges);
+        std::size_t       total     = 0;
+        for (std::size_t r = 0; r < numRanges; ++r) {
+            total += ranges[2 * r + 1] - ranges[2 * r];
+        }
+        if (buffer.size() < size + total)
+            buffer.resize(size + total);
+
+        const float radius = packed.type[k] == BoidType::BOID ? boidRadius_ : predatorRadius_;
+        list.count         = uint32_t(kernel::findSlotsWithin<Policy>(
+            packed, k, radius, bounds_, ranges, numRanges, buffer.data() + size));
+        size += list.count;
+    }
+}
+
+bool NeighbourLists::matches(const std::size_t& numSlots, const float& boidRadius,
+                             const float& predatorRadius, const Rect& bounds,
+                             const BoundaryMode& boundaryMode) const {
+    return valid_ && numSlots == numSlots_ && boidRadius == boidRadius_ &&
+           predatorRadius == predatorRadius_ && bounds == bounds_ && boundaryMode == boundaryMode_;
+}
+
+float NeighbourLists::getMaxDisplacement(const kernel::PackedNeighbours& packed) const {
+    const bool  periodic = boundaryMode_ == PERIODIC;
+    const float width    = bounds_.width();
+    const float height   = bounds_.height();
+
+    float maxSq = 0.0f;
+    for (std::size_t k = 0; k < numSlots_; ++k) {
+        float dx = packed.x[k] - refX_[k];
+        float dy = packed.y[k] - refY_[k];
+        if (periodic) {
+            dx = boundary::wrapDisplacement(dx, width);
+            dy = boundary::wrapDisplacement(dy, height);
+        }
+        maxSq = std::max(maxSq, dx * dx + dy * dy);
+    }
+    return std::sqrt(maxSq);
+}
+
+void NeighbourLists::invalidate() { valid_ = false; }
+
+std::span<const int32_t> NeighbourLists::getCandidates(const std::size_t& slot) const {
+    const List& list = lists_[slot];
+    return std::span<const int32_t>(buffers_[slot / BLOCK_SIZE].data() + list.start, list.count);
+}
+
+}; // namespace boids
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "aligned_allocator.h"
+#include "boundary.h"
+#include "kernel.h"
+#include "spatial_grid.h"
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace boids {
+
+/**
+ * @brief The NeighbourLists class caches a Verlet list of candidate neighbours for each slot of a
+ * spatial grid, so that the neighbourhoods can be searched without going back to the grid.
+ *
+ * Each list holds the slots within the list radius of the boid in the slot, i.e. the
+ * neighbourhood radius of its type plus a skin distance, as it was when the lists were built.
+ * While no boid has moved by more than half the skin since then, every boid within the
+ * neighbourhood radius of another is still within its list, so the grid and the lists can be
+ * reused from step to step, and each step only has to filter the cached candidates with the exact
+ * radius. Boids only move a few pixels per step against a radius of tens of pixels, so a skin of
+ * a few steps of motion keeps the lists valid for many steps.
+ *
+ * The lists are keyed by slot rather than by boid index, so a list holds the slots of boids in the
+ * same and neighbouring cells, which are close together in the packed arrays, and the lists of
+ * consecutive slots are next to each other in memory, so they should be read in slot order. The
+ * slots only stay valid for as long as the grid isn't rebuilt, so the flock state must be
+ * repacked with the same grid between builds.
+ *
+ * The lists are built in parallel with kernel::findSlotsWithin(), in blocks of BLOCK_SIZE slots
+ * that each write to a buffer of their own. A block's buffer only depends on the boids in it, not
+ * on the thread that built it, so the buffers stop growing once the flock has settled, and later
+ * builds don't allocate.
+ */
+class NeighbourLists {
+  public:
+    /**
+     * @brief Number of slots in each block of the build.
+     */
+    static constexpr std::size_t BLOCK_SIZE = 1024;
+
+    /**
+     * @brief Start building the lists, recording the positions that the boids are measured
+     * from and the parameters that the lists are built for. This must not be called while lists
+     * are being built.
+     * @param grid Spatial grid built from the flock state, with cells at least as large as the
+     * list radii and no halo.
+     * @param packed Flock state packed in the slot order of the grid.
+     * @param boidRadius List radius of the BOIDs, i.e. their neighbourhood radius plus the skin.
+     * @param predatorRadius List radius of the PREDATORs.
+     * @param bounds Bounds of the scene.
+     * @param boundaryMode Boundary of the scene, which decides whether lists reach across its
+     * edges.
+     */
+    void beginBuild(const SpatialGrid& grid, const kernel::PackedNeighbours& packed,
+                    const float& boidRadius, const float& predatorRadius, const Rect& bounds,
+                    const BoundaryMode& boundaryMode);
+
+    /**
+     * @brief Get the number of blocks that the lists are built in. See build().
+     * @return Number of blocks.
+     */
+    std::size_t getNumBlocks() const;
+
+    /**
+     * @brief Build the lists of a range of blocks. This can be called from several threads at
+     * once, for different ranges, once beginBuild() has been called. OBSTACLE slots get empty
+     * lists, as they are never updated.
+     * @param grid Spatial grid passed to beginBuild().
+     * @param packed Packed flock state passed to beginBuild().
+     * @param begin First block.
+     * @param end Block one past the last.
+     */
+    void build(const SpatialGrid& grid, const kernel::PackedNeighbours& packed,
+               const std::size_t& begin, const std::size_t& end);
+
+    /**
+     * @brief Check whether the lists were built for a given flock and scene.
+     * @param numSlots Number of boids in the flock.
+     * @param boidRadius List radius of the BOIDs.
+     * @param predatorRadius List radius of the PREDATORs.
+     * @param bounds Bounds of the scene.
+     * @param boundaryMode Boundary of the scene.
+     * @return True if the lists have been built for the same parameters, and not invalidated since.
+     */
+    bool matches(const std::size_t& numSlots, const float& boidRadius, const float& predatorRadius,
+                 const Rect& bounds, const BoundaryMode& boundaryMode) const;
+
+    /**
+     * @brief Get the furthest that any boid has moved since the lists were built. In a periodic
+     * scene, a boid that has crossed an edge is measured the short way round.
+     * @param packed Flock state packed in the same slot order as when the lists were built.
+     * @return Largest displacement.
+     */
+    float getMaxDisplacement(const kernel::PackedNeighbours& packed) const;
+
+    /**
+     * @brief Mark the lists as out of date, e.g. because boids have been added or removed, so that
+     * they no longer match any flock until they are rebuilt.
+     */
+    void invalidate();
+
+    /**
+     * @brief Get the list of a slot.
+     * @param slot Slot.
+     * @return Slots of the candidate neighbours, not including the slot itself.
+     */
+    std::span<const int32_t> getCandidates(const std::size_t& slot) const;
+
+  private:
+    /**
+     * @brief Implement build() for a single block and a boundary policy from boundary.h.
+     */
+    template <typename Policy>
+    void buildBlock(const SpatialGrid& grid, const kernel::PackedNeighbours& packed,
+                    const std::size_t& block);
+
+    /**
+     * @brief The List struct locates the list of a slot in the buffer of its block.
+     */
+    struct List {
+        uint32_t start = 0;
+        uint32_t count = 0;
+    };
+
+    bool         valid_          = false;
+    std::size_t  numSlots_       = 0;
+    float        boidRadius_     = 0.0f;
+    float        predatorRadius_ = 0.0f;
+    BoundaryMode boundaryMode_   = PERIODIC;
+    Rect         bounds_;
+
+    std::vector<AlignedVector<int32_t>> buffers_; ///< Candidate slots of the lists in each block.
+    std::vector<List>                   lists_;   ///< List of each slot.
+    std::vector<float>                  refX_;    ///< X position in each slot when built.
+    std::vector<float>                  refY_;    ///< Y position in each slot when built.
+};
+
+}; // namespace boids
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+namespace boids {
+
+/**
+ * @brief The Random class is a small, fast pseudo-random number generator (xoshiro128+), seeded
+ * with SplitMix64.
+ *
+ * Constructing a generator is cheap, so a separate stream can be created for each boid in each
+ * step from a (seed, stream) pair. This makes the random numbers drawn for a boid independent of
+ * which thread updates it, so a run can be reproduced exactly from its seed.
+ */
+class Random {
+  public:
+    /**
+     * @brief Construct a new Random object.
+     * @param seed Seed of the generator.
+     * @param stream Index of the stream to draw from. Different streams with the same seed are
+     * statistically independent.
+     */
+    explicit Random(const uint64_t& seed = 0, const uint64_t& stream = 0) {
+        uint64_t st = stream;
+        uint64_t sm = seed ^ splitMix64(st);
+        for (uint32_t& s : state_) {
+            s = uint32_t(splitMix64(sm) >> 32);
+        }
+    }
+
+    /**
+     * @brief Get the next 32 random bits.
+     * @return Random value.
+     */
+    uint32_t next() {
+        const uint32_t result = state_[0] + state_[3];
+        const uint32_t t      = state_[1] << 9;
+
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = (state_[3] << 11) | (state_[3] >> 21);
+        return result;
+    }
+
+    /**
+     * @brief Generate a random value in the range [0, 1).
+     * @return Random value.
+     */
+    float uniform() { return float(next() >> 8) * (1.0f / 16777216.0f); }
+
+    /**
+     * @brief Generate a random value in the range [minValue, maxValue).
+     * @param minValue Minimum value.
+     * @param maxValue Maximum value.
+     * @return Random value.
+     */
+    float uniform(const float minValue, const float maxValue) {
+        return minValue + (maxValue - minValue) * uniform();
+    }
+
+  private:
+    /**
+     * @brief Advance a SplitMix64 state and return its next output.
+     * @param x State, advanced in place.
+     * @return Output value.
+     */
+    static uint64_t splitMix64(uint64_t& x) {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+        z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z          = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    uint32_t state_[4];
+};
+
+}; // namespace boids
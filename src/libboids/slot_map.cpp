@@ -0,0 +1,82 @@
+#include "slot_map.h"
+#include <stdexcept>
+
+namespace boids {
+
+/**
+ * @brief Get the slot index of a handle.
+ * @param id Handle.
+ * @return Slot index.
+ */
+inline uint32_t slotOf(const BoidId& id) { return id & (SlotMap::MAX_SLOTS - 1); }
+
+/**
+ * @brief Get the generation of a handle.
+ * @param id Handle.
+ * @return Generation.
+ */
+inline uint32_t generationOf(const BoidId& id) { return id >> SlotMap::INDEX_BITS; }
+
+BoidId SlotMap::insert(const std::size_t& index) {
+    uint32_t slot;
+    if (!free_.empty()) {
+        slot = free_.back();
+        free_.pop_back();
+    } else {
+        if (slots_.size() >= MAX_SLOTS)
+            throw std::length_error("SlotMap::insert(): out of boid handles");
+        slot = uint32_t(slots_.size());
+        slots_.push_back({0, 0, false});
+    }
+
+    Slot& s = slots_[slot];
+    s.index = uint32_t(index);
+    s.used  = true;
+    ++size_;
+    return (s.generation << INDEX_BITS) | slot;
+}
+
+void SlotMap::erase(const BoidId& id) {
+    const uint32_t slot = slotOf(id);
+    Slot&          s    = slots_[slot];
+    s.used              = false;
+    --size_;
+
+    // Once a slot has used up all its generations it is retired, so that its handles can never be
+    // mistaken for each other.
+    if (++s.generation <= MAX_GENERATION)
+        free_.push_back(slot);
+}
+
+void SlotMap::clear() {
+    // Push the free slots in reverse, so that the lowest ones are reused first.
+    free_.clear();
+    for (uint32_t slot = uint32_t(slots_.size()); slot-- > 0;) {
+        Slot& s = slots_[slot];
+        if (s.used) {
+            s.used = false;
+            ++s.generation;
+        }
+        if (s.generation <= MAX_GENERATION)
+            free_.push_back(slot);
+    }
+    size_ = 0;
+}
+
+bool SlotMap::contains(const BoidId& id) const {
+    const uint32_t slot = slotOf(id);
+    return slot < slots_.size() && slots_[slot].used &&
+           slots_[slot].generation == generationOf(id);
+}
+
+std::size_t SlotMap::getIndex(const BoidId& id) const { return slots_[slotOf(id)].index; }
+
+void SlotMap::setIndex(const BoidId& id, const std::size_t& index) {
+    slots_[slotOf(id)].index = uint32_t(index);
+}
+
+std::size_t SlotMap::size() const { return size_; }
+
+std::size_t SlotMap::available() const { return free_.size() + (MAX_SLOTS - slots_.size()); }
+
+}; // namespace boids
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "boids.h"
+#include <cstdint>
+#include <vector>
+
+namespace boids {
+
+/**
+ * @brief The SlotMap class hands out stable, generational BoidId handles for boids stored in dense
+ * arrays (i.e. a FlockState), and maps each handle to the current index of its boid.
+ *
+ * A handle packs the index of a slot into its low INDEX_BITS bits, and the generation of that slot
+ * into the remaining high bits. Removing a boid frees its slot and bumps the slot's generation, so
+ * the old handle no longer matches and can be detected as stale. A slot whose generation has run
+ * out is retired rather than reused, so a handle is never given to two boids.
+ *
+ * Adding and removing boids are O(1). The boids themselves stay densely packed: when one is
+ * removed, the last boid is moved into its place (see FlockState::swapRemove()) and its slot is
+ * pointed at its new index with setIndex().
+ */
+class SlotMap {
+  public:
+    static constexpr uint32_t INDEX_BITS     = 22; ///< Bits of a handle holding the slot index.
+    static constexpr uint32_t MAX_SLOTS      = 1u << INDEX_BITS;
+    static constexpr uint32_t MAX_GENERATION = (1u << (32 - INDEX_BITS)) - 1;
+
+    /**
+     * @brief Create a new handle pointing at a given index.
+     * @param index Index of the new boid in the dense arrays.
+     * @return Handle for the new boid.
+     * @throws std::length_error if all the slots are in use or retired.
+     */
+    BoidId insert(const std::size_t& index);
+
+    /**
+     * @brief Free the slot of a handle, so that the handle becomes stale.
+     * @param id Handle to free. This must be a valid handle.
+     */
+    void erase(const BoidId& id);
+
+    /**
+     * @brief Free all the slots, so that every handle given out so far becomes stale.
+     */
+    void clear();
+
+    /**
+     * @brief Check whether a handle refers to a boid that still exists.
+     * @param id Handle.
+     * @return True if the handle is valid, false if it is stale or was never given out.
+     */
+    bool contains(const BoidId& id) const;
+
+    /**
+     * @brief Get the index of the boid that a handle refers to.
+     * @param id Handle. This must be a valid handle.
+     * @return Index of the boid in the dense arrays.
+     */
+    std::size_t getIndex(const BoidId& id) const;
+
+    /**
+     * @brief Point a handle at a new index, after its boid has been moved in the dense arrays.
+     * @param id Handle. This must be a valid handle.
+     * @param index New index of the boid.
+     */
+    void setIndex(const BoidId& id, const std::size_t& index);
+
+    /**
+     * @brief Get the number of valid handles.
+     * @return Number of handles.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Get the number of handles that can still be given out, i.e. the free slots and the
+     * slots that haven't been used yet, but not the retired ones.
+     * @return Number of handles that insert() can give out before it throws.
+     */
+    std::size_t available() const;
+
+  private:
+    struct Slot {
+        uint32_t index;      ///< Index of the boid, while the slot is in use.
+        uint32_t generation; ///< Generation of the slot's handle, past MAX_GENERATION if retired.
+        bool     used;
+    };
+
+    std::vector<Slot>     slots_;
+    std::vector<uint32_t> free_; ///< Slots that can be reused, most recently freed last.
+    std::size_t           size_ = 0;
+};
+
+}; // namespace boids
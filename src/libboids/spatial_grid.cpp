@@ -0,0 +1,269 @@
+#include "spatial_grid.h"
+#include <algorithm>
+#include <math.h>
+
+namespace boids {
+
+// Upper limit on the number of cells along each axis, to keep the grid memory bounded when the
+// neighbourhood radius is very small.
+constexpr std::size_t MAX_CELLS_PER_AXIS = 1024;
+
+SpatialGrid::SpatialGrid()
+    : numCols_(1), numRows_(1), cellWidth_(0.0f), cellHeight_(0.0f), hasHalo_(false) {}
+
+/**
+ * @brief Append a range of slots to the output of a query, merging it into the previous range if
+ * they are contiguous.
+ * @param ranges Output array of [begin, end) pairs.
+ * @param count Number of ranges in the array, which is incremented if a range is added.
+ * @param begin First slot.
+ * @param end Slot one past the last.
+ */
+static void appendRange(std::size_t* ranges, std::size_t& count, const std::size_t& begin,
+                        const std::size_t& end) {
+    if (begin == end)
+        return;
+
+    if (count > 0 && ranges[2 * count - 1] == begin) {
+        ranges[2 * count - 1] = end;
+    } else {
+        ranges[2 * count]     = begin;
+        ranges[2 * count + 1] = end;
+        count++;
+    }
+}
+
+std::size_t SpatialGrid::axisIndex(const float& value, const float& min, const float& size,
+                                   const std::size_t& count) {
+    if (count == 1 || !std::isfinite(value))
+        return 0;
+
+    const long long n = static_cast<long long>(count);
+    const long long i = static_cast<long long>(std::floor((value - min) / size));
+    return static_cast<std::size_t>(((i % n) + n) % n);
+}
+
+/**
+ * @brief Move a coordinate by whole multiples of the scene size into the cell that axisIndex()
+ * buckets it into.
+ * @param value Coordinate value.
+ * @param min Minimum value of the axis in the scene.
+ * @param size Size of a cell along the axis.
+ * @param count Number of cells along the axis.
+ * @param sceneSize Size of the scene along the axis.
+ * @return Coordinate within its cell.
+ */
+static float wrapToCell(const float& value, const float& min, const float& size,
+                        const std::size_t& count, const float& sceneSize) {
+    if (!std::isfinite(value))
+        return value;
+
+    const long long n    = static_cast<long long>(count);
+    const long long i    = static_cast<long long>(std::floor((value - min) / size));
+    const long long cell = ((i % n) + n) % n;
+    return value - float((i - cell) / n) * sceneSize;
+}
+
+void SpatialGrid::rebuild(const std::vector<Boid>& boids, const float& cellSize,
+                          const Rect& bounds) {
+    rebuild(
+        boids.size(), [&boids](const std::size_t& i) { return boids[i].getPosition(); }, cellSize,
+        bounds, nullptr);
+}
+
+void SpatialGrid::rebuild(std::span<const float> xs, std::span<const float> ys,
+                          const float& cellSize, const Rect& bounds, Arena* scratch) {
+    rebuild(
+        xs.size(), [xs, ys](const std::size_t& i) { return Vec2(xs[i], ys[i]); }, cellSize,
+        bounds, scratch);
+}
+
+template <typename PositionFn>
+void SpatialGrid::rebuild(const std::size_t& count, PositionFn position, const float& cellSize,
+                          const Rect& bounds, Arena* scratch) {
+    bounds_  = bounds;
+    hasHalo_ = false;
+
+    const float width  = bounds.width();
+    const float height = bounds.height();
+
+    // A degenerate scene (or cell size) collapses to a single cell, which is equivalent to a
+    // brute-force scan.
+    if (cellSize > 0.0f && width > 0.0f && height > 0.0f) {
+        numCols_ = std::clamp<std::size_t>(std::size_t(width / cellSize), 1, MAX_CELLS_PER_AXIS);
+        numRows_ = std::clamp<std::size_t>(std::size_t(height / cellSize), 1, MAX_CELLS_PER_AXIS);
+    } else {
+        numCols_ = 1;
+        numRows_ = 1;
+    }
+    cellWidth_  = width / float(numCols_);
+    cellHeight_ = height / float(numRows_);
+
+    // Counting sort of the boid indices by cell.
+    const std::size_t numCells = numCols_ * numRows_;
+    cellStart_.assign(numCells + 1, 0);
+    boidCells_.resize(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const Vec2        p   = position(i);
+        const std::size_t col = axisIndex(p.x(), bounds.left(), cellWidth_, numCols_);
+        const std::size_t row = axisIndex(p.y(), bounds.top(), cellHeight_, numRows_);
+        boidCells_[i]         = row * numCols_ + col;
+        cellStart_[boidCells_[i] + 1]++;
+    }
+
+    for (std::size_t c = 0; c < numCells; ++c) {
+        cellStart_[c + 1] += cellStart_[c];
+    }
+
+    // The next free slot of each cell, which is only needed during the rebuild.
+    std::vector<std::size_t> heapOffset;
+    std::span<std::size_t>   offset;
+    if (scratch) {
+        offset = scratch->allocate<std::size_t>(numCells);
+    } else {
+        heapOffset.resize(numCells);
+        offset = heapOffset;
+    }
+    std::copy(cellStart_.begin(), cellStart_.end() - 1, offset.begin());
+
+    cellEntries_.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        cellEntries_[offset[boidCells_[i]]++] = i;
+    }
+}
+
+std::size_t SpatialGrid::getSlotRanges(const Vec2& pos, std::size_t* ranges) const {
+    if (cellEntries_.empty())
+        return 0;
+
+    const std::size_t col = axisIndex(pos.x(), bounds_.left(), cellWidth_, numCols_);
+    const std::size_t row = axisIndex(pos.y(), bounds_.top(), cellHeight_, numRows_);
+
+    // With fewer than three cells along an axis the 3x3 block would visit the same cell more than
+    // once, so just visit every cell along that axis instead.
+    const std::size_t nCols = std::min<std::size_t>(numCols_, 3);
+    const std::size_t nRows = std::min<std::size_t>(numRows_, 3);
+    const std::size_t col0  = numCols_ < 3 ? 0 : col + numCols_ - 1;
+    const std::size_t row0  = numRows_ < 3 ? 0 : row + numRows_ - 1;
+
+    std::size_t count = 0;
+    for (std::size_t r = 0; r < nRows; ++r) {
+        const std::size_t cellRow = (row0 + r) % numRows_;
+        for (std::size_t c = 0; c < nCols; ++c) {
+            const std::size_t cell = cellRow * numCols_ + (col0 + c) % numCols_;
+            appendRange(ranges, count, cellStart_[cell], cellStart_[cell + 1]);
+        }
+    }
+    return count;
+}
+
+std::size_t SpatialGrid::haloIndex(const std::size_t& col, const std::size_t& row) const {
+    if (row == 0)
+        return col;
+    if (row == numRows_ + 1)
+        return numCols_ + 2 + col;
+
+    const std::size_t left = 2 * (numCols_ + 2) + row - 1;
+    return col == 0 ? left : left + numRows_;
+}
+
+void SpatialGrid::buildHalo() {
+    hasHalo_ = numCols_ >= 3 && numRows_ >= 3;
+    if (!hasHalo_)
+        return;
+
+    const float width  = bounds_.width();
+    const float height = bounds_.height();
+
+    // Columns and rows are counted from the halo here, so the grid itself covers columns 1 to
+    // numCols_ and rows 1 to numRows_.
+    const std::size_t numHaloCells = 2 * (numCols_ + 2) + 2 * numRows_;
+    haloCells_.resize(numHaloCells);
+    haloStart_.resize(numHaloCells + 1);
+
+    const auto setCell = [&](const std::size_t& col, const std::size_t& row) {
+        const std::size_t sourceCol = (col + numCols_ - 1) % numCols_;
+        const std::size_t sourceRow = (row + numRows_ - 1) % numRows_;
+
+        HaloCell& cell = haloCells_[haloIndex(col, row)];
+        cell.source    = sourceRow * numCols_ + sourceCol;
+        cell.dx        = col == 0 ? -width : (col == numCols_ + 1 ? width : 0.0f);
+        cell.dy        = row == 0 ? -height : (row == numRows_ + 1 ? height : 0.0f);
+    };
+    for (std::size_t col = 0; col < numCols_ + 2; ++col) {
+        setCell(col, 0);
+        setCell(col, numRows_ + 1);
+    }
+    for (std::size_t row = 1; row <= numRows_; ++row) {
+        setCell(0, row);
+        setCell(numCols_ + 1, row);
+    }
+
+    haloStart_[0] = 0;
+    for (std::size_t h = 0; h < numHaloCells; ++h) {
+        const std::size_t source = haloCells_[h].source;
+        haloStart_[h + 1]        = haloStart_[h] + cellStart_[source + 1] - cellStart_[source];
+    }
+}
+
+bool SpatialGrid::hasHalo() const { return hasHalo_; }
+
+Vec2 SpatialGrid::getHaloPosition(const Vec2& pos) const {
+    return Vec2(wrapToCell(pos.x(), bounds_.left(), cellWidth_, numCols_, bounds_.width()),
+                wrapToCell(pos.y(), bounds_.top(), cellHeight_, numRows_, bounds_.height()));
+}
+
+std::size_t SpatialGrid::getNumGhosts() const { return hasHalo_ ? haloStart_.back() : 0; }
+
+std::size_t SpatialGrid::getHaloSlotRanges(const Vec2& pos, std::size_t* ranges) const {
+    const std::size_t numSlots = cellEntries_.size();
+    if (numSlots == 0)
+        return 0;
+
+    // Counted from the halo, the 3x3 block around the cell of the position starts at the column
+    // and row of the cell in the grid.
+    const std::size_t col0 = axisIndex(pos.x(), bounds_.left(), cellWidth_, numCols_);
+    const std::size_t row0 = axisIndex(pos.y(), bounds_.top(), cellHeight_, numRows_);
+    const std::size_t col1 = col0 + 2;
+
+    std::size_t count = 0;
+    for (std::size_t row = row0; row <= row0 + 2; ++row) {
+        if (row == 0 || row == numRows_ + 1) {
+            const std::size_t begin = haloStart_[haloIndex(col0, row)];
+            const std::size_t end   = haloStart_[haloIndex(col1, row) + 1];
+            appendRange(ranges, count, numSlots + begin, numSlots + end);
+            continue;
+        }
+
+        if (col0 == 0) {
+            const std::size_t h = haloIndex(0, row);
+            appendRange(ranges, count, numSlots + haloStart_[h], numSlots + haloStart_[h + 1]);
+        }
+
+        const std::size_t rowStart = (row - 1) * numCols_;
+        const std::size_t first    = std::max<std::size_t>(col0, 1) - 1;
+        const std::size_t last     = std::min(col1, numCols_);
+        appendRange(ranges, count, cellStart_[rowStart + first], cellStart_[rowStart + last]);
+
+        if (col1 == numCols_ + 1) {
+            const std::size_t h = haloIndex(col1, row);
+            appendRange(ranges, count, numSlots + haloStart_[h], numSlots + haloStart_[h + 1]);
+        }
+    }
+    return count;
+}
+
+const std::vector<std::size_t>& SpatialGrid::getEntries() const { return cellEntries_; }
+
+void SpatialGrid::getCandidates(const Vec2& pos, std::vector<std::size_t>& candidates) const {
+    candidates.clear();
+    forEachCandidate(pos, [&candidates](const std::size_t& i) { candidates.push_back(i); });
+    std::sort(candidates.begin(), candidates.end());
+}
+
+std::size_t SpatialGrid::getNumCols() const { return numCols_; }
+
+std::size_t SpatialGrid::getNumRows() const { return numRows_; }
+
+}; // namespace boids
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "arena.h"
+#include "boids.h"
+#include "types.h"
+#include <span>
+#include <vector>
+
+namespace boids {
+
+/**
+ * @brief The SpatialGrid class is a uniform cell grid used to accelerate neighbourhood queries.
+ *
+ * The scene is split into equally sized cells that are at least as large as the requested cell
+ * size, and every boid is bucketed into the cell that contains it. The grid wraps around the scene
+ * bounds (the same way the simulation space does), so querying a position returns the boids in the
+ * 3x3 block of cells around it, including cells on the opposite side of the scene.
+ *
+ * The returned candidates are a superset of the neighbourhood. The caller is expected to filter
+ * them with an exact distance check.
+ *
+ * For a periodic scene, the grid can also lay out a halo of ghost cells around its edges (see
+ * buildHalo()), so that a query never has to wrap around the scene.
+ */
+class SpatialGrid {
+  public:
+    SpatialGrid();
+
+    /**
+     * @brief Rebuild the grid from a vector of Boids.
+     * @param boids Boids to bucket into the grid. The indices returned by queries refer to this
+     * vector.
+     * @param cellSize Minimum size of a cell. This should be at least the query radius.
+     * @param bounds Bounds of the (wrapped) scene.
+     */
+    void rebuild(const std::vector<Boid>& boids, const float& cellSize, const Rect& bounds);
+
+    /**
+     * @brief Rebuild the grid from arrays of boid positions.
+     * @param xs X coordinates of the boids. The indices returned by queries refer to this array.
+     * @param ys Y coordinates of the boids.
+     * @param cellSize Minimum size of a cell. This should be at least the query radius.
+     * @param bounds Bounds of the (wrapped) scene.
+     * @param scratch Arena to take the temporary arrays of the rebuild from, or nullptr to
+     * allocate them on the heap.
+     */
+    void rebuild(std::span<const float> xs, std::span<const float> ys, const float& cellSize,
+                 const Rect& bounds, Arena* scratch = nullptr);
+
+    /**
+     * @brief Get the indices of all the Boids in the cells surrounding a given position.
+     *
+     * The indices are written to the output vector in ascending order, so the candidates are
+     * visited in the same order as the vector the grid was built from.
+     *
+     * @param pos Position to query around.
+     * @param candidates Output vector of Boid indices. This is cleared before being filled.
+     */
+    void getCandidates(const Vec2& pos, std::vector<std::size_t>& candidates) const;
+
+    /**
+     * @brief Maximum number of slot ranges returned by getSlotRanges().
+     */
+    static constexpr std::size_t MAX_RANGES = 9;
+
+    /**
+     * @brief Get the ranges of slots covering the cells surrounding a given position.
+     *
+     * The grid stores the Boid indices in slots sorted by cell (see getEntries()), so each cell is
+     * a contiguous range of slots. Neighbouring cells within the same row are also contiguous, and
+     * are merged into a single range.
+     *
+     * @param pos Position to query around.
+     * @param ranges Output array of at least 2 * MAX_RANGES values, filled with [begin, end) pairs.
+     * @return Number of ranges written.
+     */
+    std::size_t getSlotRanges(const Vec2& pos, std::size_t* ranges) const;
+
+    /**
+     * @brief Lay out a ring of ghost cells around the grid. Each ghost cell stands for the cell on
+     * the opposite edge of the scene, and its slots hold copies of the boids in that cell, shifted
+     * by the size of the scene. The halo is dropped by the next rebuild, and isn't laid out for a
+     * grid with fewer than three cells along an axis, as the 3x3 block around a boid would then
+     * reach its own copies.
+     */
+    void buildHalo();
+
+    /**
+     * @brief Check whether the grid has a halo of ghost cells.
+     * @return True if buildHalo() has laid out a halo since the last rebuild.
+     */
+    bool hasHalo() const;
+
+    /**
+     * @brief Get the number of ghost slots in the halo.
+     * @return Number of ghost slots, or 0 if there is no halo.
+     */
+    std::size_t getNumGhosts() const;
+
+    /**
+     * @brief Get the ranges of slots covering the cells surrounding a given position, taking the
+     * cells beyond the edges of the scene from the halo rather than wrapping around it. The ghost
+     * slots follow on from the slots of the grid, so the displacement to the boid in any of the
+     * returned slots is a plain subtraction, once the ghosts have been shifted.
+     * @param pos Position to query around, as returned by getHaloPosition().
+     * @param ranges Output array of at least 2 * MAX_RANGES values, filled with [begin, end) pairs.
+     * @return Number of ranges written.
+     */
+    std::size_t getHaloSlotRanges(const Vec2& pos, std::size_t* ranges) const;
+
+    /**
+     * @brief Get a position as the halo sees it, i.e. moved by whole multiples of the scene size
+     * into the cell that it is bucketed into. This leaves positions within the scene unchanged.
+     * @param pos Position.
+     * @return Position within the cell.
+     */
+    Vec2 getHaloPosition(const Vec2& pos) const;
+
+    /**
+     * @brief Call a function for each ghost cell of the halo, in slot order.
+     * @param fn Function called with the first slot of the ghost cell, counted from the first
+     * ghost slot, the first slot of the cell it copies, the number of slots, and the X and Y shift
+     * of the copies.
+     */
+    template <typename Fn> void forEachHaloCell(Fn fn) const {
+        if (!hasHalo_)
+            return;
+
+        for (std::size_t h = 0; h < haloCells_.size(); ++h) {
+            const HaloCell& cell = haloCells_[h];
+            fn(haloStart_[h], cellStart_[cell.source], haloStart_[h + 1] - haloStart_[h], cell.dx,
+               cell.dy);
+        }
+    }
+
+    /**
+     * @brief Get the Boid index stored in each slot, with the slots sorted by cell.
+     * @return Vector of Boid indices.
+     */
+    const std::vector<std::size_t>& getEntries() const;
+
+    /**
+     * @brief Call a function for the index of every Boid in the cells surrounding a given
+     * position. Unlike getCandidates(), this doesn't allocate and the indices are visited cell by
+     * cell rather than in ascending order.
+     * @param pos Position to query around.
+     * @param fn Function called with each Boid index.
+     */
+    template <typename Fn> void forEachCandidate(const Vec2& pos, Fn fn) const {
+        std::size_t       ranges[2 * MAX_RANGES];
+        const std::size_t numRanges = getSlotRanges(pos, ranges);
+        for (std::size_t r = 0; r < numRanges; ++r) {
+            for (std::size_t k = ranges[2 * r]; k < ranges[2 * r + 1]; ++k) {
+                fn(cellEntries_[k]);
+            }
+        }
+    }
+
+    /**
+     * @brief Get the number of columns in the grid.
+     * @return Number of columns.
+     */
+    std::size_t getNumCols() const;
+
+    /**
+     * @brief Get the number of rows in the grid.
+     * @return Number of rows.
+     */
+    std::size_t getNumRows() const;
+
+  private:
+    /**
+     * @brief Rebuild the grid for a number of boids, reading each boid position through a
+     * callable.
+     * @param count Number of boids.
+     * @param position Callable returning the position of the boid at a given index.
+     * @param cellSize Minimum size of a cell.
+     * @param bounds Bounds of the (wrapped) scene.
+     * @param scratch Arena for the temporary arrays, or nullptr to use the heap.
+     */
+    template <typename PositionFn>
+    void rebuild(const std::size_t& count, PositionFn position, const float& cellSize,
+                 const Rect& bounds, Arena* scratch);
+
+    /**
+     * @brief Get the (wrapped) column or row index of a coordinate along one axis.
+     * @param value Coordinate value.
+     * @param min Minimum value of the axis in the scene.
+     * @param size Size of a cell along the axis.
+     * @param count Number of cells along the axis.
+     * @return Cell index in the range [0, count).
+     */
+    static std::size_t axisIndex(const float& value, const float& min, const float& size,
+                                 const std::size_t& count);
+
+    /**
+     * @brief Get the index of a ghost cell in the halo. The halo is numbered by its top row, then
+     * its bottom row, then its left and right columns, so each of its rows is contiguous.
+     * @param col Column, counted from the left column of the halo.
+     * @param row Row, counted from the top row of the halo.
+     * @return Index of the ghost cell.
+     */
+    std::size_t haloIndex(const std::size_t& col, const std::size_t& row) const;
+
+    /**
+     * @brief The HaloCell struct describes the cell copied into a ghost cell.
+     */
+    struct HaloCell {
+        std::size_t source = 0;    ///< Index of the copied cell.
+        float       dx     = 0.0f; ///< Shift of the copies.
+        float       dy     = 0.0f;
+    };
+
+    Rect                     bounds_;
+    std::size_t              numCols_;
+    std::size_t              numRows_;
+    float                    cellWidth_;
+    float                    cellHeight_;
+    std::vector<std::size_t> cellStart_;   ///< Offset into cellEntries_ for each cell (+1 end).
+    std::vector<std::size_t> cellEntries_; ///< Boid indices, sorted by cell.
+    std::vector<std::size_t> boidCells_;   ///< Cell index of each boid.
+    bool                     hasHalo_;
+    std::vector<HaloCell>    haloCells_; ///< Cell copied into each ghost cell.
+    std::vector<std::size_t> haloStart_; ///< Offset of each ghost cell from the first ghost (+1).
+};
+
+}; // namespace boids
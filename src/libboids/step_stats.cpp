@@ -0,0 +1,73 @@
+#include "step_stats.h"
+#include <algorithm>
+
+namespace boids {
+
+// Allocations recorded on each thread. This is a plain integer, so it is safe to touch from
+// inside operator new.
+thread_local uint64_t threadAllocations = 0;
+
+double StepStats::getMeanNeighbours() const {
+    return numBoids > 0 ? double(neighbours) / double(numBoids) : 0.0;
+}
+
+StepStatsWindow::StepStatsWindow(const std::size_t& capacity)
+    : steps_(std::max<std::size_t>(capacity, 1)), next_(0), size_(0) {}
+
+void StepStatsWindow::push(const StepStats& stats) {
+    steps_[next_] = stats;
+    next_         = (next_ + 1) % steps_.size();
+    size_         = std::min(size_ + 1, steps_.size());
+}
+
+void StepStatsWindow::clear() {
+    next_ = 0;
+    size_ = 0;
+}
+
+std::size_t StepStatsWindow::size() const { return size_; }
+
+std::size_t StepStatsWindow::capacity() const { return steps_.size(); }
+
+const StepStats& StepStatsWindow::at(const std::size_t& i) const {
+    return steps_[(next_ + steps_.size() - size_ + i) % steps_.size()];
+}
+
+StepStats StepStatsWindow::getMean() const {
+    StepStats mean;
+    if (size_ == 0)
+        return mean;
+
+    for (std::size_t i = 0; i < size_; ++i) {
+        const StepStats& s = at(i);
+        mean.totalNs += s.totalNs;
+        mean.commandsNs += s.commandsNs;
+        mean.gridNs += s.gridNs;
+        mean.neighboursNs += s.neighboursNs;
+        mean.integrateNs += s.integrateNs;
+        mean.numBoids += s.numBoids;
+        mean.distanceTests += s.distanceTests;
+        mean.neighbours += s.neighbours;
+        mean.maxNeighbours = std::max(mean.maxNeighbours, s.maxNeighbours);
+        mean.allocations += s.allocations;
+        mean.listBuilds += s.listBuilds;
+    }
+
+    mean.step = at(size_ - 1).step;
+    mean.totalNs /= size_;
+    mean.commandsNs /= size_;
+    mean.gridNs /= size_;
+    mean.neighboursNs /= size_;
+    mean.integrateNs /= size_;
+    mean.numBoids /= size_;
+    mean.distanceTests /= size_;
+    mean.neighbours /= size_;
+    mean.allocations /= size_;
+    return mean;
+}
+
+void recordAllocation() { ++threadAllocations; }
+
+uint64_t getThreadAllocations() { return threadAllocations; }
+
+}; // namespace boids
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace boids {
+
+/**
+ * @brief The StepStats struct holds the timings and counters recorded for a single Flock::update().
+ *
+ * The stats are only recorded when libboids is built with BOIDS_STEP_STATS defined (the
+ * BOIDS_STEP_STATS CMake option). Otherwise the recording code is compiled out, and every field is
+ * left at zero.
+ *
+ * The neighbour search and force accumulation are fused into a single kernel, so they are timed
+ * together. The neighbours and integrate times are summed over all the threads, so with more than
+ * one thread they are CPU time rather than wall time. Each thread times its share of the boids as
+ * a whole, and splits that time between the two phases in the proportion measured on a sample of
+ * the boids, so they are estimates, while their sum is measured.
+ */
+struct StepStats {
+    uint64_t step = 0; ///< Index of the step, counted since the flock was seeded.
+
+    uint64_t totalNs      = 0; ///< Wall time of the whole update.
+    uint64_t commandsNs   = 0; ///< Wall time spent applying posted commands.
+    uint64_t gridNs       = 0; ///< Wall time spent building the grid (and lists) and packing.
+    uint64_t neighboursNs = 0; ///< Time spent searching and accumulating the neighbourhoods.
+    uint64_t integrateNs  = 0; ///< Time spent applying the forces, moving and recolouring.
+
+    uint64_t numBoids       = 0; ///< Number of boids that were updated.
+    uint64_t distanceTests  = 0; ///< Number of candidate neighbours whose distance was tested.
+    uint64_t neighbours     = 0; ///< Number of BOID neighbours found, over all the updated boids.
+    uint64_t maxNeighbours  = 0; ///< Most BOID neighbours found for a single boid.
+    uint64_t allocations    = 0; ///< Heap allocations made by the update. See recordAllocation().
+    uint64_t listBuilds     = 0; ///< Neighbour list builds, see Flock::setNeighbourSkin().
+
+    /**
+     * @brief Get the mean number of BOID neighbours found per updated boid.
+     * @return Mean number of neighbours, or zero if no boids were updated.
+     */
+    double getMeanNeighbours() const;
+};
+
+/**
+ * @brief The ThreadStepCounters struct holds the counters that a single thread accumulates while
+ * updating its share of the boids, which are summed into the StepStats at the end of the update.
+ * It fills a whole cache line, so that the threads don't write to the same line.
+ */
+struct alignas(64) ThreadStepCounters {
+    uint64_t numBoids      = 0;
+    uint64_t neighboursNs  = 0;
+    uint64_t integrateNs   = 0;
+    uint64_t distanceTests = 0;
+    uint64_t neighbours    = 0;
+    uint64_t maxNeighbours = 0;
+    uint64_t allocations   = 0;
+};
+
+/**
+ * @brief The StepStatsWindow class keeps the stats of the most recent steps in a fixed size ring
+ * buffer, so that they can be averaged over without allocating.
+ */
+class StepStatsWindow {
+  public:
+    /**
+     * @brief Construct a new StepStatsWindow object.
+     * @param capacity Number of steps to keep. A value of zero is treated as one.
+     */
+    explicit StepStatsWindow(const std::size_t& capacity = 120);
+
+    /**
+     * @brief Add the stats of a step, replacing the oldest step if the window is full.
+     * @param stats Stats to add.
+     */
+    void push(const StepStats& stats);
+
+    /**
+     * @brief Remove all the steps from the window.
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of steps in the window.
+     * @return Number of steps.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Get the maximum number of steps the window keeps.
+     * @return Capacity.
+     */
+    std::size_t capacity() const;
+
+    /**
+     * @brief Get the stats of a step in the window.
+     * @param i Index of the step, where 0 is the oldest and size() - 1 the most recent.
+     * @return Stats of the step.
+     */
+    const StepStats& at(const std::size_t& i) const;
+
+    /**
+     * @brief Get the mean of every field over the steps in the window. The step is set to that of
+     * the most recent step, maxNeighbours to the maximum over the window, and listBuilds to the
+     * total over the window, as the lists are only rebuilt every few steps.
+     * @return Mean stats, or default stats if the window is empty.
+     */
+    StepStats getMean() const;
+
+  private:
+    std::vector<StepStats> steps_;
+    std::size_t            next_; ///< Index that the next step is written to.
+    std::size_t            size_;
+};
+
+/**
+ * @brief Count a heap allocation made on the calling thread, so that it is included in the
+ * StepStats of any update it happens during.
+ *
+ * libboids doesn't replace the global operator new itself, as that would affect the whole program.
+ * A program that wants the allocation counts replaces operator new with one that calls this.
+ */
+void recordAllocation();
+
+/**
+ * @brief Get the number of allocations recorded on the calling thread so far.
+ * @return Number of allocations.
+ */
+uint64_t getThreadAllocations();
+
+}; // namespace boids
@@ -0,0 +1,107 @@
+#include "thread_pool.h"
+#include "trace.h"
+#include <algorithm>
+
+namespace boids {
+
+// Number of chunks each thread gets on average. Using more than one chunk per thread balances out
+// the uneven cost of boids in dense and sparse parts of the scene.
+constexpr std::size_t CHUNKS_PER_THREAD = 8;
+
+ThreadPool::ThreadPool(const std::size_t& numThreads)
+    : stop_(false), generation_(0), busy_(0), fn_(nullptr), count_(0), chunkSize_(1),
+      nextChunk_(0) {
+    for (std::size_t i = 1; i < std::max<std::size_t>(numThreads, 1); ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    startCv_.notify_all();
+    for (std::thread& t : workers_) {
+        t.join();
+    }
+}
+
+std::size_t ThreadPool::getNumThreads() const { return workers_.size() + 1; }
+
+void ThreadPool::parallelFor(const std::size_t& count, const RangeFn& fn,
+                             const std::size_t& chunkSize) {
+    if (count == 0)
+        return;
+
+    if (workers_.empty()) {
+        fn(0, count, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fn_        = &fn;
+        count_     = count;
+        chunkSize_ = chunkSize > 0
+                         ? chunkSize
+                         : std::max<std::size_t>(1, count / (getNumThreads() * CHUNKS_PER_THREAD));
+        nextChunk_ = 0;
+        busy_      = workers_.size();
+        generation_++;
+    }
+    startCv_.notify_all();
+
+    runChunks(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCv_.wait(lock, [this] { return busy_ == 0; });
+    fn_ = nullptr;
+
+    if (error_) {
+        std::exception_ptr error = error_;
+        error_                   = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::workerLoop(const std::size_t worker) {
+    BOIDS_TRACE_THREAD_NAME("boids::ThreadPool worker");
+
+    std::size_t generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            startCv_.wait(lock, [&] { return stop_ || generation_ != generation; });
+            if (stop_)
+                return;
+            generation = generation_;
+        }
+
+        runChunks(worker);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busy_ == 0)
+            doneCv_.notify_one();
+    }
+}
+
+void ThreadPool::runChunks(const std::size_t& worker) {
+    while (true) {
+        const std::size_t begin = nextChunk_.fetch_add(chunkSize_);
+        if (begin >= count_)
+            return;
+        try {
+            (*fn_)(begin, std::min(begin + chunkSize_, count_), worker);
+        } catch (...) {
+            // Keep the first exception to rethrow on the calling thread, and skip the remaining
+            // chunks.
+            std::lock_guard<std::mutex> lock(errorMutex_);
+            if (!error_)
+                error_ = std::current_exception();
+            nextChunk_ = count_;
+        }
+    }
+}
+
+}; // namespace boids
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace boids {
+
+/**
+ * @brief The ThreadPool class is a persistent pool of worker threads used to split loops across
+ * multiple cores.
+ *
+ * The worker threads are created once, when the pool is constructed, and sleep between jobs. The
+ * thread calling parallelFor() takes part in the work as well, so a pool of N threads owns N - 1
+ * worker threads and a pool of one thread runs everything on the calling thread.
+ */
+class ThreadPool {
+  public:
+    /**
+     * @brief The RangeFn class refers to the function called for each chunk of a parallelFor()
+     * loop, with the index of the first element in the chunk, the index one past the last, and the
+     * index of the thread running it, in the range [0, getNumThreads()).
+     *
+     * Unlike a std::function, this doesn't copy the function (so it never allocates, however much
+     * a lambda captures), and only refers to it for the duration of the parallelFor() call.
+     */
+    class RangeFn {
+      public:
+        /**
+         * @brief Construct a new RangeFn object referring to a function.
+         * @param fn Function, which must outlive the RangeFn.
+         */
+        template <typename Fn>
+        RangeFn(const Fn& fn)
+            : fn_(&fn), call_([](const void* f, std::size_t begin, std::size_t end,
+                                 std::size_t worker) {
+                  (*static_cast<const Fn*>(f))(begin, end, worker);
+              }) {}
+
+        void operator()(std::size_t begin, std::size_t end, std::size_t worker) const {
+            call_(fn_, begin, end, worker);
+        }
+
+      private:
+        const void* fn_;
+        void (*call_)(const void*, std::size_t, std::size_t, std::size_t);
+    };
+
+    /**
+     * @brief Construct a new ThreadPool object.
+     * @param numThreads Total number of threads, including the calling thread. A value of zero is
+     * treated as one.
+     */
+    explicit ThreadPool(const std::size_t& numThreads);
+
+    /**
+     * @brief Stop and join all the worker threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Get the total number of threads, including the calling thread.
+     * @return Number of threads.
+     */
+    std::size_t getNumThreads() const;
+
+    /**
+     * @brief Run a function over the range [0, count), split into chunks that are shared between
+     * all the threads. This blocks until every chunk has been processed.
+     *
+     * If the function throws, the remaining chunks are skipped and the first exception is
+     * rethrown on the calling thread.
+     *
+     * @param count Number of elements in the range.
+     * @param fn Function to call for each chunk.
+     * @param chunkSize Number of elements in each chunk, or zero to split the range into a few
+     * chunks per thread. A chunk size of one hands out a single element at a time, which suits
+     * loops over a few long and uneven tasks.
+     */
+    void parallelFor(const std::size_t& count, const RangeFn& fn, const std::size_t& chunkSize = 0);
+
+  private:
+    /**
+     * @brief Main loop of a worker thread.
+     * @param worker Index of the worker thread.
+     */
+    void workerLoop(const std::size_t worker);
+
+    /**
+     * @brief Process chunks of the current job until there are none left.
+     * @param worker Index of the thread doing the work.
+     */
+    void runChunks(const std::size_t& worker);
+
+    std::vector<std::thread> workers_;
+    std::mutex               mutex_;
+    std::condition_variable  startCv_;
+    std::condition_variable  doneCv_;
+    bool                     stop_;
+    std::size_t              generation_; ///< Incremented for every new job.
+    std::size_t              busy_;       ///< Number of worker threads still running a job.
+
+    const RangeFn*           fn_;
+    std::size_t              count_;
+    std::size_t              chunkSize_;
+    std::atomic<std::size_t> nextChunk_;
+    std::mutex               errorMutex_;
+    std::exception_ptr       error_;
+};
+
+}; // namespace boids
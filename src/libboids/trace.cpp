@@ -0,0 +1,258 @@
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+
+namespace boids::trace {
+
+namespace {
+
+enum EventKind : uint64_t { ZONE, FLOW_START, FLOW_END };
+
+/**
+ * @brief A single recorded event. Every field is atomic, so that a writer overwriting the event
+ * while it is being read is a detectable race rather than undefined behaviour.
+ */
+struct Event {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t>    kind{ZONE};
+    std::atomic<uint64_t>    startNs{0};
+    std::atomic<uint64_t>    durNs{0};
+    std::atomic<uint64_t>    id{0};
+};
+
+/**
+ * @brief Plain copy of an Event, taken while writing the trace.
+ */
+struct EventCopy {
+    const char* name;
+    uint64_t    kind;
+    uint64_t    startNs;
+    uint64_t    durNs;
+    uint64_t    id;
+};
+
+/**
+ * @brief The ring buffer of events recorded by a single thread.
+ *
+ * Only the owning thread writes events. It bumps claimed before writing an event and committed
+ * after, so a reader can copy the committed events and then use claimed to tell which of them
+ * may have been overwritten while it was copying (the same scheme as a seqlock).
+ */
+struct ThreadBuffer {
+    std::unique_ptr<Event[]> events{new Event[EVENTS_PER_THREAD]};
+    uint32_t                 tid = 0;
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t>    claimed{0};
+    std::atomic<uint64_t>    committed{0};
+    ThreadBuffer*            next = nullptr;
+};
+
+const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+std::atomic<bool>          enabled{false};
+std::atomic<ThreadBuffer*> buffers{nullptr}; ///< List of every thread's buffer, newest first.
+std::atomic<uint32_t>      nextTid{1};
+
+// Buffer of the calling thread, created when it records its first event. The buffers are never
+// freed, so that the events of threads which have exited are still written out.
+thread_local ThreadBuffer* threadBuffer = nullptr;
+thread_local const char*   threadName   = nullptr;
+
+/**
+ * @brief Get the time since the trace was started.
+ * @return Time in nanoseconds.
+ */
+uint64_t nowNs() {
+    const auto elapsed = std::chrono::steady_clock::now() - origin;
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+/**
+ * @brief Get the buffer of the calling thread, creating and registering it on first use.
+ * @return Buffer of the calling thread.
+ */
+ThreadBuffer& getThreadBuffer() {
+    if (!threadBuffer) {
+        ThreadBuffer* b = new ThreadBuffer();
+        b->tid          = nextTid.fetch_add(1, std::memory_order_relaxed);
+        b->name.store(threadName, std::memory_order_relaxed);
+        b->next         = buffers.load(std::memory_order_relaxed);
+        while (!buffers.compare_exchange_weak(b->next, b, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+        }
+        threadBuffer = b;
+    }
+    return *threadBuffer;
+}
+
+/**
+ * @brief Record an event on the calling thread.
+ * @param kind Kind of event.
+ * @param name Name of the event.
+ * @param startNs Start time.
+ * @param durNs Duration, for zones.
+ * @param id ID, for flows.
+ */
+void record(const EventKind kind, const char* name, const uint64_t startNs, const uint64_t durNs,
+            const uint64_t id) {
+    ThreadBuffer&  b = getThreadBuffer();
+    const uint64_t n = b.committed.load(std::memory_order_relaxed);
+    b.claimed.store(n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Event& e = b.events[n % EVENTS_PER_THREAD];
+    e.name.store(name, std::memory_order_relaxed);
+    e.kind.store(kind, std::memory_order_relaxed);
+    e.startNs.store(startNs, std::memory_order_relaxed);
+    e.durNs.store(durNs, std::memory_order_relaxed);
+    e.id.store(id, std::memory_order_relaxed);
+
+    b.committed.store(n + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Copy the events of a buffer that are still intact.
+ * @param b Buffer to copy.
+ * @param out Set to the copied events, oldest first.
+ */
+void copyEvents(const ThreadBuffer& b, std::vector<EventCopy>& out) {
+    const uint64_t end   = b.committed.load(std::memory_order_acquire);
+    const uint64_t begin = end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0;
+    out.clear();
+    out.reserve(end - begin);
+    for (uint64_t i = begin; i < end; ++i) {
+        const Event& e = b.events[i % EVENTS_PER_THREAD];
+        out.push_back({e.name.load(std::memory_order_relaxed),
+                       e.kind.load(std::memory_order_relaxed),
+                       e.startNs.load(std::memory_order_relaxed),
+                       e.durNs.load(std::memory_order_relaxed),
+                       e.id.load(std::memory_order_relaxed)});
+    }
+
+    // Drop the events whose slots the owning thread has started writing over since the copy
+    // began.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t claimed = b.claimed.load(std::memory_order_relaxed);
+    const uint64_t intact  = claimed > EVENTS_PER_THREAD ? claimed - EVENTS_PER_THREAD : 0;
+    if (intact > begin)
+        out.erase(out.begin(), out.begin() + std::min(intact - begin, uint64_t(out.size())));
+}
+
+/**
+ * @brief Write a string as a JSON string literal.
+ * @param out Stream to write to.
+ * @param s String to write.
+ */
+void writeString(std::ostream& out, const char* s) {
+    out << '"';
+    for (; s && *s; ++s) {
+        if (*s == '"' || *s == '\\')
+            out << '\\';
+        out << *s;
+    }
+    out << '"';
+}
+
+/**
+ * @brief Write a time in the microseconds used by the trace format.
+ * @param out Stream to write to.
+ * @param ns Time in nanoseconds.
+ */
+void writeMicros(std::ostream& out, const uint64_t ns) {
+    const char fill = out.fill('0');
+    out << ns / 1000 << '.' << std::setw(3) << ns % 1000;
+    out.fill(fill);
+}
+
+} // namespace
+
+void setEnabled(const bool e) { enabled.store(e, std::memory_order_relaxed); }
+
+bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+void setThreadName(const char* name) {
+    // Threads that never record anything don't need a buffer, so only create one on demand.
+    threadName = name;
+    if (threadBuffer)
+        threadBuffer->name.store(name, std::memory_order_relaxed);
+}
+
+void flowStart(const uint64_t& id) {
+    if (isEnabled())
+        record(FLOW_START, "flow", nowNs(), 0, id);
+}
+
+void flowEnd(const uint64_t& id) {
+    if (isEnabled())
+        record(FLOW_END, "flow", nowNs(), 0, id);
+}
+
+std::size_t writeChromeTrace(std::ostream& out) {
+    std::size_t            count = 0;
+    std::vector<EventCopy> events;
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    const char* sep = "\n";
+    for (ThreadBuffer* b = buffers.load(std::memory_order_acquire); b; b = b->next) {
+        if (const char* name = b->name.load(std::memory_order_relaxed)) {
+            out << sep << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->tid
+                << ",\"args\":{\"name\":";
+            writeString(out, name);
+            out << "}}";
+            sep = ",\n";
+        }
+
+        copyEvents(*b, events);
+        for (const EventCopy& e : events) {
+            out << sep << "{\"name\":";
+            writeString(out, e.name);
+            switch (e.kind) {
+                case ZONE:
+                    out << ",\"ph\":\"X\",\"dur\":";
+                    writeMicros(out, e.durNs);
+                    break;
+                case FLOW_START:
+                    out << ",\"cat\":\"flow\",\"ph\":\"s\",\"id\":" << e.id;
+                    break;
+                case FLOW_END:
+                    // Bind to the enclosing slice rather than the next one to start.
+                    out << ",\"cat\":\"flow\",\"ph\":\"f\",\"bp\":\"e\",\"id\":" << e.id;
+                    break;
+            }
+            out << ",\"pid\":1,\"tid\":" << b->tid << ",\"ts\":";
+            writeMicros(out, e.startNs);
+            out << '}';
+            sep = ",\n";
+            count++;
+        }
+    }
+    out << "\n]}\n";
+    return count;
+}
+
+bool writeChromeTrace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file)
+        return false;
+    writeChromeTrace(file);
+    return bool(file);
+}
+
+Zone::Zone(const char* name) : name_(name), startNs_(0), recording_(isEnabled()) {
+    if (recording_)
+        startNs_ = nowNs();
+}
+
+Zone::~Zone() {
+    if (recording_) {
+        const uint64_t endNs = nowNs();
+        record(ZONE, name_, startNs_, endNs - startNs_, 0);
+    }
+}
+
+}; // namespace boids::trace
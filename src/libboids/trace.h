@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief Timeline tracing, which can be loaded into chrome://tracing or Perfetto.
+ *
+ * Code is instrumented with scoped zones, which record a slice on the timeline of the thread that
+ * runs them, and with flow events, which draw an arrow from a slice on one thread to a slice on
+ * another (e.g. from the step that produced a frame to the render that drew it).
+ *
+ * Each thread records into its own fixed size ring buffer, so recording never locks, allocates
+ * (after the first event on a thread) or contends with other threads. Once a buffer is full the
+ * oldest events are overwritten, so the trace always holds the most recent events. The buffers
+ * can be written out as JSON at any time, from any thread, while other threads carry on recording.
+ *
+ * The macros below are compiled out unless libboids is built with BOIDS_TRACE defined (the
+ * BOIDS_TRACE CMake option). When compiled in, nothing is recorded until setEnabled() is called.
+ */
+namespace boids::trace {
+
+// Number of events kept for each thread.
+constexpr std::size_t EVENTS_PER_THREAD = std::size_t(1) << 16;
+
+/**
+ * @brief Start or stop recording events. This can be called from any thread.
+ * @param enabled True to record events.
+ */
+void setEnabled(const bool enabled);
+
+/**
+ * @brief Check whether events are being recorded.
+ * @return True if events are being recorded.
+ */
+bool isEnabled();
+
+/**
+ * @brief Name the calling thread on the timeline.
+ * @param name Name of the thread. This must be a string literal, or otherwise outlive the trace.
+ */
+void setThreadName(const char* name);
+
+/**
+ * @brief Start a flow on the calling thread. The arrow starts from the innermost zone that is
+ * open on the thread.
+ * @param id ID of the flow, which is matched against the ID passed to flowEnd().
+ */
+void flowStart(const uint64_t& id);
+
+/**
+ * @brief End a flow on the calling thread. The arrow ends at the innermost zone that is open on
+ * the thread.
+ * @param id ID of the flow, which was passed to flowStart().
+ */
+void flowEnd(const uint64_t& id);
+
+/**
+ * @brief Write the events recorded so far by every thread in the Chrome trace event format.
+ * @param out Stream to write to.
+ * @return Number of events written.
+ */
+std::size_t writeChromeTrace(std::ostream& out);
+
+/**
+ * @brief Write the events recorded so far by every thread to a Chrome trace event JSON file.
+ * @param path Path of the file to write.
+ * @return True if the file was written, false if it couldn't be opened.
+ */
+bool writeChromeTrace(const std::string& path);
+
+/**
+ * @brief The Zone class records a slice on the calling thread's timeline, covering its lifetime.
+ * Use it through the BOIDS_TRACE_ZONE macro, so that it is compiled out when tracing is disabled.
+ */
+class Zone {
+  public:
+    /**
+     * @brief Open a zone.
+     * @param name Name of the zone. This must be a string literal, or otherwise outlive the trace.
+     */
+    explicit Zone(const char* name);
+
+    /**
+     * @brief Close the zone, and record it if tracing is enabled.
+     */
+    ~Zone();
+
+    Zone(const Zone&)            = delete;
+    Zone& operator=(const Zone&) = delete;
+
+  private:
+    const char* name_;
+    uint64_t    startNs_;
+    bool        recording_; ///< False if tracing was disabled when the zone was opened.
+};
+
+}; // namespace boids::trace
+
+#define BOIDS_TRACE_CONCAT_IMPL(a, b) a##b
+#define BOIDS_TRACE_CONCAT(a, b)      BOIDS_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef BOIDS_TRACE
+#define BOIDS_TRACE_ZONE(name)                                                                     \
+    ::boids::trace::Zone BOIDS_TRACE_CONCAT(boidsTraceZone, __LINE__)(name)
+#define BOIDS_TRACE_THREAD_NAME(name) ::boids::trace::setThreadName(name)
+#define BOIDS_TRACE_FLOW_START(id)    ::boids::trace::flowStart(id)
+#define BOIDS_TRACE_FLOW_END(id)      ::boids::trace::flowEnd(id)
+#else
+#define BOIDS_TRACE_ZONE(name)        ((void)0)
+#define BOIDS_TRACE_THREAD_NAME(name) ((void)0)
+#define BOIDS_TRACE_FLOW_START(id)    ((void)0)
+#define BOIDS_TRACE_FLOW_END(id)      ((void)0)
+#endif
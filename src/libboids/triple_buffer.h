@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace boids {
+
+/**
+ * @brief The TripleBuffer class hands the latest value from a single writer thread to a single
+ * reader thread, without locks and without either side ever waiting for the other.
+ *
+ * There are three buffers: one owned by the writer, one owned by the reader and one in the middle.
+ * The writer fills its buffer and publishes it by swapping it with the middle one. The reader
+ * swaps its buffer with the middle one only if something new has been published since its last
+ * fetch. Frames that the reader doesn't pick up in time are simply overwritten, so the reader
+ * always sees the latest complete value.
+ *
+ * The buffers are reused, so if T reuses its own storage when assigned to (as std::vector does)
+ * there are no allocations once the buffers have grown to size.
+ */
+template <typename T> class TripleBuffer {
+  public:
+    TripleBuffer() : middle_(1), back_(0), front_(2) {}
+
+    TripleBuffer(const TripleBuffer&)            = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * @brief Get the buffer owned by the writer, to fill in before calling publish(). This must
+     * only be called from the writer thread.
+     * @return Reference to the write buffer.
+     */
+    T& getWriteBuffer() { return buffers_[back_]; }
+
+    /**
+     * @brief Publish the write buffer to the reader, and take over the middle buffer as the new
+     * write buffer. This must only be called from the writer thread.
+     */
+    void publish() {
+        const uint8_t prev = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel);
+        back_              = prev & INDEX_MASK;
+    }
+
+    /**
+     * @brief Pick up the latest published buffer, if there is one. This must only be called from
+     * the reader thread.
+     * @return True if a new buffer was picked up, false if nothing has been published since the
+     * last call.
+     */
+    bool fetch() {
+        if (!(middle_.load(std::memory_order_relaxed) & FRESH))
+            return false;
+        const uint8_t prev = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_             = prev & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief Get the buffer owned by the reader, which holds the value picked up by the last
+     * successful fetch(). This must only be called from the reader thread.
+     * @return Reference to the read buffer.
+     */
+    const T& getReadBuffer() const { return buffers_[front_]; }
+
+  private:
+    static constexpr uint8_t INDEX_MASK = 0x3; ///< Bits holding the index of the middle buffer.
+    static constexpr uint8_t FRESH      = 0x4; ///< Set when the middle buffer hasn't been read.
+
+    // The writer and reader each keep their own index on a separate cache line, so they don't
+    // contend on anything but the middle index.
+    T                                buffers_[3];
+    alignas(64) std::atomic<uint8_t> middle_;
+    alignas(64) uint8_t              back_;
+    alignas(64) uint8_t              front_;
+};
+
+}; // namespace boids
@@ -0,0 +1,110 @@
+#include "types.h"
+#include <algorithm>
+
+namespace boids {
+
+/**
+ * @brief Clamp a colour component to the range [0, 255].
+ * @param c Component.
+ * @return Clamped component.
+ */
+inline uint8_t clampComponent(const int c) { return uint8_t(std::clamp(c, 0, 255)); }
+
+Color::Color(const int r, const int g, const int b, const int a) {
+    const int maxC  = std::max({r, g, b});
+    const int minC  = std::min({r, g, b});
+    const int delta = maxC - minC;
+
+    value_      = clampComponent(maxC);
+    saturation_ = clampComponent(maxC > 0 ? (255 * delta + maxC / 2) / maxC : 0);
+    alpha_      = clampComponent(a);
+
+    if (delta == 0) {
+        hue_ = -1;
+        return;
+    }
+
+    float h;
+    if (maxC == r)
+        h = 60.0f * float(g - b) / float(delta);
+    else if (maxC == g)
+        h = 60.0f * (2.0f + float(b - r) / float(delta));
+    else
+        h = 60.0f * (4.0f + float(r - g) / float(delta));
+
+    int hue = int(std::lround(h));
+    if (hue < 0)
+        hue += 360;
+    hue_ = int16_t(hue % 360);
+}
+
+Color Color::fromHsv(const int h, const int s, const int v, const int a) {
+    Color c;
+    c.setHsv(h, s, v, a);
+    return c;
+}
+
+void Color::setHsv(const int h, const int s, const int v, const int a) {
+    hue_        = int16_t(h < 0 ? -1 : h % 360);
+    saturation_ = clampComponent(s);
+    value_      = clampComponent(v);
+    alpha_      = clampComponent(a);
+}
+
+int Color::red() const {
+    int r, g, b;
+    toRgb(r, g, b);
+    return r;
+}
+
+int Color::green() const {
+    int r, g, b;
+    toRgb(r, g, b);
+    return g;
+}
+
+int Color::blue() const {
+    int r, g, b;
+    toRgb(r, g, b);
+    return b;
+}
+
+void Color::toRgb(int& r, int& g, int& b) const {
+    if (hue_ < 0 || saturation_ == 0) {
+        r = g = b = value_;
+        return;
+    }
+
+    const float h = float(hue_) / 60.0f;
+    const float s = float(saturation_) / 255.0f;
+    const float v = float(value_);
+
+    const int   sector = int(h);
+    const float f      = h - float(sector);
+    const int   p      = int(std::lround(v * (1.0f - s)));
+    const int   q      = int(std::lround(v * (1.0f - s * f)));
+    const int   t      = int(std::lround(v * (1.0f - s * (1.0f - f))));
+
+    switch (sector) {
+        case 0:
+            r = value_, g = t, b = p;
+            break;
+        case 1:
+            r = q, g = value_, b = p;
+            break;
+        case 2:
+            r = p, g = value_, b = t;
+            break;
+        case 3:
+            r = p, g = q, b = value_;
+            break;
+        case 4:
+            r = t, g = p, b = value_;
+            break;
+        default:
+            r = value_, g = p, b = q;
+            break;
+    }
+}
+
+}; // namespace boids
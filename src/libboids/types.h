@@ -0,0 +1,225 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace boids {
+
+/**
+ * @brief The Vec2 class is a 2D vector of floats, used for both points and velocities.
+ */
+class Vec2 {
+  public:
+    /**
+     * @brief Construct a new Vec2 object at the origin.
+     */
+    constexpr Vec2() : x_(0.0f), y_(0.0f) {}
+
+    /**
+     * @brief Construct a new Vec2 object.
+     * @param x X component.
+     * @param y Y component.
+     */
+    constexpr Vec2(const float x, const float y) : x_(x), y_(y) {}
+
+    constexpr float x() const { return x_; }
+    constexpr float y() const { return y_; }
+    void            setX(const float x) { x_ = x; }
+    void            setY(const float y) { y_ = y; }
+
+    /**
+     * @brief Get the Euclidean length of the vector.
+     * @return Length.
+     */
+    float length() const { return std::sqrt(x_ * x_ + y_ * y_); }
+
+    /**
+     * @brief Get the vector scaled to unit length.
+     * @return Unit vector, or a zero vector if the length is zero.
+     */
+    Vec2 normalized() const {
+        const float len = length();
+        return len > 0.0f ? Vec2(x_ / len, y_ / len) : Vec2();
+    }
+
+    /**
+     * @brief Scale the vector to unit length in place, or leave it as zero if the length is zero.
+     */
+    void normalize() { *this = normalized(); }
+
+    Vec2& operator+=(const Vec2& v) {
+        x_ += v.x_;
+        y_ += v.y_;
+        return *this;
+    }
+
+    Vec2& operator-=(const Vec2& v) {
+        x_ -= v.x_;
+        y_ -= v.y_;
+        return *this;
+    }
+
+    Vec2& operator*=(const float s) {
+        x_ *= s;
+        y_ *= s;
+        return *this;
+    }
+
+    Vec2& operator/=(const float s) {
+        x_ /= s;
+        y_ /= s;
+        return *this;
+    }
+
+    friend constexpr Vec2 operator+(const Vec2& a, const Vec2& b) {
+        return Vec2(a.x_ + b.x_, a.y_ + b.y_);
+    }
+    friend constexpr Vec2 operator-(const Vec2& a, const Vec2& b) {
+        return Vec2(a.x_ - b.x_, a.y_ - b.y_);
+    }
+    friend constexpr Vec2 operator-(const Vec2& v) { return Vec2(-v.x_, -v.y_); }
+    friend constexpr Vec2 operator*(const Vec2& v, const float s) {
+        return Vec2(v.x_ * s, v.y_ * s);
+    }
+    friend constexpr Vec2 operator*(const float s, const Vec2& v) {
+        return Vec2(v.x_ * s, v.y_ * s);
+    }
+    friend constexpr Vec2 operator/(const Vec2& v, const float s) {
+        return Vec2(v.x_ / s, v.y_ / s);
+    }
+    friend constexpr bool operator==(const Vec2& a, const Vec2& b) {
+        return a.x_ == b.x_ && a.y_ == b.y_;
+    }
+    friend constexpr bool operator!=(const Vec2& a, const Vec2& b) { return !(a == b); }
+
+  private:
+    float x_;
+    float y_;
+};
+
+/**
+ * @brief The Rect class is an axis-aligned rectangle, defined by its top-left corner and its size.
+ * As in screen coordinates, the Y axis points down, so the top edge has the smallest Y value.
+ */
+class Rect {
+  public:
+    /**
+     * @brief Construct a new, empty Rect object.
+     */
+    constexpr Rect() : x_(0.0f), y_(0.0f), width_(0.0f), height_(0.0f) {}
+
+    /**
+     * @brief Construct a new Rect object.
+     * @param x X coordinate of the left edge.
+     * @param y Y coordinate of the top edge.
+     * @param width Width.
+     * @param height Height.
+     */
+    constexpr Rect(const float x, const float y, const float width, const float height)
+        : x_(x), y_(y), width_(width), height_(height) {}
+
+    constexpr float left() const { return x_; }
+    constexpr float right() const { return x_ + width_; }
+    constexpr float top() const { return y_; }
+    constexpr float bottom() const { return y_ + height_; }
+    constexpr float width() const { return width_; }
+    constexpr float height() const { return height_; }
+
+    /**
+     * @brief Check whether the rectangle has no area.
+     * @return True if the width or height is not positive.
+     */
+    constexpr bool isEmpty() const { return !(width_ > 0.0f && height_ > 0.0f); }
+
+    friend constexpr bool operator==(const Rect& a, const Rect& b) {
+        return a.x_ == b.x_ && a.y_ == b.y_ && a.width_ == b.width_ && a.height_ == b.height_;
+    }
+    friend constexpr bool operator!=(const Rect& a, const Rect& b) { return !(a == b); }
+
+  private:
+    float x_;
+    float y_;
+    float width_;
+    float height_;
+};
+
+/**
+ * @brief The Color class is an 8-bit colour stored in the HSV colour space, which is what the
+ * simulation works in. It can be constructed from, and converted to, RGB.
+ */
+class Color {
+  public:
+    /**
+     * @brief Construct a new, opaque black Color object.
+     */
+    constexpr Color() : hue_(-1), saturation_(0), value_(0), alpha_(255) {}
+
+    /**
+     * @brief Construct a new Color object from RGB components.
+     * @param r Red, in the range [0, 255].
+     * @param g Green, in the range [0, 255].
+     * @param b Blue, in the range [0, 255].
+     * @param a Alpha, in the range [0, 255].
+     */
+    Color(const int r, const int g, const int b, const int a = 255);
+
+    /**
+     * @brief Create a Color object from HSV components.
+     * @param h Hue, in the range [0, 359], or -1 for an achromatic colour.
+     * @param s Saturation, in the range [0, 255].
+     * @param v Value, in the range [0, 255].
+     * @param a Alpha, in the range [0, 255].
+     * @return Colour.
+     */
+    static Color fromHsv(const int h, const int s, const int v, const int a = 255);
+
+    /**
+     * @brief Get the HSV hue.
+     * @return Hue in the range [0, 359], or -1 if the colour is achromatic.
+     */
+    int hsvHue() const { return hue_; }
+
+    /**
+     * @brief Get the HSV hue. This is the same as hsvHue().
+     * @return Hue in the range [0, 359], or -1 if the colour is achromatic.
+     */
+    int hue() const { return hue_; }
+
+    int saturation() const { return saturation_; }
+    int value() const { return value_; }
+    int alpha() const { return alpha_; }
+    int red() const;
+    int green() const;
+    int blue() const;
+
+    /**
+     * @brief Set the colour from HSV components.
+     * @param h Hue, in the range [0, 359], or -1 for an achromatic colour.
+     * @param s Saturation, in the range [0, 255].
+     * @param v Value, in the range [0, 255].
+     * @param a Alpha, in the range [0, 255].
+     */
+    void setHsv(const int h, const int s, const int v, const int a = 255);
+
+    friend bool operator==(const Color& a, const Color& b) {
+        return a.hue_ == b.hue_ && a.saturation_ == b.saturation_ && a.value_ == b.value_ &&
+               a.alpha_ == b.alpha_;
+    }
+    friend bool operator!=(const Color& a, const Color& b) { return !(a == b); }
+
+  private:
+    /**
+     * @brief Convert the colour to RGB.
+     * @param r Red, set by the call.
+     * @param g Green, set by the call.
+     * @param b Blue, set by the call.
+     */
+    void toRgb(int& r, int& g, int& b) const;
+
+    int16_t hue_;
+    uint8_t saturation_;
+    uint8_t value_;
+    uint8_t alpha_;
+};
+
+}; // namespace boids
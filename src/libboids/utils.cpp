@@ -5,28 +5,28 @@
 namespace boids {
 namespace utils {
 
-QVector2D calculateAlignmentVector(const Boid& boid, const std::vector<Boid>& neighbours) {
+Vec2 calculateAlignmentVector(const Boid& boid, const std::vector<Boid>& neighbours) {
     if (neighbours.size() == 0) {
-        return QVector2D(0.0f, 0.0f);
+        return Vec2(0.0f, 0.0f);
     }
 
-    QVector2D vec(0.0, 0.0);
+    Vec2 vec(0.0, 0.0);
     for (const Boid& n : neighbours) {
         const float dist = distanceBetweenBoids(boid, n);
-        QVector2D   vel  = n.getVelocity().normalized() / dist;
+        Vec2        vel  = n.getVelocity().normalized() / dist;
         vec += vel;
     }
 
     return vec;
 }
 
-QVector2D calculateCohesionVector(const Boid& boid, const std::vector<Boid>& neighbours,
-                                  const QRectF& bounds) {
+Vec2 calculateCohesionVector(const Boid& boid, const std::vector<Boid>& neighbours,
+                             const Rect& bounds) {
     if (neighbours.size() == 0) {
-        return QVector2D(0.0f, 0.0f);
+        return Vec2(0.0f, 0.0f);
     }
 
-    QVector2D vec(0.0, 0.0);
+    Vec2 vec(0.0, 0.0);
     for (const Boid& n : neighbours) {
         vec += distanceVectorBetweenPoints(boid.getPosition(), n.getPosition(), bounds);
     }
@@ -37,9 +37,9 @@ QVector2D calculateCohesionVector(const Boid& boid, const std::vector<Boid>& nei
     return vec;
 }
 
-QColor calculateBoidColor(const Boid& boid, const std::vector<Boid>& neighbours) {
+Color calculateBoidColor(const Boid& boid, const std::vector<Boid>& neighbours) {
 
-    const QColor& boidColor = boid.getColor();
+    const Color& boidColor = boid.getColor();
 
     // If there are no neighbours, return the current color.
     if (neighbours.size() == 0) {
@@ -66,22 +66,22 @@ QColor calculateBoidColor(const Boid& boid, const std::vector<Boid>& neighbours)
     // Make sure that the new hue wraps into the range [0, 359].
     newHue = wrapValue(newHue, 0.0f, 359.0f);
 
-    // Create and return hue in new QColor object.
-    QColor ret;
+    // Create and return hue in new Color object.
+    Color ret;
     ret.setHsv(int(newHue), boidColor.saturation(), boidColor.value());
     return ret;
 }
 
-QVector2D calculateSeparationVector(const Boid& boid, const std::vector<Boid>& neighbours,
-                                    const float minDist, const QRectF& bounds) {
+Vec2 calculateSeparationVector(const Boid& boid, const std::vector<Boid>& neighbours,
+                               const float minDist, const Rect& bounds) {
     if (neighbours.size() == 0) {
-        return QVector2D(0.0f, 0.0f);
+        return Vec2(0.0f, 0.0f);
     }
 
     // FIXME: This entire method needs much better testing!
-    QVector2D vec(0.0, 0.0);
+    Vec2 vec(0.0, 0.0);
     for (const Boid& n : neighbours) {
-        const QVector2D diff =
+        const Vec2 diff =
             distanceVectorBetweenPoints(n.getPosition(), boid.getPosition(), bounds);
 
         const float dist = diff.length();
@@ -90,7 +90,7 @@ QVector2D calculateSeparationVector(const Boid& boid, const std::vector<Boid>& n
             continue;
 
         else if (dist == 0.0f) {
-            vec += QVector2D(1.0f, 0.0f);
+            vec += Vec2(1.0f, 0.0f);
             continue;
         }
 
@@ -110,7 +110,7 @@ float distanceBetweenBoids(const Boid& b1, const Boid& b2) {
     return dist;
 }
 
-float distanceBetweenBoids(const Boid& b1, const Boid& b2, const QRectF& bounds) {
+float distanceBetweenBoids(const Boid& b1, const Boid& b2, const Rect& bounds) {
     const auto p1 = b1.getPosition();
     const auto p2 = b2.getPosition();
 
@@ -122,21 +122,33 @@ float distanceBetweenBoids(const Boid& b1, const Boid& b2, const QRectF& bounds)
     return std::sqrt(std::pow(dx, 2) + std::pow(dy, 2));
 }
 
-QVector2D distanceVectorBetweenPoints(const QPointF& p1, const QPointF& p2, const QRectF& bounds) {
+Vec2 distanceVectorBetweenPoints(const Vec2& p1, const Vec2& p2, const Rect& bounds) {
     const float dx = shortestDistanceInWrapedSpace(p1.x(), p2.x(), bounds.left(), bounds.right());
     const float dy = shortestDistanceInWrapedSpace(p1.y(), p2.y(), bounds.top(), bounds.bottom());
-    return QVector2D(dx, dy);
+    return Vec2(dx, dy);
 }
 
-QVector2D generateRandomVelocityVector(const float maxMagnitude) {
+std::mt19937& getThreadGenerator() {
+    thread_local std::mt19937 gen(std::random_device{}());
+    return gen;
+}
+
+Vec2 generateRandomVelocityVector(const float maxMagnitude) {
     const float dx = generateRandomValue<float>(-1.0f, 1.0f);
     const float dy = generateRandomValue<float>(-1.0f, 1.0f);
     const float w  = generateRandomValue<float>(0.0f, maxMagnitude);
-    return scaleVector(QVector2D(dx, dy), w);
+    return scaleVector(Vec2(dx, dy), w);
+}
+
+Vec2 generateRandomVelocityVector(const float maxMagnitude, Random& rng) {
+    const float dx = rng.uniform(-1.0f, 1.0f);
+    const float dy = rng.uniform(-1.0f, 1.0f);
+    const float w  = rng.uniform(0.0f, maxMagnitude);
+    return scaleVector(Vec2(dx, dy), w);
 }
 
 std::vector<Boid> getBoidNeighbourhood(const Boid& boid, const std::vector<boids::Boid>& flock,
-                                       const float& dist, const QRectF& bounds) {
+                                       const float& dist, const Rect& bounds) {
     std::vector<Boid> ret;
     for (const Boid& b : flock) {
         if (boid.getId() == b.getId())
@@ -149,6 +161,25 @@ std::vector<Boid> getBoidNeighbourhood(const Boid& boid, const std::vector<boids
     return ret;
 }
 
+std::vector<Boid> getBoidNeighbourhood(const Boid& boid, const std::vector<boids::Boid>& flock,
+                                       const SpatialGrid& grid, const float& dist,
+                                       const Rect& bounds) {
+    std::vector<std::size_t> candidates;
+    grid.getCandidates(boid.getPosition(), candidates);
+
+    std::vector<Boid> ret;
+    for (const std::size_t& i : candidates) {
+        const Boid& b = flock[i];
+        if (boid.getId() == b.getId())
+            continue;
+        const float d = distanceBetweenBoids(boid, b, bounds);
+        if (d > dist)
+            continue;
+        ret.push_back(b);
+    }
+    return ret;
+}
+
 std::size_t getTotalNumBoids(const std::map<BoidType, std::vector<Boid>>& boids) {
     std::size_t n = 0;
     for (const auto& [key, value] : boids) {
@@ -157,7 +188,7 @@ std::size_t getTotalNumBoids(const std::map<BoidType, std::vector<Boid>>& boids)
     return n;
 }
 
-QVector2D scaleVector(const QVector2D& vec, const float& scalar) {
+Vec2 scaleVector(const Vec2& vec, const float& scalar) {
     return vec.normalized() * scalar;
 }
 
@@ -175,10 +206,10 @@ float shortestDistanceInWrapedSpace(const float& v1, const float& v2, const floa
     return b * (-a / std::abs(a));
 }
 
-void wrapBoidPosition(Boid& boid, const QRectF& rect) {
+void wrapBoidPosition(Boid& boid, const Rect& rect) {
     const float x = wrapValue(boid.getPosition().x(), rect.left(), rect.right());
     const float y = wrapValue(boid.getPosition().y(), rect.top(), rect.bottom());
-    boid.setPosition(QPointF(x, y));
+    boid.setPosition(Vec2(x, y));
 }
 
 float wrapValue(const float& value, const float& minValue, const float& maxValue) {
@@ -191,7 +222,7 @@ float wrapValue(const float& value, const float& minValue, const float& maxValue
     }
 }
 
-void clipVectorMangitude(QVector2D& vec, const float& minMagnitude, const float& maxMagnitude) {
+void clipVectorMangitude(Vec2& vec, const float& minMagnitude, const float& maxMagnitude) {
 
     if (minMagnitude > maxMagnitude)
         throw std::invalid_argument("Minimum value is greater than the maximum.");
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "boids.h"
-#include <QRectF>
-#include <QVector2D>
+#include "random.h"
+#include "spatial_grid.h"
+#include "types.h"
+#include <map>
 #include <random>
+#include <stdexcept>
 #include <vector>
 
 namespace boids {
@@ -21,7 +24,7 @@ namespace utils {
  * @param neighbours Neighbourhood of Boids.
  * @return Vector aligning the boid with the neighbours.
  */
-QVector2D calculateAlignmentVector(const Boid& boid, const std::vector<Boid>& neighbours);
+Vec2 calculateAlignmentVector(const Boid& boid, const std::vector<Boid>& neighbours);
 
 /**
  * @brief Calculate the vector that pulls a Boid towards the center of the neighbourood.
@@ -35,17 +38,17 @@ QVector2D calculateAlignmentVector(const Boid& boid, const std::vector<Boid>& ne
  * @param bounds Scene bounds of the wrapped space.
  * @return Vector towards the center of the neighbourhood.
  */
-QVector2D calculateCohesionVector(const Boid& boid, const std::vector<Boid>& neighbours,
-                                  const QRectF& bounds);
+Vec2 calculateCohesionVector(const Boid& boid, const std::vector<Boid>& neighbours,
+                             const Rect& bounds);
 
 /**
  * @brief Calculaet the new color of a boids given the neighbourhood.
  *
  * @param boid Boid to calculate the color for.
  * @param neighbours Neighbourhood around the Boid.
- * @return QColor New Boid color.
+ * @return New Boid color.
  */
-QColor calculateBoidColor(const Boid& boid, const std::vector<Boid>& neighbours);
+Color calculateBoidColor(const Boid& boid, const std::vector<Boid>& neighbours);
 /**
  * @brief Calculate the vector that repels a given Boids from the other boids within
  * the neighbourhood to maintain a minimum distance between them.
@@ -60,8 +63,8 @@ QColor calculateBoidColor(const Boid& boid, const std::vector<Boid>& neighbours)
  * @param bounds Scene bounds of the wrapped space.
  * @return Repelling vector.
  */
-QVector2D calculateSeparationVector(const Boid& boid, const std::vector<Boid>& neighbours,
-                                    const float minDist, const QRectF& bounds);
+Vec2 calculateSeparationVector(const Boid& boid, const std::vector<Boid>& neighbours,
+                               const float minDist, const Rect& bounds);
 
 /**
  * @brief Calculate the euclidean distance between two Boids.
@@ -79,7 +82,7 @@ float distanceBetweenBoids(const Boid& b1, const Boid& b2);
  * @param bounds Bounds of the scene.
  * @return Euclidean distance.
  */
-float distanceBetweenBoids(const Boid& b1, const Boid& b2, const QRectF& bounds);
+float distanceBetweenBoids(const Boid& b1, const Boid& b2, const Rect& bounds);
 
 /**
  * @brief Calculate the vector between two points.
@@ -92,17 +95,22 @@ float distanceBetweenBoids(const Boid& b1, const Boid& b2, const QRectF& bounds)
  * @return Dispacement vector.
  * @throws An std::invalid_arguent if the min value is greater than the max value.
  */
-QVector2D distanceVectorBetweenPoints(const QPointF& p1, const QPointF& bp2, const QRectF& bounds);
+Vec2 distanceVectorBetweenPoints(const Vec2& p1, const Vec2& bp2, const Rect& bounds);
+
+/**
+ * @brief Get the random number generator of the calling thread. This is seeded once per thread
+ * from a std::random_device, rather than on every call.
+ * @return Reference to the generator.
+ */
+std::mt19937& getThreadGenerator();
 
 template <typename T> T generateRandomValue(const T minValue, const T maxValue) {
     if (minValue > maxValue) {
         throw std::invalid_argument("The min value is greater than the max value");
     }
 
-    std::random_device               rd;
-    std::mt19937                     gen(rd());
     std::uniform_real_distribution<> distr(minValue, maxValue);
-    return distr(gen);
+    return distr(getThreadGenerator());
 }
 
 /**
@@ -110,7 +118,16 @@ template <typename T> T generateRandomValue(const T minValue, const T maxValue)
  * @param maxMagnitude Maximum allowed length/madnitude.
  * @return Generated vector.
  */
-QVector2D generateRandomVelocityVector(const float maxMagnitude);
+Vec2 generateRandomVelocityVector(const float maxMagnitude);
+
+/**
+ * @brief Generate a random 2D vector with a maximum allowed magnitude, drawing from a given
+ * generator so that the result can be reproduced.
+ * @param maxMagnitude Maximum allowed length/magnitude.
+ * @param rng Random number generator.
+ * @return Generated vector.
+ */
+Vec2 generateRandomVelocityVector(const float maxMagnitude, Random& rng);
 
 /**
  * @brief Get the Boids that are within the neighbourhood of a given Boid. This will
@@ -123,7 +140,22 @@ QVector2D generateRandomVelocityVector(const float maxMagnitude);
  * @return Vector of Boids that form the Neighbourhood.
  */
 std::vector<Boid> getBoidNeighbourhood(const Boid& boid, const std::vector<Boid>& flock,
-                                       const float& dist, const QRectF& bounds);
+                                       const float& dist, const Rect& bounds);
+
+/**
+ * @brief Get the Boids that are within the neighbourhood of a given Boid, using a SpatialGrid
+ * built over the flock to skip Boids that are too far away. This returns exactly the same
+ * neighbourhood (in the same order) as the brute-force overload.
+ * @param boid Boids to get the neighbourhood for.
+ * @param flock Flock of all the boids.
+ * @param grid Spatial grid built from the flock, with a cell size of at least the distance.
+ * @param dist Neighbourhood distance.
+ * @param bounds Bounds of the scene.
+ * @return Vector of Boids that form the Neighbourhood.
+ */
+std::vector<Boid> getBoidNeighbourhood(const Boid& boid, const std::vector<Boid>& flock,
+                                       const SpatialGrid& grid, const float& dist,
+                                       const Rect& bounds);
 
 /**
  * @brief Get the total number in a map of different types of Boids.
@@ -133,12 +165,12 @@ std::vector<Boid> getBoidNeighbourhood(const Boid& boid, const std::vector<Boid>
 std::size_t getTotalNumBoids(const std::map<BoidType, std::vector<Boid>>& boids);
 
 /**
- * @brief Get a QVector scaled by a given value.
+ * @brief Get a vector scaled by a given value.
  * @param vec Vector to sclae.
  * @param scalar Scalar value.
- * @return QVector2D scaled.
+ * @return Scaled vector.
  */
-QVector2D scaleVector(const QVector2D& vec, const float& scalar);
+Vec2 scaleVector(const Vec2& vec, const float& scalar);
 
 /**
  * @brief Calculate the shortest distance between two points/values in a 1D wrapped space.
@@ -159,7 +191,7 @@ float shortestDistanceInWrapedSpace(const float& v1, const float& v2, const floa
  * @param boid Boid to process.
  * @param rect Rectangle representing the simulation area.
  */
-void wrapBoidPosition(Boid& boid, const QRectF& rect);
+void wrapBoidPosition(Boid& boid, const Rect& rect);
 
 float wrapValue(const float& value, const float& minValue, const float& maxValue);
 
@@ -171,7 +203,7 @@ float wrapValue(const float& value, const float& minValue, const float& maxValue
  * @param maxMagnitude Maximum magnitude/length value of the vector.
  * @throws std::invalid_argument If the minimum value is greater than the maximum.
  */
-void clipVectorMangitude(QVector2D& vec, const float& minMagnitude, const float& maxMagnitude);
+void clipVectorMangitude(Vec2& vec, const float& minMagnitude, const float& maxMagnitude);
 
 } // namespace utils
 }; // namespace boids
@@ -0,0 +1,380 @@
+#include <flock.h>
+#include <thread_pool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Pointer to one of the float fields of a boids::Config.
+using ConfigMember = float boids::Config::*;
+
+/**
+ * @brief A config field that can be swept, set on the command line as --<name> with a comma
+ * separated list of values, or as a column of the --list file.
+ */
+struct ConfigField {
+    const char*  name;
+    ConfigMember field;
+};
+
+const ConfigField SWEEP_FIELDS[] = {
+    {"align", &boids::Config::alignmentScale},
+    {"cohesion", &boids::Config::coheasionScale},
+    {"repel", &boids::Config::repelScale},
+    {"radius", &boids::Config::neighbourhoodRadius},
+};
+
+constexpr std::size_t NUM_SWEEP_FIELDS = std::size(SWEEP_FIELDS);
+
+/**
+ * @brief The parameters of a sweep. Every run uses the same flock size, scene and step count, and
+ * differs only in its boid config and seed.
+ */
+struct SweepConfig {
+    std::size_t numBoids     = 1000;
+    std::size_t numPredators = 0;
+    std::size_t numObstacles = 0;
+    float       width        = 1000.0f;
+    float       height       = 1000.0f;
+    std::size_t numSteps     = 1000;
+    std::size_t numThreads   = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t numSeeds     = 1; ///< Runs of each config, with consecutive seeds.
+    uint64_t    seed         = 1; ///< Seed of the first run of each config.
+    std::string listPath;         ///< CSV file of configs, used instead of the grid if set.
+    std::string outputPath;       ///< File to write the results to, empty for stdout.
+
+    // Values of each sweep field. An empty list leaves the field at the flock's default.
+    std::vector<float> values[NUM_SWEEP_FIELDS];
+};
+
+/**
+ * @brief A single run of the sweep.
+ */
+struct Run {
+    boids::Config cfg;
+    uint64_t      seed;
+};
+
+/**
+ * @brief The summary metrics of a single run, taken at the end of the run.
+ */
+struct RunResult {
+    double      seconds        = 0.0;
+    double      stepsPerSec    = 0.0;
+    double      meanSpeed      = 0.0;
+    double      meanNeighbours = 0.0; ///< Over the most recent steps, if step stats are enabled.
+    std::size_t numBoids       = 0;
+
+    // Collective behaviour of the BOIDs, reduced by the flock during its final step.
+    boids::FlockMetrics metrics;
+};
+
+/**
+ * @brief Print the usage of the sweep.
+ */
+void printUsage() {
+    std::cerr << "Usage: boidsim-sweep [options]\n"
+              << "  --boids N         Number of boids in each run (default 1000)\n"
+              << "  --predators P     Number of predators in each run (default 0)\n"
+              << "  --obstacles O     Number of obstacles in each run (default 0)\n"
+              << "  --width W         Scene width (default 1000)\n"
+              << "  --height H        Scene height (default 1000)\n"
+              << "  --steps K         Number of steps in each run (default 1000)\n"
+              << "  --threads T       Number of threads shared by all the runs (default: all)\n"
+              << "  --seeds S         Number of runs of each config (default 1)\n"
+              << "  --seed S          Seed of the first run of each config (default 1)\n"
+              << "  --align LIST      Comma separated alignment scales to sweep\n"
+              << "  --cohesion LIST   Comma separated cohesion scales to sweep\n"
+              << "  --repel LIST      Comma separated repel scales to sweep\n"
+              << "  --radius LIST     Comma separated neighbourhood radii to sweep\n"
+              << "  --list PATH       CSV of configs to run instead of the grid, with a header\n"
+              << "                    naming any of the columns align, cohesion, repel, radius\n"
+              << "  --output PATH     Write the results to a file instead of stdout\n"
+              << "  --help            Print this message\n";
+}
+
+/**
+ * @brief Split a comma separated list of numbers.
+ * @param s List.
+ * @return Numbers.
+ * @throws std::invalid_argument If a value isn't a number.
+ */
+std::vector<float> parseList(const std::string& s) {
+    std::vector<float> values;
+    std::stringstream  ss(s);
+    for (std::string item; std::getline(ss, item, ',');) {
+        values.push_back(std::stof(item));
+    }
+    return values;
+}
+
+/**
+ * @brief Find the sweep field with a given name.
+ * @param name Name of the field.
+ * @return Index of the field in SWEEP_FIELDS, or NUM_SWEEP_FIELDS if there isn't one.
+ */
+std::size_t findField(const std::string& name) {
+    for (std::size_t f = 0; f < NUM_SWEEP_FIELDS; ++f) {
+        if (name == SWEEP_FIELDS[f].name)
+            return f;
+    }
+    return NUM_SWEEP_FIELDS;
+}
+
+/**
+ * @brief Parse the command line arguments.
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ * @return Sweep config.
+ * @throws std::invalid_argument If an argument is unknown or is missing its value.
+ */
+SweepConfig parseArgs(int argc, char* argv[]) {
+    SweepConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help")
+            throw std::invalid_argument("");
+
+        if (i + 1 >= argc)
+            throw std::invalid_argument("Missing value for " + arg);
+        const std::string value = argv[++i];
+
+        const std::size_t field = arg.rfind("--", 0) == 0 ? findField(arg.substr(2))
+                                                          : NUM_SWEEP_FIELDS;
+        if (field < NUM_SWEEP_FIELDS)
+            cfg.values[field] = parseList(value);
+        else if (arg == "--boids")
+            cfg.numBoids = std::stoul(value);
+        else if (arg == "--predators")
+            cfg.numPredators = std::stoul(value);
+        else if (arg == "--obstacles")
+            cfg.numObstacles = std::stoul(value);
+        else if (arg == "--width")
+            cfg.width = std::stof(value);
+        else if (arg == "--height")
+            cfg.height = std::stof(value);
+        else if (arg == "--steps")
+            cfg.numSteps = std::stoul(value);
+        else if (arg == "--threads")
+            cfg.numThreads = std::stoul(value);
+        else if (arg == "--seeds")
+            cfg.numSeeds = std::stoul(value);
+        else if (arg == "--seed")
+            cfg.seed = std::stoull(value);
+        else if (arg == "--list")
+            cfg.listPath = value;
+        else if (arg == "--output")
+            cfg.outputPath = value;
+        else
+            throw std::invalid_argument("Unknown argument " + arg);
+    }
+
+    if (cfg.width <= 0.0f || cfg.height <= 0.0f)
+        throw std::invalid_argument("The scene size must be positive");
+    if (cfg.numSeeds == 0)
+        throw std::invalid_argument("The number of seeds must be positive");
+    return cfg;
+}
+
+/**
+ * @brief Read the configs to run from a CSV file.
+ * @param path Path of the file.
+ * @param base Config that the columns of the file are applied to.
+ * @return Configs, one per row.
+ * @throws std::invalid_argument If the file can't be read, or has an unknown column.
+ */
+std::vector<boids::Config> readList(const std::string& path, const boids::Config& base) {
+    std::ifstream file(path);
+    if (!file)
+        throw std::invalid_argument("Could not read " + path);
+
+    std::string line;
+    std::getline(file, line);
+    std::vector<std::size_t> columns;
+    std::stringstream        header(line);
+    for (std::string name; std::getline(header, name, ',');) {
+        columns.push_back(findField(name));
+        if (columns.back() == NUM_SWEEP_FIELDS)
+            throw std::invalid_argument("Unknown column " + name + " in " + path);
+    }
+
+    std::vector<boids::Config> configs;
+    while (std::getline(file, line)) {
+        if (line.empty())
+            continue;
+        const std::vector<float> values = parseList(line);
+        if (values.size() != columns.size())
+            throw std::invalid_argument("Wrong number of columns in " + path + ": " + line);
+        boids::Config c = base;
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            c.*SWEEP_FIELDS[columns[i]].field = values[i];
+        }
+        configs.push_back(c);
+    }
+    return configs;
+}
+
+/**
+ * @brief Expand the grid of values into every combination of them.
+ * @param cfg Sweep config.
+ * @param base Config that the values are applied to.
+ * @return Configs, one per combination.
+ */
+std::vector<boids::Config> expandGrid(const SweepConfig& cfg, const boids::Config& base) {
+    std::vector<boids::Config> configs = {base};
+    for (std::size_t f = 0; f < NUM_SWEEP_FIELDS; ++f) {
+        if (cfg.values[f].empty())
+            continue;
+        std::vector<boids::Config> expanded;
+        for (const boids::Config& c : configs) {
+            for (const float v : cfg.values[f]) {
+                expanded.push_back(c);
+                expanded.back().*SWEEP_FIELDS[f].field = v;
+            }
+        }
+        configs = std::move(expanded);
+    }
+    return configs;
+}
+
+/**
+ * @brief Run a single flock to completion and summarise it.
+ * @param cfg Sweep config.
+ * @param run Config and seed of the run.
+ * @return Summary metrics.
+ */
+RunResult runFlock(const SweepConfig& cfg, const Run& run) {
+    // The runs share the sweep's threads, so each flock is updated on the thread running it.
+    const boids::Rect scene(0.0f, 0.0f, cfg.width, cfg.height);
+    boids::Flock      flock(1, run.seed);
+    flock.setSceneBounds(scene);
+    flock.setConfig(run.cfg, boids::BOID);
+
+    flock.spawnUniform(cfg.numBoids, scene, boids::BOID);
+    flock.spawnUniform(cfg.numPredators, scene, boids::PREDATOR);
+    flock.spawnUniform(cfg.numObstacles, scene, boids::OBSTACLE);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < cfg.numSteps; ++i) {
+        flock.update();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    RunResult result;
+    result.seconds        = std::chrono::duration<double>(end - start).count();
+    result.stepsPerSec    = result.seconds > 0.0 ? double(cfg.numSteps) / result.seconds : 0.0;
+    result.meanNeighbours = flock.getStepStatsWindow().getMean().getMeanNeighbours();
+    result.metrics        = flock.getMetrics();
+
+    const boids::FlockState& s        = flock.getState();
+    double                   sumSpeed = 0.0;
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        if (s.type[i] != boids::BOID)
+            continue;
+        sumSpeed += std::sqrt(double(s.vx[i]) * s.vx[i] + double(s.vy[i]) * s.vy[i]);
+        result.numBoids++;
+    }
+    if (result.numBoids > 0)
+        result.meanSpeed = sumSpeed / double(result.numBoids);
+    return result;
+}
+
+/**
+ * @brief Write the results of the sweep as CSV, one run per row.
+ * @param os Stream to write to.
+ * @param runs Runs of the sweep.
+ * @param results Results, in the same order as the runs.
+ */
+void writeResults(std::ostream& os, const std::vector<Run>& runs,
+                  const std::vector<RunResult>& results) {
+    os << "run,seed,align,cohesion,repel,radius,boids,seconds,steps_per_sec,polarisation,"
+          "mean_speed,mean_neighbours,nearest_distance,angular_momentum,local_density\n";
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        const boids::Config&       c = runs[i].cfg;
+        const RunResult&           r = results[i];
+        const boids::FlockMetrics& m = r.metrics;
+        os << i << "," << runs[i].seed << "," << c.alignmentScale << "," << c.coheasionScale << ","
+           << c.repelScale << "," << c.neighbourhoodRadius << "," << r.numBoids << ","
+           << r.seconds << "," << r.stepsPerSec << "," << m.polarisation << "," << r.meanSpeed
+           << "," << r.meanNeighbours << "," << m.meanNearestDistance << "," << m.angularMomentum
+           << "," << m.localDensity << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    SweepConfig cfg;
+    try {
+        cfg = parseArgs(argc, argv);
+    } catch (const std::exception& e) {
+        if (*e.what())
+            std::cerr << e.what() << "\n";
+        printUsage();
+        return 1;
+    }
+
+    std::vector<Run> runs;
+    try {
+        const boids::Config        base = boids::Flock(1, cfg.seed).getConfig(boids::BOID);
+        std::vector<boids::Config> configs =
+            cfg.listPath.empty() ? expandGrid(cfg, base) : readList(cfg.listPath, base);
+        for (const boids::Config& c : configs) {
+            for (std::size_t k = 0; k < cfg.numSeeds; ++k) {
+                runs.push_back({c, cfg.seed + k});
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    // Start the runs in order of decreasing neighbourhood radius, which is what their cost mostly
+    // depends on, so that the slowest runs aren't left until the end. The pool hands out one run at
+    // a time, so each thread claims the next unclaimed run as soon as it is free, and the threads
+    // stay busy until the last runs.
+    std::vector<std::size_t> order(runs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return runs[a].cfg.neighbourhoodRadius > runs[b].cfg.neighbourhoodRadius;
+    });
+
+    std::cerr << "Running " << runs.size() << " flocks on " << cfg.numThreads << " threads..."
+              << std::endl;
+    std::vector<RunResult> results(runs.size());
+    boids::ThreadPool      pool(cfg.numThreads);
+    const auto             start = std::chrono::steady_clock::now();
+    pool.parallelFor(
+        order.size(),
+        [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t i = begin; i < end; ++i) {
+                results[order[i]] = runFlock(cfg, runs[order[i]]);
+            }
+        },
+        1);
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Finished in " << seconds << " s" << std::endl;
+
+    if (cfg.outputPath.empty()) {
+        writeResults(std::cout, runs, results);
+    } else {
+        std::ofstream file(cfg.outputPath);
+        if (!file) {
+            std::cerr << "Could not write " << cfg.outputPath << "\n";
+            return 1;
+        }
+        writeResults(file, runs, results);
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include "allocation_audit.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <step_stats.h>
+
+// Allocations made by every thread of the test program.
+static std::atomic<uint64_t> allocationCount{0};
+
+uint64_t getAllocationCount() { return allocationCount.load(std::memory_order_relaxed); }
+
+#ifdef BOIDS_ALLOCATION_AUDIT
+
+/**
+ * @brief Count an allocation.
+ */
+static void countAllocation() {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    boids::recordAllocation();
+}
+
+// The array and nothrow forms of operator new and delete call these ones by default, so replacing
+// the plain and aligned forms covers every allocation.
+
+void* operator new(std::size_t bytes) {
+    countAllocation();
+    void* ptr = std::malloc(bytes > 0 ? bytes : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(std::size_t bytes, std::align_val_t alignment) {
+    countAllocation();
+    // std::aligned_alloc() needs the size to be a whole number of alignments.
+    const std::size_t align = std::size_t(alignment);
+    const std::size_t size  = (std::max<std::size_t>(bytes, 1) + align - 1) / align * align;
+    void*             ptr   = std::aligned_alloc(align, size);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+#endif
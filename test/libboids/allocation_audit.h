@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Get the number of heap allocations made by every thread of the test program so far.
+ *
+ * The allocations are only counted when the tests are built with BOIDS_ALLOCATION_AUDIT, which
+ * replaces the global operator new. Each allocation is also passed to boids::recordAllocation(), so
+ * that it shows up in the StepStats of the update it happens during.
+ *
+ * @return Number of allocations, or 0 if they aren't counted.
+ */
+uint64_t getAllocationCount();
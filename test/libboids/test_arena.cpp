@@ -0,0 +1,82 @@
+#include <arena.h>
+#include <cstdint>
+#include <flock_state.h>
+#include <gtest/gtest.h>
+
+/**
+ * @brief Check whether a pointer is aligned to a cache line.
+ * @param ptr Pointer.
+ * @return True if the pointer is aligned.
+ */
+static bool isCacheLineAligned(const void* ptr) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % boids::CACHE_LINE_SIZE == 0;
+}
+
+/**
+ * @brief Test that every allocation is aligned to its own cache line, and that a reset hands out
+ * the same memory again.
+ */
+TEST(libboids_arena, allocate) {
+    boids::Arena arena(1024);
+    ASSERT_EQ(arena.getCapacity(), 1024);
+
+    const std::span<float>    a = arena.allocate<float>(3);
+    const std::span<uint8_t>  b = arena.allocate<uint8_t>(1);
+    const std::span<uint64_t> c = arena.allocate<uint64_t>(16);
+    ASSERT_EQ(a.size(), 3);
+    ASSERT_EQ(c.size(), 16);
+    ASSERT_TRUE(isCacheLineAligned(a.data()));
+    ASSERT_TRUE(isCacheLineAligned(b.data()));
+    ASSERT_TRUE(isCacheLineAligned(c.data()));
+    ASSERT_EQ(arena.getUsed(), 4 * boids::CACHE_LINE_SIZE);
+
+    arena.reset();
+    ASSERT_EQ(arena.getUsed(), 0);
+    ASSERT_EQ(static_cast<void*>(arena.allocate<float>(3).data()), static_cast<void*>(a.data()));
+}
+
+/**
+ * @brief Test that a step that overflows the block still gets valid memory, and that the next
+ * reset grows the block to fit the whole step.
+ */
+TEST(libboids_arena, overflow) {
+    boids::Arena arena;
+    ASSERT_EQ(arena.getCapacity(), 0);
+
+    for (std::size_t i = 0; i < 4; ++i) {
+        const std::span<int32_t> values = arena.allocate<int32_t>(1000);
+        ASSERT_TRUE(isCacheLineAligned(values.data()));
+        for (std::size_t j = 0; j < values.size(); ++j) {
+            values[j] = int32_t(j);
+        }
+        ASSERT_EQ(values[999], 999);
+    }
+    const std::size_t used = arena.getUsed();
+    ASSERT_GE(used, 4 * 1000 * sizeof(int32_t));
+
+    arena.reset();
+    ASSERT_EQ(arena.getCapacity(), used);
+    for (std::size_t i = 0; i < 4; ++i) {
+        arena.allocate<int32_t>(1000);
+    }
+    ASSERT_EQ(arena.getUsed(), used);
+    arena.reset();
+    ASSERT_EQ(arena.getCapacity(), used);
+}
+
+/**
+ * @brief Test that the flock state arrays start on a cache line, however they are grown.
+ */
+TEST(libboids_arena, alignedVector) {
+    boids::FlockState state;
+    for (std::size_t i = 0; i < 100; ++i) {
+        state.push(boids::Boid(i, 0.0f, 0.0f, boids::BOID));
+        ASSERT_TRUE(isCacheLineAligned(state.x.data()));
+        ASSERT_TRUE(isCacheLineAligned(state.saturation.data()));
+        ASSERT_TRUE(isCacheLineAligned(state.id.data()));
+    }
+
+    const boids::FlockState copy = state;
+    ASSERT_TRUE(isCacheLineAligned(copy.vy.data()));
+    ASSERT_EQ(copy.x, state.x);
+}
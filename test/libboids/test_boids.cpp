@@ -5,7 +5,7 @@
 
 class BasicBoidInit : public ::testing::Test {
   protected:
-    uint16_t                     m_id;
+    boids::BoidId                m_id;
     std::unique_ptr<boids::Boid> m_boid;
 
     virtual void SetUp() {
@@ -28,8 +28,8 @@ TEST_F(BasicBoidInit, test_getAngle) { ASSERT_EQ(0.0f, m_boid->getAngle()); }
  * @brief Test that the initial position of the Boid is (0.0, 0.0).
  */
 TEST_F(BasicBoidInit, test_getPosition) {
-    const QPointF exp(0.0, 0.0);
-    const QPointF res = m_boid->getPosition();
+    const boids::Vec2 exp(0.0, 0.0);
+    const boids::Vec2 res = m_boid->getPosition();
     ASSERT_EQ(exp, res);
 }
 
@@ -47,8 +47,8 @@ TEST_F(BasicBoidInit, test_getType) {
  * @brief Test that the initial velocity of the Boid is (0.0, 0.0).
  */
 TEST_F(BasicBoidInit, test_getVelocity) {
-    const QVector2D exp(0.0, 0.0);
-    const QVector2D res = m_boid->getVelocity();
+    const boids::Vec2 exp(0.0, 0.0);
+    const boids::Vec2 res = m_boid->getVelocity();
     ASSERT_EQ(exp, res);
 }
 
@@ -56,7 +56,7 @@ TEST_F(BasicBoidInit, test_getVelocity) {
  * @brief Test that the initial colour of the Boid is not black.
  */
 TEST_F(BasicBoidInit, TestDefaultColorNotBlack) {
-    const QColor color(0.0, 0.0, 0, 0);
+    const boids::Color color(0.0, 0.0, 0, 0);
     ASSERT_FALSE(color == m_boid->getColor());
 }
 
@@ -64,9 +64,9 @@ TEST_F(BasicBoidInit, TestDefaultColorNotBlack) {
  * @brief Test that the setColour() method works as expected.
  */
 TEST_F(BasicBoidInit, test_setColor) {
-    const QColor exp(1, 2, 3);
+    const boids::Color exp(1, 2, 3);
     m_boid->setColor(exp);
-    const QColor res = m_boid->getColor();
+    const boids::Color res = m_boid->getColor();
     ASSERT_EQ(exp, res);
 }
 
@@ -74,9 +74,9 @@ TEST_F(BasicBoidInit, test_setColor) {
  * @brief Test that the setVelocity() method works as expected.
  */
 TEST_F(BasicBoidInit, test_setVelocity) {
-    const QVector2D exp(10.0, 20.0);
+    const boids::Vec2 exp(10.0, 20.0);
     m_boid->setVelocity(exp);
-    const QVector2D res = m_boid->getVelocity();
+    const boids::Vec2 res = m_boid->getVelocity();
     ASSERT_EQ(exp, res);
 }
 
@@ -85,7 +85,7 @@ TEST_F(BasicBoidInit, test_setVelocity) {
  */
 class InitObstacleBoid : public ::testing::Test {
   protected:
-    uint16_t                     m_id;
+    boids::BoidId                m_id;
     boids::BoidType              m_type;
     std::unique_ptr<boids::Boid> m_boid;
 
@@ -110,7 +110,7 @@ TEST_F(InitObstacleBoid, test_getType) {
  */
 class InitPredatorBoid : public ::testing::Test {
   protected:
-    uint16_t                     m_id;
+    boids::BoidId                m_id;
     boids::BoidType              m_type;
     std::unique_ptr<boids::Boid> m_boid;
 
@@ -0,0 +1,85 @@
+#include <boundary.h>
+#include <gtest/gtest.h>
+
+/**
+ * @brief Test that the periodic displacement takes the shortest way across the scene, matching
+ * utils::shortestDistanceInWrapedSpace().
+ */
+TEST(libboids_boundary, periodic_displacement) {
+    using boids::boundary::Periodic;
+    ASSERT_FLOAT_EQ(Periodic::displacement(10.0f, 100.0f), 10.0f);
+    ASSERT_FLOAT_EQ(Periodic::displacement(90.0f, 100.0f), -10.0f);
+    ASSERT_FLOAT_EQ(Periodic::displacement(-90.0f, 100.0f), 10.0f);
+    for (const float x : {1.0f, 30.0f, 49.0f, 51.0f, 99.0f}) {
+        ASSERT_FLOAT_EQ(Periodic::displacement(x - 20.0f, 100.0f),
+                        boids::utils::shortestDistanceInWrapedSpace(20.0f, x, 0.0f, 100.0f));
+    }
+}
+
+/**
+ * @brief Test that a periodic scene wraps positions around, leaving the velocity alone.
+ */
+TEST(libboids_boundary, periodic_integrate) {
+    float pos = 103.0f;
+    float vel = 4.0f;
+    boids::boundary::Periodic::integrate(pos, vel, 0.0f, 100.0f);
+    ASSERT_FLOAT_EQ(pos, 3.0f);
+    ASSERT_FLOAT_EQ(vel, 4.0f);
+}
+
+/**
+ * @brief Test that the walls of a reflecting scene mirror positions back in and reverse the
+ * velocity, and that the displacements aren't wrapped.
+ */
+TEST(libboids_boundary, reflecting_integrate) {
+    using boids::boundary::Reflecting;
+    ASSERT_FLOAT_EQ(Reflecting::displacement(90.0f, 100.0f), 90.0f);
+
+    float pos = 103.0f;
+    float vel = 4.0f;
+    Reflecting::integrate(pos, vel, 0.0f, 100.0f);
+    ASSERT_FLOAT_EQ(pos, 97.0f);
+    ASSERT_FLOAT_EQ(vel, -4.0f);
+
+    pos = -2.0f;
+    vel = -3.0f;
+    Reflecting::integrate(pos, vel, 0.0f, 100.0f);
+    ASSERT_FLOAT_EQ(pos, 2.0f);
+    ASSERT_FLOAT_EQ(vel, 3.0f);
+
+    pos = 50.0f;
+    vel = -3.0f;
+    Reflecting::integrate(pos, vel, 0.0f, 100.0f);
+    ASSERT_FLOAT_EQ(pos, 50.0f);
+    ASSERT_FLOAT_EQ(vel, -3.0f);
+
+    // Overshooting by more than the whole scene still ends up inside it.
+    pos = 250.0f;
+    Reflecting::integrate(pos, vel, 0.0f, 100.0f);
+    ASSERT_FLOAT_EQ(pos, 0.0f);
+}
+
+/**
+ * @brief Test that an unbounded scene leaves positions alone.
+ */
+TEST(libboids_boundary, unbounded_integrate) {
+    using boids::boundary::Unbounded;
+    ASSERT_FLOAT_EQ(Unbounded::displacement(90.0f, 100.0f), 90.0f);
+
+    float pos = 103.0f;
+    float vel = 4.0f;
+    Unbounded::integrate(pos, vel, 0.0f, 100.0f);
+    ASSERT_FLOAT_EQ(pos, 103.0f);
+    ASSERT_FLOAT_EQ(vel, 4.0f);
+}
+
+/**
+ * @brief Test that each boundary mode is visited with its own policy.
+ */
+TEST(libboids_boundary, visit) {
+    for (const auto mode : {boids::PERIODIC, boids::REFLECTING, boids::UNBOUNDED}) {
+        const boids::BoundaryMode visited =
+            boids::boundary::visit(mode, [](auto policy) { return decltype(policy)::MODE; });
+        ASSERT_EQ(visited, mode);
+    }
+}
@@ -1,5 +1,10 @@
+#include "allocation_audit.h"
+#include <algorithm>
+#include <cmath>
 #include <flock.h>
 #include <gtest/gtest.h>
+#include <memory>
+#include <thread>
 
 TEST(libboids_flock, addBoid_1) {
     boids::Flock flock;
@@ -16,11 +21,17 @@ TEST(libboids_flock, addBoid_2) {
 }
 
 TEST(libboids_flock, addBoid_3) {
-    boids::Flock flock;
-    ASSERT_EQ(flock.addBoid(0.0f, 0.0f), 0);
-    ASSERT_EQ(flock.addBoid(0.0f, 0.0f), 1);
+    boids::Flock        flock;
+    const boids::BoidId a = flock.addBoid(0.0f, 0.0f);
+    const boids::BoidId b = flock.addBoid(0.0f, 0.0f);
+    ASSERT_EQ(a, 0);
+    ASSERT_EQ(b, 1);
     flock.clearBoids();
-    ASSERT_EQ(flock.addBoid(0.0f, 0.0f), 2);
+    const boids::BoidId c = flock.addBoid(0.0f, 0.0f);
+    ASSERT_NE(c, a);
+    ASSERT_NE(c, b);
+    ASSERT_FALSE(flock.hasBoid(a));
+    ASSERT_TRUE(flock.hasBoid(c));
 }
 
 TEST(libboids_flock, clearBoids_1) {
@@ -69,10 +80,9 @@ TEST(libboids_flock, clearBoids_boidType) {
 }
 
 /**
- * @brief Test the Flock::getBoids() method to check that it returns all the boids as expected.
- *
+ * @brief Test that the boids of each type are counted, and can be looked up by ID.
  */
-TEST(libboids_flock, getBoids) {
+TEST(libboids_flock, getBoid) {
     boids::Flock flock;
 
     for (std::size_t n = 0; n < 1; ++n) {
@@ -86,22 +96,26 @@ TEST(libboids_flock, getBoids) {
     for (std::size_t n = 0; n < 3; ++n) {
         flock.addBoid(0.0f, 0.0f, boids::PREDATOR);
     }
+    const boids::BoidId id = flock.addBoid(5.0f, 6.0f, boids::PREDATOR);
+
+    ASSERT_EQ(flock.getNumBoids(boids::BOID), 1);
+    ASSERT_EQ(flock.getNumBoids(boids::OBSTACLE), 2);
+    ASSERT_EQ(flock.getNumBoids(boids::PREDATOR), 4);
 
-    const auto ret      = flock.getBoids();
-    const auto retBoids = ret.at(boids::BOID);
-    const auto retObs   = ret.at(boids::OBSTACLE);
-    const auto retPred  = ret.at(boids::PREDATOR);
+    const boids::ConstBoidView view = flock.getBoid(id);
+    ASSERT_EQ(view.getId(), id);
+    ASSERT_EQ(view.getType(), boids::PREDATOR);
+    ASSERT_EQ(view.getPosition(), boids::Vec2(5.0f, 6.0f));
 
-    ASSERT_EQ(retBoids.size(), 1);
-    ASSERT_EQ(retObs.size(), 2);
-    ASSERT_EQ(retPred.size(), 3);
+    flock.removeBoid(id);
+    ASSERT_THROW(flock.getBoid(id), std::invalid_argument);
 }
 
 TEST(libboids_flock, setSceneBounds) {
-    boids::Flock flock;
-    const QRectF exp(0.0f, 0.0f, 10.0f, 10.0f);
+    boids::Flock      flock;
+    const boids::Rect exp(0.0f, 0.0f, 10.0f, 10.0f);
     flock.setSceneBounds(exp);
-    const QRectF res = flock.getSceneBounds();
+    const boids::Rect res = flock.getSceneBounds();
 
     ASSERT_FLOAT_EQ(res.bottom(), exp.bottom());
     ASSERT_FLOAT_EQ(res.top(), exp.top());
@@ -148,9 +162,9 @@ class FullFlockTest : public testing::Test {
  */
 TEST_F(FullFlockTest, clearBoids_boids) {
     m_flock.clearBoids(boids::BOID);
-    ASSERT_EQ(m_flock.getBoids().at(boids::BOID).size(), 0);
-    ASSERT_EQ(m_flock.getBoids().at(boids::OBSTACLE).size(), 10);
-    ASSERT_EQ(m_flock.getBoids().at(boids::PREDATOR).size(), 10);
+    ASSERT_EQ(m_flock.getNumBoids(boids::BOID), 0);
+    ASSERT_EQ(m_flock.getNumBoids(boids::OBSTACLE), 10);
+    ASSERT_EQ(m_flock.getNumBoids(boids::PREDATOR), 10);
 }
 
 /**
@@ -158,9 +172,9 @@ TEST_F(FullFlockTest, clearBoids_boids) {
  */
 TEST_F(FullFlockTest, clearBoids_obstalces) {
     m_flock.clearBoids(boids::OBSTACLE);
-    ASSERT_EQ(m_flock.getBoids().at(boids::BOID).size(), 10);
-    ASSERT_EQ(m_flock.getBoids().at(boids::OBSTACLE).size(), 0);
-    ASSERT_EQ(m_flock.getBoids().at(boids::PREDATOR).size(), 10);
+    ASSERT_EQ(m_flock.getNumBoids(boids::BOID), 10);
+    ASSERT_EQ(m_flock.getNumBoids(boids::OBSTACLE), 0);
+    ASSERT_EQ(m_flock.getNumBoids(boids::PREDATOR), 10);
 }
 
 /**
@@ -168,12 +182,744 @@ TEST_F(FullFlockTest, clearBoids_obstalces) {
  */
 TEST_F(FullFlockTest, clearBoids_predators) {
     m_flock.clearBoids(boids::PREDATOR);
-    ASSERT_EQ(m_flock.getBoids().at(boids::BOID).size(), 10);
-    ASSERT_EQ(m_flock.getBoids().at(boids::OBSTACLE).size(), 10);
-    ASSERT_EQ(m_flock.getBoids().at(boids::PREDATOR).size(), 0);
+    ASSERT_EQ(m_flock.getNumBoids(boids::BOID), 10);
+    ASSERT_EQ(m_flock.getNumBoids(boids::OBSTACLE), 10);
+    ASSERT_EQ(m_flock.getNumBoids(boids::PREDATOR), 0);
 }
 
 /**
  * @brief Test that the Flock::update() doesn't throw any exceptions when called.
  */
 TEST_F(FullFlockTest, update_noThrow) { ASSERT_NO_THROW(m_flock.update()); }
+
+/**
+ * @brief Test that getting and setting the update mode works.
+ */
+TEST(libboids_flock, setUpdateMode) {
+    boids::Flock flock;
+    ASSERT_EQ(flock.getUpdateMode(), boids::IN_PLACE);
+    flock.setUpdateMode(boids::DOUBLE_BUFFERED);
+    ASSERT_EQ(flock.getUpdateMode(), boids::DOUBLE_BUFFERED);
+}
+
+/**
+ * @brief Test that the Flock::update() doesn't throw any exceptions when using the legacy in-place
+ * update.
+ */
+TEST_F(FullFlockTest, update_inPlace_noThrow) {
+    m_flock.setUpdateMode(boids::IN_PLACE);
+    ASSERT_NO_THROW(m_flock.update());
+}
+
+/**
+ * @brief Test that a double-buffered update keeps every boid, with its ID, type and colour, and
+ * leaves the obstacles untouched.
+ */
+TEST_F(FullFlockTest, update_doubleBuffered) {
+    m_flock.setUpdateMode(boids::DOUBLE_BUFFERED);
+    m_flock.setSceneBounds(boids::Rect(0.0f, 0.0f, 100.0f, 100.0f));
+    m_flock.addBoid(50.0f, 50.0f, boids::OBSTACLE);
+    const boids::FlockState beforeState = m_flock.getState();
+
+    m_flock.update();
+    m_flock.update();
+
+    const boids::FlockState& afterState = m_flock.getState();
+    ASSERT_EQ(afterState.id, beforeState.id);
+    ASSERT_EQ(afterState.type, beforeState.type);
+    ASSERT_EQ(afterState.saturation, beforeState.saturation);
+    ASSERT_EQ(afterState.value, beforeState.value);
+
+    ASSERT_EQ(m_flock.getNumBoids(boids::BOID), 10);
+    ASSERT_EQ(m_flock.getNumBoids(boids::PREDATOR), 10);
+    ASSERT_EQ(m_flock.getNumBoids(boids::OBSTACLE), 11);
+    for (std::size_t i = 0; i < beforeState.size(); ++i) {
+        if (beforeState.type[i] != boids::OBSTACLE)
+            continue;
+        ASSERT_EQ(m_flock.getBoid(beforeState.id[i]).getPosition(),
+                  beforeState.view(i).getPosition());
+    }
+}
+
+/**
+ * @brief Test that a double-buffered update doesn't depend on the order that the boids are stored
+ * in: two flocks holding the same boids in a different order move each boid in the same way.
+ */
+TEST(libboids_flock, update_doubleBuffered_orderIndependent) {
+    const boids::Rect bounds(0.0f, 0.0f, 200.0f, 200.0f);
+    boids::Flock      a(1, 1);
+    boids::Flock      b(1, 1);
+    for (boids::Flock* flock : {&a, &b}) {
+        flock->setUpdateMode(boids::DOUBLE_BUFFERED);
+        flock->setSceneBounds(bounds);
+        flock->spawnUniform(300, bounds);
+        flock->spawnUniform(10, bounds, boids::PREDATOR);
+        flock->spawnUniform(5, bounds, boids::OBSTACLE);
+    }
+
+    // Removing the same boids in the opposite order moves different boids into the freed slots,
+    // so the flocks end up with the same boids stored in a different order.
+    for (boids::BoidId id = 0; id < 50; ++id) {
+        ASSERT_TRUE(a.removeBoid(2 * id));
+        ASSERT_TRUE(b.removeBoid(98 - 2 * id));
+    }
+    ASSERT_NE(a.getState().id, b.getState().id);
+
+    a.update();
+    b.update();
+
+    const boids::FlockState& sa = a.getState();
+    const boids::FlockState& sb = b.getState();
+    ASSERT_EQ(sa.size(), sb.size());
+    for (std::size_t i = 0; i < sa.size(); ++i) {
+        const std::size_t j = b.getIndex(sa.id[i]);
+        ASSERT_NEAR(sa.x[i], sb.x[j], 1e-4f) << "boid " << sa.id[i];
+        ASSERT_NEAR(sa.y[i], sb.y[j], 1e-4f) << "boid " << sa.id[i];
+        ASSERT_NEAR(sa.vx[i], sb.vx[j], 1e-4f) << "boid " << sa.id[i];
+        ASSERT_NEAR(sa.vy[i], sb.vy[j], 1e-4f) << "boid " << sa.id[i];
+        ASSERT_NEAR(sa.hue[i], sb.hue[j], 1e-3f) << "boid " << sa.id[i];
+    }
+}
+
+/**
+ * @brief Test that getting and setting the number of threads works.
+ */
+TEST(libboids_flock, setNumThreads) {
+    boids::Flock flock(2);
+    ASSERT_EQ(flock.getNumThreads(), 2);
+    flock.setNumThreads(4);
+    ASSERT_EQ(flock.getNumThreads(), 4);
+    flock.setNumThreads(0);
+    ASSERT_EQ(flock.getNumThreads(), 1);
+}
+
+/**
+ * @brief Test that a multithreaded update keeps every boid in the flock.
+ */
+TEST_F(FullFlockTest, update_multithreaded) {
+    m_flock.setUpdateMode(boids::DOUBLE_BUFFERED);
+    m_flock.setSceneBounds(boids::Rect(0.0f, 0.0f, 100.0f, 100.0f));
+    m_flock.setNumThreads(4);
+    ASSERT_NO_THROW(m_flock.update());
+    m_flock.setNumThreads(2);
+    ASSERT_NO_THROW(m_flock.update());
+    ASSERT_EQ(m_flock.getNumBoids(), 30);
+}
+
+/**
+ * @brief Test that two flocks with the same seed produce exactly the same boids, whatever the
+ * number of threads used to update them.
+ */
+TEST(libboids_flock, seed_reproducible) {
+    boids::Flock a(1, 1234);
+    boids::Flock b(4, 1234);
+    ASSERT_EQ(a.getSeed(), 1234);
+
+    for (boids::Flock* flock : {&a, &b}) {
+        flock->setUpdateMode(boids::DOUBLE_BUFFERED);
+        flock->setSceneBounds(boids::Rect(0.0f, 0.0f, 200.0f, 200.0f));
+        for (std::size_t i = 0; i < 200; ++i) {
+            flock->addBoid(float(i % 20) * 10.0f, float(i / 20) * 20.0f,
+                           i % 10 == 0 ? boids::PREDATOR : boids::BOID);
+        }
+        for (std::size_t i = 0; i < 10; ++i) {
+            flock->update();
+        }
+    }
+
+    const boids::FlockState& sa = a.getState();
+    const boids::FlockState& sb = b.getState();
+    ASSERT_EQ(sa.size(), sb.size());
+    for (std::size_t i = 0; i < sa.size(); ++i) {
+        ASSERT_EQ(sa.x[i], sb.x[i]);
+        ASSERT_EQ(sa.y[i], sb.y[i]);
+        ASSERT_EQ(sa.hue[i], sb.hue[i]);
+    }
+}
+
+/**
+ * @brief Test that reseeding a flock restarts its random streams.
+ */
+TEST(libboids_flock, setSeed) {
+    boids::Flock flock(1, 1);
+    flock.setSeed(99);
+    ASSERT_EQ(flock.getSeed(), 99);
+    flock.addBoid(10.0f, 10.0f);
+    const boids::Vec2 first = flock.getState().view(0).getVelocity();
+
+    flock.clearBoids();
+    flock.setSeed(99);
+    flock.addBoid(10.0f, 10.0f);
+    ASSERT_EQ(flock.getState().view(0).getVelocity(), first);
+}
+
+/**
+ * @brief Test that a snapshot holds a copy of the current state, and reuses its storage when it is
+ * taken again.
+ */
+TEST(libboids_flock, getSnapshot) {
+    boids::Flock flock(1, 1);
+    flock.setSceneBounds(boids::Rect(0.0f, 0.0f, 100.0f, 100.0f));
+    for (std::size_t i = 0; i < 100; ++i) {
+        flock.addBoid(float(i), float(i));
+    }
+    flock.update();
+
+    boids::FlockSnapshot snapshot;
+    flock.getSnapshot(snapshot);
+    ASSERT_EQ(snapshot.step, 1);
+    ASSERT_EQ(snapshot.stats.step, flock.getStepStatsWindow().getMean().step);
+    ASSERT_EQ(snapshot.state.size(), 100);
+    ASSERT_EQ(snapshot.state.x, flock.getState().x);
+    ASSERT_EQ(snapshot.state.vy, flock.getState().vy);
+    ASSERT_EQ(snapshot.state.id, flock.getState().id);
+
+    const float* data = snapshot.state.x.data();
+    const auto   time = snapshot.time;
+    flock.update();
+    flock.getSnapshot(snapshot);
+    ASSERT_EQ(snapshot.step, 2);
+    ASSERT_GE(snapshot.time, time);
+    ASSERT_EQ(snapshot.state.x, flock.getState().x);
+    ASSERT_EQ(snapshot.state.x.data(), data);
+}
+
+/**
+ * @brief Test that removing a boid by ID removes only that boid.
+ */
+TEST(libboids_flock, removeBoid) {
+    boids::Flock        flock;
+    const boids::BoidId a = flock.addBoid(0.0f, 0.0f);
+    const boids::BoidId b = flock.addBoid(1.0f, 1.0f);
+    ASSERT_TRUE(flock.removeBoid(a));
+    ASSERT_FALSE(flock.removeBoid(a));
+    ASSERT_EQ(flock.getNumBoids(), 1);
+    ASSERT_EQ(flock.getState().id[0], b);
+}
+
+/**
+ * @brief Test that IDs keep pointing at the right boids as other boids are removed and added.
+ */
+TEST(libboids_flock, removeBoid_stableIds) {
+    boids::Flock               flock(1, 3);
+    std::vector<boids::BoidId> ids;
+    for (std::size_t i = 0; i < 100; ++i) {
+        ids.push_back(flock.addBoid(float(i), 0.0f, i % 2 ? boids::BOID : boids::OBSTACLE));
+    }
+
+    // Remove every third boid, then add some more, which reuse the freed slots.
+    std::vector<boids::BoidId> removed;
+    for (std::size_t i = 0; i < ids.size(); i += 3) {
+        ASSERT_TRUE(flock.removeBoid(ids[i]));
+        removed.push_back(ids[i]);
+    }
+    for (std::size_t i = 0; i < 10; ++i) {
+        const boids::BoidId id = flock.addBoid(1000.0f + float(i), 0.0f);
+        ASSERT_EQ(std::count(ids.begin(), ids.end(), id), 0);
+        ASSERT_EQ(flock.getState().x[flock.getIndex(id)], 1000.0f + float(i));
+    }
+
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        if (i % 3 == 0) {
+            ASSERT_FALSE(flock.hasBoid(ids[i]));
+            ASSERT_THROW(flock.getIndex(ids[i]), std::invalid_argument);
+            continue;
+        }
+        ASSERT_EQ(flock.getState().x[flock.getIndex(ids[i])], float(i));
+    }
+
+    flock.clearBoids(boids::OBSTACLE);
+    for (std::size_t i = 1; i < ids.size(); i += 2) {
+        if (i % 3 != 0) {
+            ASSERT_EQ(flock.getState().x[flock.getIndex(ids[i])], float(i));
+        }
+    }
+    ASSERT_FALSE(flock.hasBoid(ids[2]));
+}
+
+/**
+ * @brief Test that posted commands are only applied at the start of the next update, in the order
+ * they were posted.
+ */
+TEST(libboids_flock, post_appliedOnUpdate) {
+    boids::Flock flock(1, 1);
+    flock.setSceneBounds(boids::Rect(0.0f, 0.0f, 100.0f, 100.0f));
+
+    boids::Config cfg;
+    cfg.maxVelocity = 3.0f;
+    flock.post(boids::command::AddBoid{10.0f, 10.0f, boids::BOID});
+    flock.post(boids::command::AddBoid{20.0f, 20.0f, boids::PREDATOR});
+    flock.post(boids::command::AddBoid{30.0f, 30.0f, boids::OBSTACLE});
+    flock.post(boids::command::SetConfig{cfg, boids::PREDATOR});
+    ASSERT_EQ(flock.getNumBoids(), 0);
+
+    flock.update();
+    ASSERT_EQ(flock.getNumBoids(), 3);
+    ASSERT_EQ(flock.getConfig(boids::PREDATOR).maxVelocity, 3.0f);
+
+    flock.post(boids::command::ClearBoidsOfType{boids::PREDATOR});
+    flock.post(boids::command::RemoveBoid{0});
+    ASSERT_EQ(flock.applyCommands(), 2);
+    ASSERT_EQ(flock.getNumBoids(), 1);
+    ASSERT_EQ(flock.getState().type[0], boids::OBSTACLE);
+
+    flock.post(boids::command::SetSceneBounds{boids::Rect(0.0f, 0.0f, 50.0f, 50.0f)});
+    flock.post(boids::command::ClearBoids{});
+    flock.update();
+    ASSERT_EQ(flock.getNumBoids(), 0);
+    ASSERT_EQ(flock.getSceneBounds(), boids::Rect(0.0f, 0.0f, 50.0f, 50.0f));
+}
+
+/**
+ * @brief Test that commands can be posted from other threads while the flock is being updated.
+ */
+TEST(libboids_flock, post_concurrent) {
+    constexpr std::size_t numPosters = 2;
+    constexpr std::size_t numBoids   = 500;
+    boids::Flock          flock(2, 1);
+    flock.setSceneBounds(boids::Rect(0.0f, 0.0f, 100.0f, 100.0f));
+
+    std::vector<std::thread> posters;
+    for (std::size_t p = 0; p < numPosters; ++p) {
+        posters.emplace_back([&flock]() {
+            for (std::size_t i = 0; i < numBoids; ++i) {
+                flock.post(boids::command::AddBoid{float(i % 100), float(i % 100)});
+            }
+        });
+    }
+    for (std::size_t i = 0; i < 20; ++i) {
+        flock.update();
+    }
+    for (auto& t : posters) {
+        t.join();
+    }
+    flock.update();
+    ASSERT_EQ(flock.getNumBoids(), numPosters * numBoids);
+}
+
+/**
+ * @brief Test that once every boid ID is in use, posted commands that add boids are rejected rather
+ * than thrown from the update, while the other commands are still applied.
+ */
+TEST(libboids_flock, post_rejectedWithoutIds) {
+    constexpr std::size_t maxBoids = boids::SlotMap::MAX_SLOTS;
+    const boids::Rect     bounds(0.0f, 0.0f, 100.0f, 100.0f);
+    boids::Flock          flock(1, 1);
+    flock.setSceneBounds(bounds);
+    flock.spawnUniform(maxBoids - 1, bounds, boids::OBSTACLE);
+    ASSERT_TRUE(flock.canAddBoids(1));
+    ASSERT_FALSE(flock.canAddBoids(2));
+
+    // A direct call that doesn't fit throws, without adding any of the boids.
+    ASSERT_THROW(flock.spawnUniform(2, bounds), std::length_error);
+    ASSERT_EQ(flock.getNumBoids(), maxBoids - 1);
+
+    flock.post(boids::command::SpawnUniform{2, bounds});
+    flock.post(boids::command::AddBoid{10.0f, 10.0f});
+    flock.post(boids::command::AddBoid{20.0f, 20.0f});
+    flock.post(boids::command::SetSceneBounds{boids::Rect(0.0f, 0.0f, 50.0f, 50.0f)});
+    ASSERT_EQ(flock.applyCommands(), 2);
+    ASSERT_EQ(flock.getNumRejectedCommands(), 2);
+    ASSERT_EQ(flock.getNumBoids(), maxBoids);
+    ASSERT_FALSE(flock.canAddBoids(1));
+    ASSERT_EQ(flock.getSceneBounds(), boids::Rect(0.0f, 0.0f, 50.0f, 50.0f));
+
+    // Removing a boid frees its ID for the next add.
+    flock.removeBoid(flock.getState().id[0]);
+    flock.post(boids::command::AddBoid{30.0f, 30.0f});
+    ASSERT_EQ(flock.applyCommands(), 1);
+    ASSERT_EQ(flock.getNumRejectedCommands(), 2);
+    ASSERT_EQ(flock.getNumBoids(), maxBoids);
+}
+
+/**
+ * @brief Test that adding a batch of boids gives the same flock as adding them one at a time, and
+ * returns the IDs given to them.
+ */
+TEST(libboids_flock, addBoids_matchesAddBoid) {
+    std::vector<boids::Vec2> positions;
+    for (std::size_t i = 0; i < 100; ++i) {
+        positions.emplace_back(float(i), float(2 * i));
+    }
+
+    boids::Flock single(1, 5);
+    for (const auto& p : positions) {
+        single.addBoid(p.x(), p.y(), boids::PREDATOR);
+    }
+
+    boids::Flock                         batch(1, 5);
+    const std::span<const boids::BoidId> ids = batch.addBoids(positions, boids::PREDATOR);
+    ASSERT_EQ(ids.size(), 100);
+    ASSERT_EQ(ids.front(), 0);
+    ASSERT_EQ(ids.back(), 99);
+    ASSERT_EQ(batch.getNumBoids(), 100);
+
+    const boids::FlockState& a = single.getState();
+    const boids::FlockState& b = batch.getState();
+    ASSERT_EQ(a.x, b.x);
+    ASSERT_EQ(a.y, b.y);
+    ASSERT_EQ(a.vx, b.vx);
+    ASSERT_EQ(a.vy, b.vy);
+    ASSERT_EQ(a.hue, b.hue);
+    ASSERT_EQ(a.id, b.id);
+    ASSERT_EQ(a.type, b.type);
+
+    ASSERT_EQ(batch.addBoids(positions).front(), 100);
+}
+
+/**
+ * @brief Test that boids spawned uniformly are inside the rectangle, and that a large batch split
+ * across threads gives the same flock as one built on a single thread.
+ */
+TEST(libboids_flock, spawnUniform) {
+    const boids::Rect rect(10.0f, 20.0f, 300.0f, 200.0f);
+    boids::Flock      a(1, 9);
+    boids::Flock      b(4, 9);
+    a.spawnUniform(3, rect, boids::OBSTACLE);
+    b.spawnUniform(3, rect, boids::OBSTACLE);
+
+    const std::span<const boids::BoidId> ids = a.spawnUniform(10000, rect);
+    b.spawnUniform(10000, rect);
+    ASSERT_EQ(ids.size(), 10000);
+    ASSERT_EQ(ids.front(), 3);
+
+    const boids::FlockState& s = a.getState();
+    ASSERT_EQ(s.size(), 10003);
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        ASSERT_GE(s.x[i], rect.left());
+        ASSERT_LE(s.x[i], rect.right());
+        ASSERT_GE(s.y[i], rect.top());
+        ASSERT_LE(s.y[i], rect.bottom());
+    }
+    ASSERT_EQ(s.type[0], boids::OBSTACLE);
+    ASSERT_EQ(s.type[3], boids::BOID);
+    ASSERT_EQ(s.x, b.getState().x);
+    ASSERT_EQ(s.vy, b.getState().vy);
+    ASSERT_EQ(s.hue, b.getState().hue);
+}
+
+/**
+ * @brief Test that each update records its stats, and that the counters add up, in both update
+ * modes.
+ */
+TEST(libboids_flock, getStepStats) {
+#ifndef BOIDS_STEP_STATS
+    GTEST_SKIP() << "Built without BOIDS_STEP_STATS";
+#endif
+    for (const auto mode : {boids::IN_PLACE, boids::DOUBLE_BUFFERED}) {
+        boids::Flock flock(2, 1);
+        flock.setUpdateMode(mode);
+        flock.setSceneBounds(boids::Rect(0.0f, 0.0f, 200.0f, 200.0f));
+        flock.spawnUniform(500, boids::Rect(0.0f, 0.0f, 200.0f, 200.0f));
+        flock.spawnUniform(5, boids::Rect(0.0f, 0.0f, 200.0f, 200.0f), boids::PREDATOR);
+        flock.spawnUniform(5, boids::Rect(0.0f, 0.0f, 200.0f, 200.0f), boids::OBSTACLE);
+
+        for (std::size_t i = 0; i < 5; ++i) {
+            flock.update();
+        }
+
+        const boids::StepStats& s = flock.getStepStats();
+        ASSERT_EQ(s.step, 4);
+        ASSERT_EQ(s.numBoids, 505);
+        ASSERT_GT(s.totalNs, 0);
+        ASSERT_GE(s.totalNs, s.commandsNs + s.gridNs);
+        ASSERT_GT(s.neighboursNs, 0);
+        ASSERT_GE(s.distanceTests, s.neighbours);
+        ASSERT_GT(s.neighbours, 0);
+        ASSERT_GE(double(s.maxNeighbours), s.getMeanNeighbours());
+
+        const boids::StepStatsWindow& window = flock.getStepStatsWindow();
+        ASSERT_EQ(window.size(), 5);
+        ASSERT_EQ(window.at(0).step, 0);
+    }
+}
+
+/**
+ * @brief Test that the metrics reduced inside the update, over several threads, match the ones
+ * calculated from the state that the update started from.
+ */
+TEST(libboids_flock, getMetrics) {
+    boids::Flock flock(3, 1);
+    flock.setUpdateMode(boids::DOUBLE_BUFFERED);
+    flock.setSceneBounds(boids::Rect(0.0f, 0.0f, 200.0f, 100.0f));
+    flock.spawnUniform(400, boids::Rect(0.0f, 0.0f, 200.0f, 100.0f));
+    flock.spawnUniform(5, boids::Rect(0.0f, 0.0f, 200.0f, 100.0f), boids::PREDATOR);
+    flock.update();
+
+    const boids::FlockState s = flock.getState();
+
+    double      headingX = 0.0;
+    double      headingY = 0.0;
+    std::size_t n        = 0;
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        if (s.type[i] != boids::BOID)
+            continue;
+        const double speed = std::hypot(double(s.vx[i]), double(s.vy[i]));
+        headingX += s.vx[i] / speed;
+        headingY += s.vy[i] / speed;
+        n++;
+    }
+    flock.update();
+
+    const boids::FlockMetrics& m = flock.getMetrics();
+    ASSERT_EQ(m.step, 1);
+    ASSERT_EQ(m.numBoids, n);
+    ASSERT_NEAR(m.polarisation, std::hypot(headingX, headingY) / double(n), 1e-6);
+    ASSERT_NEAR(m.density, double(n) / 20000.0, 1e-12);
+    ASSERT_GT(m.meanNearestDistance, 0.0);
+    ASSERT_LT(m.meanNearestDistance, flock.getConfig(boids::BOID).neighbourhoodRadius);
+    ASSERT_GT(m.localDensity, 0.0);
+
+    boids::FlockSnapshot snapshot;
+    flock.getSnapshot(snapshot);
+    ASSERT_EQ(snapshot.metrics.step, m.step);
+    ASSERT_EQ(snapshot.metrics.polarisation, m.polarisation);
+}
+
+/**
+ * @brief Test that the clusters are only searched for at the set interval, in both update modes,
+ * and that every BOID belongs to exactly one cluster.
+ */
+TEST(libboids_flock, getClusters) {
+    for (const auto mode : {boids::IN_PLACE, boids::DOUBLE_BUFFERED}) {
+        boids::Flock flock(2, 1);
+        flock.setUpdateMode(mode);
+        flock.setSceneBounds(boids::Rect(0.0f, 0.0f, 400.0f, 400.0f));
+        flock.spawnUniform(300, boids::Rect(0.0f, 0.0f, 400.0f, 400.0f));
+        flock.spawnUniform(10, boids::Rect(0.0f, 0.0f, 400.0f, 400.0f), boids::OBSTACLE);
+        ASSERT_EQ(flock.getClusterInterval(), 0);
+
+        flock.update();
+        ASSERT_TRUE(flock.getClusters().clusters.empty());
+
+        flock.setClusterInterval(2);
+        ASSERT_EQ(flock.getClusterInterval(), 2);
+        for (std::size_t i = 0; i < 2; ++i) {
+            flock.update();
+        }
+
+        const boids::FlockClusters& c = flock.getClusters();
+        ASSERT_EQ(c.step, 2);
+        ASSERT_FALSE(c.clusters.empty());
+
+        std::size_t total = 0;
+        for (const boids::Cluster& cluster : c.clusters) {
+            total += cluster.size;
+        }
+        ASSERT_EQ(total, 300);
+        ASSERT_TRUE(std::is_sorted(
+            c.clusters.begin(), c.clusters.end(),
+            [](const boids::Cluster& a, const boids::Cluster& b) { return a.size > b.size; }));
+    }
+}
+
+/**
+ * @brief Test that the allocation audit counts allocations, so that the tests relying on it can't
+ * pass just because nothing is counted.
+ */
+TEST(libboids_flock, allocationAudit) {
+#ifndef BOIDS_ALLOCATION_AUDIT
+    GTEST_SKIP() << "Built without BOIDS_ALLOCATION_AUDIT";
+#endif
+    const uint64_t before = getAllocationCount();
+    auto           boid   = std::make_unique<boids::Boid>(0, 0.0f, 0.0f, boids::BOID);
+    std::thread([]() { std::vector<int> values(100); }).join();
+    ASSERT_GE(getAllocationCount() - before, 2);
+}
+
+/**
+ * @brief Test that once a flock has warmed up, an update makes no heap allocations on any thread,
+ * in both update modes, with and without worker threads, and while searching for clusters.
+ */
+TEST(libboids_flock, update_noAllocations) {
+#ifndef BOIDS_ALLOCATION_AUDIT
+    GTEST_SKIP() << "Built without BOIDS_ALLOCATION_AUDIT";
+#endif
+    for (const auto mode : {boids::IN_PLACE, boids::DOUBLE_BUFFERED}) {
+        for (const std::size_t threads : {1, 3}) {
+            for (const float skin : {0.0f, 10.0f}) {
+                boids::Flock flock(threads, 1);
+                flock.setUpdateMode(mode);
+                flock.setClusterInterval(2);
+                flock.setNeighbourSkin(skin);
+                flock.setSceneBounds(boids::Rect(0.0f, 0.0f, 400.0f, 400.0f));
+                flock.spawnUniform(1000, boids::Rect(0.0f, 0.0f, 400.0f, 400.0f));
+                flock.spawnUniform(5, boids::Rect(0.0f, 0.0f, 400.0f, 400.0f), boids::PREDATOR);
+                flock.spawnUniform(5, boids::Rect(0.0f, 0.0f, 400.0f, 400.0f), boids::OBSTACLE);
+                for (std::size_t i = 0; i < 5; ++i) {
+                    flock.update();
+                }
+
+                for (std::size_t i = 0; i < 50; ++i) {
+                    const uint64_t before = getAllocationCount();
+                    flock.update();
+                    ASSERT_EQ(getAllocationCount() - before, 0)
+                        << "mode " << mode << ", " << threads << " threads, skin " << skin
+                        << ", step " << i;
+#ifdef BOIDS_STEP_STATS
+                    ASSERT_EQ(flock.getStepStats().allocations, 0);
+#endif
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Test that removing boids, which shrinks the flock, doesn't make the next update allocate.
+ */
+TEST(libboids_flock, update_noAllocationsAfterRemove) {
+#ifndef BOIDS_ALLOCATION_AUDIT
+    GTEST_SKIP() << "Built without BOIDS_ALLOCATION_AUDIT";
+#endif
+    boids::Flock flock(2, 1);
+    flock.setUpdateMode(boids::DOUBLE_BUFFERED);
+    flock.setSceneBounds(boids::Rect(0.0f, 0.0f, 200.0f, 200.0f));
+    flock.spawnUniform(500, boids::Rect(0.0f, 0.0f, 200.0f, 200.0f));
+    for (std::size_t i = 0; i < 3; ++i) {
+        flock.update();
+    }
+
+    const boids::FlockState s = flock.getState();
+    for (std::size_t i = 0; i < 100; ++i) {
+        flock.removeBoid(s.id[i]);
+    }
+    flock.update();
+
+    for (std::size_t i = 0; i < 10; ++i) {
+        const uint64_t before = getAllocationCount();
+        flock.update();
+        ASSERT_EQ(getAllocationCount() - before, 0) << "step " << i;
+    }
+}
+
+/**
+ * @brief Test that a reflecting scene keeps every boid inside it, and that an unbounded scene
+ * lets them leave, in both update modes.
+ */
+TEST(libboids_flock, setBoundaryMode) {
+    const boids::Rect bounds(0.0f, 0.0f, 100.0f, 100.0f);
+    for (const auto mode : {boids::IN_PLACE, boids::DOUBLE_BUFFERED}) {
+        boids::Flock flock(2, 1);
+        ASSERT_EQ(flock.getBoundaryMode(), boids::PERIODIC);
+        flock.setUpdateMode(mode);
+        flock.setSceneBounds(bounds);
+        flock.setBoundaryMode(boids::REFLECTING);
+        ASSERT_EQ(flock.getBoundaryMode(), boids::REFLECTING);
+        flock.spawnUniform(200, bounds);
+        flock.spawnUniform(5, bounds, boids::PREDATOR);
+
+        for (std::size_t i = 0; i < 200; ++i) {
+            flock.update();
+        }
+        const boids::FlockState& s = flock.getState();
+        for (std::size_t i = 0; i < s.size(); ++i) {
+            ASSERT_GE(s.x[i], bounds.left());
+            ASSERT_LE(s.x[i], bounds.right());
+            ASSERT_GE(s.y[i], bounds.top());
+            ASSERT_LE(s.y[i], bounds.bottom());
+        }
+
+        flock.setBoundaryMode(boids::UNBOUNDED);
+        for (std::size_t i = 0; i < 200; ++i) {
+            flock.update();
+        }
+        const auto outside = [&bounds](const float& x, const float& y) {
+            return x < bounds.left() || x > bounds.right() || y < bounds.top() ||
+                   y > bounds.bottom();
+        };
+        std::size_t numOutside = 0;
+        for (std::size_t i = 0; i < s.size(); ++i) {
+            numOutside += outside(s.x[i], s.y[i]) ? 1 : 0;
+        }
+        ASSERT_GT(numOutside, 0);
+    }
+}
+
+/**
+ * @brief Test that searching the neighbourhoods through the cached neighbour lists gives the same
+ * flock as searching the grid, in every boundary mode, and that the lists are only rebuilt once
+ * the boids have moved far enough or the flock has changed.
+ */
+TEST(libboids_flock, setNeighbourSkin) {
+    const boids::Rect bounds(0.0f, 0.0f, 400.0f, 400.0f);
+    for (const auto boundaryMode : {boids::PERIODIC, boids::REFLECTING, boids::UNBOUNDED}) {
+        boids::Flock grid(2, 1);
+        boids::Flock lists(2, 1);
+        ASSERT_EQ(lists.getNeighbourSkin(), 0.0f);
+        lists.setNeighbourSkin(-1.0f);
+        ASSERT_EQ(lists.getNeighbourSkin(), 0.0f);
+        lists.setNeighbourSkin(10.0f);
+        ASSERT_EQ(lists.getNeighbourSkin(), 10.0f);
+
+        for (boids::Flock* flock : {&grid, &lists}) {
+            flock->setUpdateMode(boids::DOUBLE_BUFFERED);
+            flock->setSceneBounds(bounds);
+            flock->setBoundaryMode(boundaryMode);
+            flock->setClusterInterval(5);
+            flock->spawnUniform(500, bounds);
+            flock->spawnUniform(5, bounds, boids::PREDATOR);
+            flock->spawnUniform(5, bounds, boids::OBSTACLE);
+        }
+
+        [[maybe_unused]] uint64_t listBuilds = 0;
+        for (std::size_t i = 0; i < 20; ++i) {
+            grid.update();
+            lists.update();
+#ifdef BOIDS_STEP_STATS
+            listBuilds += lists.getStepStats().listBuilds;
+            ASSERT_EQ(grid.getStepStats().listBuilds, 0);
+#endif
+        }
+#ifdef BOIDS_STEP_STATS
+        // Each boid moves by at most 2 per step, so a skin of 10 lasts for at least 3 steps.
+        ASSERT_GT(listBuilds, 0);
+        ASSERT_LE(listBuilds, 7);
+#endif
+
+        const boids::FlockState& a = grid.getState();
+        const boids::FlockState& b = lists.getState();
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            ASSERT_NEAR(a.x[i], b.x[i], 1e-2f) << "mode " << boundaryMode << ", boid " << i;
+            ASSERT_NEAR(a.y[i], b.y[i], 1e-2f) << "mode " << boundaryMode << ", boid " << i;
+        }
+        ASSERT_EQ(grid.getClusters().clusters.size(), lists.getClusters().clusters.size());
+
+        // Removing a boid changes the slots, so the lists have to be rebuilt.
+        lists.removeBoid(b.id[0]);
+        lists.update();
+#ifdef BOIDS_STEP_STATS
+        ASSERT_EQ(lists.getStepStats().listBuilds, 1);
+#endif
+    }
+}
+
+/**
+ * @brief Test that an update with neighbour lists, which is split between the threads by slot
+ * rather than by index, gives exactly the same flock on four threads as on one.
+ */
+TEST(libboids_flock, setNeighbourSkin_threadCountIndependent) {
+    const boids::Rect bounds(0.0f, 0.0f, 800.0f, 800.0f);
+    boids::Flock      serial(1, 1);
+    boids::Flock      parallel(4, 1);
+    for (boids::Flock* flock : {&serial, &parallel}) {
+        flock->setUpdateMode(boids::DOUBLE_BUFFERED);
+        flock->setNeighbourSkin(10.0f);
+        flock->setSceneBounds(bounds);
+        flock->spawnUniform(4000, bounds);
+        flock->spawnUniform(20, bounds, boids::PREDATOR);
+        flock->spawnUniform(20, bounds, boids::OBSTACLE);
+        for (std::size_t i = 0; i < 10; ++i) {
+            flock->update();
+        }
+    }
+
+    const boids::FlockState& a = serial.getState();
+    const boids::FlockState& b = parallel.getState();
+    ASSERT_EQ(a.id, b.id);
+    ASSERT_EQ(a.x, b.x);
+    ASSERT_EQ(a.y, b.y);
+    ASSERT_EQ(a.vx, b.vx);
+    ASSERT_EQ(a.vy, b.vy);
+    ASSERT_EQ(a.hue, b.hue);
+}
@@ -0,0 +1,144 @@
+#include <flock_clusters.h>
+#include <gtest/gtest.h>
+#include <thread_pool.h>
+#include <utils.h>
+
+/**
+ * @brief Find the clusters of a flock state on one thread.
+ * @param state Flock state.
+ * @param radius Neighbourhood radius.
+ * @param bounds Scene bounds.
+ * @param boundaryMode Boundary of the scene.
+ * @return Clusters.
+ */
+boids::FlockClusters findClusters(const boids::FlockState& state, const float radius,
+                                  const boids::Rect& bounds,
+                                  const boids::BoundaryMode& boundaryMode = boids::PERIODIC) {
+    boids::SpatialGrid grid;
+    grid.rebuild(state.x, state.y, radius, bounds);
+    boids::kernel::PackedNeighbours packed;
+    packed.pack(state, grid);
+
+    boids::ClusterFinder finder;
+    boids::FlockClusters clusters;
+    finder.reset(state.size());
+    finder.link(packed, grid, radius, bounds, 0, state.size(), boundaryMode);
+    finder.collect(state, packed, bounds, 7, clusters, boundaryMode);
+    return clusters;
+}
+
+/**
+ * @brief Test that united sets share the root with the smallest slot, whatever order they were
+ * joined in.
+ */
+TEST(libboids_flock_clusters, unite) {
+    boids::ClusterFinder finder;
+    finder.reset(6);
+    finder.unite(3, 5);
+    finder.unite(4, 5);
+    finder.unite(1, 4);
+    ASSERT_EQ(finder.find(5), 1);
+    ASSERT_EQ(finder.find(3), 1);
+    ASSERT_EQ(finder.find(4), 1);
+    ASSERT_EQ(finder.find(0), 0);
+    ASSERT_EQ(finder.find(2), 2);
+}
+
+/**
+ * @brief Test that chains of neighbours form clusters, which are not bridged by obstacles, and
+ * that a cluster straddling the edge of the scene has its centroid wrapped into the scene.
+ */
+TEST(libboids_flock_clusters, collect) {
+    const boids::Rect bounds(0.0f, 0.0f, 100.0f, 100.0f);
+    boids::FlockState state;
+    state.push(boids::Boid(0, 10.0f, 10.0f, 1.0f, 0.0f, boids::BOID));
+    state.push(boids::Boid(1, 50.0f, 50.0f, 0.0f, 1.0f, boids::BOID));
+    state.push(boids::Boid(2, 18.0f, 10.0f, 1.0f, 2.0f, boids::BOID));
+    state.push(boids::Boid(3, 26.0f, 10.0f, 1.0f, 0.0f, boids::BOID));
+    state.push(boids::Boid(4, 34.0f, 10.0f, 0.0f, 0.0f, boids::OBSTACLE));
+    state.push(boids::Boid(5, 42.0f, 10.0f, 0.0f, 0.0f, boids::BOID));
+    state.push(boids::Boid(6, 96.0f, 80.0f, 2.0f, 0.0f, boids::BOID));
+    state.push(boids::Boid(7, 2.0f, 80.0f, 2.0f, 0.0f, boids::BOID));
+
+    const boids::FlockClusters clusters = findClusters(state, 10.0f, bounds);
+    ASSERT_EQ(clusters.step, 7);
+    ASSERT_EQ(clusters.clusters.size(), 4);
+
+    const boids::Cluster& a = clusters.clusters[0];
+    ASSERT_EQ(a.size, 3);
+    ASSERT_EQ(a.root, 0);
+    ASSERT_FLOAT_EQ(a.x, 18.0f);
+    ASSERT_FLOAT_EQ(a.y, 10.0f);
+    ASSERT_FLOAT_EQ(a.vx, 1.0f);
+    ASSERT_FLOAT_EQ(a.vy, 2.0f / 3.0f);
+
+    const boids::Cluster& b = clusters.clusters[1];
+    ASSERT_EQ(b.size, 2);
+    ASSERT_EQ(b.root, 7);
+    ASSERT_FLOAT_EQ(b.x, 99.0f);
+    ASSERT_FLOAT_EQ(b.y, 80.0f);
+    ASSERT_FLOAT_EQ(b.vx, 2.0f);
+
+    ASSERT_EQ(clusters.clusters[2].size, 1);
+    ASSERT_EQ(clusters.clusters[2].root, 1);
+    ASSERT_EQ(clusters.clusters[3].size, 1);
+    ASSERT_EQ(clusters.clusters[3].root, 5);
+}
+
+/**
+ * @brief Test that BOIDs on opposite edges of the scene are only joined when the scene is
+ * periodic.
+ */
+TEST(libboids_flock_clusters, collect_boundaryMode) {
+    const boids::Rect bounds(0.0f, 0.0f, 100.0f, 100.0f);
+    boids::FlockState state;
+    state.push(boids::Boid(0, 2.0f, 50.0f, 1.0f, 0.0f, boids::BOID));
+    state.push(boids::Boid(1, 97.0f, 50.0f, 1.0f, 0.0f, boids::BOID));
+
+    const boids::FlockClusters periodic = findClusters(state, 10.0f, bounds, boids::PERIODIC);
+    ASSERT_EQ(periodic.clusters.size(), 1);
+    ASSERT_NEAR(periodic.clusters[0].x, 99.5f, 1e-4f);
+
+    for (const auto mode : {boids::REFLECTING, boids::UNBOUNDED}) {
+        const boids::FlockClusters walled = findClusters(state, 10.0f, bounds, mode);
+        ASSERT_EQ(walled.clusters.size(), 2);
+        ASSERT_EQ(walled.clusters[0].size, 1);
+    }
+}
+
+/**
+ * @brief Test that linking the pairs from several threads at once gives the same clusters as
+ * linking them on one thread.
+ */
+TEST(libboids_flock_clusters, link_multithreaded) {
+    const boids::Rect bounds(0.0f, 0.0f, 1000.0f, 1000.0f);
+    boids::FlockState state;
+    for (std::size_t i = 0; i < 5000; ++i) {
+        const float x = boids::utils::generateRandomValue<float>(0.0f, 1000.0f);
+        const float y = boids::utils::generateRandomValue<float>(0.0f, 1000.0f);
+        state.push(boids::Boid(i, x, y, 1.0f, 0.0f, boids::BOID));
+    }
+    const boids::FlockClusters serial = findClusters(state, 12.0f, bounds);
+
+    boids::SpatialGrid grid;
+    grid.rebuild(state.x, state.y, 12.0f, bounds);
+    boids::kernel::PackedNeighbours packed;
+    packed.pack(state, grid);
+
+    boids::ThreadPool    pool(4);
+    boids::ClusterFinder finder;
+    boids::FlockClusters parallel;
+    finder.reset(state.size());
+    pool.parallelFor(state.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+        finder.link(packed, grid, 12.0f, bounds, begin, end);
+    });
+    finder.collect(state, packed, bounds, 7, parallel);
+
+    ASSERT_GT(serial.clusters.size(), 1);
+    ASSERT_LT(serial.clusters.size(), state.size());
+    ASSERT_EQ(parallel.clusters.size(), serial.clusters.size());
+    for (std::size_t c = 0; c < serial.clusters.size(); ++c) {
+        ASSERT_EQ(parallel.clusters[c].root, serial.clusters[c].root);
+        ASSERT_EQ(parallel.clusters[c].size, serial.clusters[c].size);
+    }
+}
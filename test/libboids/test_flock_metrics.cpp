@@ -0,0 +1,69 @@
+#include <cmath>
+#include <flock_metrics.h>
+#include <gtest/gtest.h>
+#include <limits>
+#include <numbers>
+#include <vector>
+
+/**
+ * @brief Test that reducing no boids gives zero metrics rather than dividing by zero.
+ */
+TEST(libboids_flock_metrics, reduce_empty) {
+    const std::vector<boids::MetricSums> sums(2);
+    const boids::FlockMetrics            m = boids::reduceMetrics(sums, 3, 100.0, 10.0);
+    ASSERT_EQ(m.step, 3);
+    ASSERT_EQ(m.numBoids, 0);
+    ASSERT_EQ(m.polarisation, 0.0);
+    ASSERT_EQ(m.angularMomentum, 0.0);
+    ASSERT_EQ(m.density, 0.0);
+}
+
+/**
+ * @brief Test that boids heading the same way are fully polarised, whatever their speeds, and that
+ * boids heading opposite ways cancel out.
+ */
+TEST(libboids_flock_metrics, polarisation) {
+    std::vector<boids::MetricSums> sums(1);
+    sums[0].add(0.0f, 0.0f, 1.0f, 1.0f, 0, 0.0f);
+    sums[0].add(5.0f, 0.0f, 2.0f, 2.0f, 0, 0.0f);
+    ASSERT_NEAR(boids::reduceMetrics(sums, 0, 0.0, 0.0).polarisation, 1.0, 1e-9);
+
+    sums[0].add(0.0f, 5.0f, -1.0f, -1.0f, 0, 0.0f);
+    sums[0].add(5.0f, 5.0f, -3.0f, -3.0f, 0, 0.0f);
+    ASSERT_NEAR(boids::reduceMetrics(sums, 0, 0.0, 0.0).polarisation, 0.0, 1e-9);
+}
+
+/**
+ * @brief Test that boids milling around a point away from the origin, split over two threads, give
+ * the angular momentum about their centroid.
+ */
+TEST(libboids_flock_metrics, angularMomentum) {
+    std::vector<boids::MetricSums> sums(2);
+    sums[0].add(11.0f, 10.0f, 0.0f, 1.0f, 0, 0.0f);
+    sums[0].add(10.0f, 11.0f, -1.0f, 0.0f, 0, 0.0f);
+    sums[1].add(9.0f, 10.0f, 0.0f, -1.0f, 0, 0.0f);
+    sums[1].add(10.0f, 9.0f, 1.0f, 0.0f, 0, 0.0f);
+
+    const boids::FlockMetrics m = boids::reduceMetrics(sums, 0, 0.0, 0.0);
+    ASSERT_EQ(m.numBoids, 4);
+    ASSERT_NEAR(m.angularMomentum, 1.0, 1e-9);
+    ASSERT_NEAR(m.polarisation, 0.0, 1e-9);
+}
+
+/**
+ * @brief Test that the mean nearest distance only counts the boids with a neighbour, and that the
+ * densities are taken per unit area.
+ */
+TEST(libboids_flock_metrics, nearestAndDensity) {
+    const float                    inf = std::numeric_limits<float>::infinity();
+    std::vector<boids::MetricSums> sums(1);
+    sums[0].add(0.0f, 0.0f, 1.0f, 0.0f, 2, 4.0f);
+    sums[0].add(1.0f, 0.0f, 1.0f, 0.0f, 4, 16.0f);
+    sums[0].add(9.0f, 0.0f, 1.0f, 0.0f, 0, inf);
+    sums[0].add(9.0f, 9.0f, 1.0f, 0.0f, 0, inf);
+
+    const boids::FlockMetrics m = boids::reduceMetrics(sums, 0, 200.0, 2.0);
+    ASSERT_NEAR(m.meanNearestDistance, 3.0, 1e-9);
+    ASSERT_NEAR(m.density, 4.0 / 200.0, 1e-12);
+    ASSERT_NEAR(m.localDensity, 1.5 / (std::numbers::pi * 4.0), 1e-12);
+}
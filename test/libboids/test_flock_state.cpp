@@ -0,0 +1,101 @@
+#include <flock_state.h>
+#include <gtest/gtest.h>
+#include <utility>
+
+/**
+ * @brief Check whether a view can move its boid.
+ */
+template <typename View>
+concept CanSetPosition = requires(View view) { view.setPosition(boids::Vec2()); };
+
+/**
+ * @brief Test FlockState containing a mix of boid types.
+ */
+class MixedFlockStateTest : public testing::Test {
+
+  protected:
+    boids::FlockState m_state;
+
+    void SetUp() {
+        m_state.push(boids::Boid(0, 1.0f, 2.0f, 3.0f, 4.0f, boids::BOID));
+        m_state.push(boids::Boid(1, 5.0f, 6.0f, 7.0f, 8.0f, boids::PREDATOR));
+        m_state.push(boids::Boid(2, 9.0f, 10.0f, 11.0f, 12.0f, boids::BOID));
+        m_state.push(boids::Boid(3, 13.0f, 14.0f, 15.0f, 16.0f, boids::OBSTACLE));
+    }
+};
+
+/**
+ * @brief Test that pushing a Boid stores it in every array.
+ */
+TEST_F(MixedFlockStateTest, push) {
+    ASSERT_EQ(m_state.size(), 4);
+    ASSERT_EQ(m_state.x.size(), 4);
+    ASSERT_EQ(m_state.hue.size(), 4);
+    ASSERT_EQ(m_state.type.size(), 4);
+    ASSERT_FLOAT_EQ(m_state.x[1], 5.0f);
+    ASSERT_FLOAT_EQ(m_state.vy[2], 12.0f);
+    ASSERT_EQ(m_state.type[3], boids::OBSTACLE);
+}
+
+/**
+ * @brief Test that clearing a single type keeps the other boids in their original order.
+ */
+TEST_F(MixedFlockStateTest, clearType) {
+    m_state.clear(boids::PREDATOR);
+    ASSERT_EQ(m_state.size(), 3);
+    ASSERT_EQ(m_state.id[0], 0);
+    ASSERT_EQ(m_state.id[1], 2);
+    ASSERT_EQ(m_state.id[2], 3);
+    ASSERT_FLOAT_EQ(m_state.x[1], 9.0f);
+}
+
+/**
+ * @brief Test that clearing the state removes all the boids.
+ */
+TEST_F(MixedFlockStateTest, clear) {
+    m_state.clear();
+    ASSERT_EQ(m_state.size(), 0);
+}
+
+/**
+ * @brief Test that a BoidView reads and writes through to the underlying arrays.
+ */
+TEST_F(MixedFlockStateTest, view) {
+    boids::BoidView view = m_state.view(1);
+    ASSERT_EQ(view.getId(), 1);
+    ASSERT_EQ(view.getType(), boids::PREDATOR);
+    ASSERT_EQ(view.getPosition(), boids::Vec2(5.0f, 6.0f));
+
+    view.setPosition(boids::Vec2(20.0f, 30.0f));
+    view.setVelocity(boids::Vec2(-1.0f, -2.0f));
+    ASSERT_FLOAT_EQ(m_state.x[1], 20.0f);
+    ASSERT_FLOAT_EQ(m_state.y[1], 30.0f);
+    ASSERT_FLOAT_EQ(m_state.vx[1], -1.0f);
+    ASSERT_FLOAT_EQ(m_state.vy[1], -2.0f);
+}
+
+/**
+ * @brief Test that a const state only hands out read-only views, even once they are copied.
+ */
+TEST_F(MixedFlockStateTest, constView) {
+    static_assert(CanSetPosition<boids::BoidView>);
+    static_assert(!CanSetPosition<boids::ConstBoidView>);
+    static_assert(std::is_same_v<decltype(std::as_const(m_state).view(1)), boids::ConstBoidView>);
+
+    boids::ConstBoidView view = std::as_const(m_state).view(1);
+    ASSERT_EQ(view.getId(), 1);
+    ASSERT_EQ(view.getType(), boids::PREDATOR);
+    ASSERT_EQ(view.getPosition(), boids::Vec2(5.0f, 6.0f));
+    ASSERT_EQ(view.getVelocity(), boids::Vec2(7.0f, 8.0f));
+}
+
+/**
+ * @brief Test that a boid copied out of the state through a view matches the one that was pushed.
+ */
+TEST_F(MixedFlockStateTest, toBoid) {
+    const boids::Boid b = m_state.view(2).toBoid();
+    ASSERT_EQ(b.getId(), 2);
+    ASSERT_EQ(b.getType(), boids::BOID);
+    ASSERT_EQ(b.getPosition(), boids::Vec2(9.0f, 10.0f));
+    ASSERT_EQ(b.getVelocity(), boids::Vec2(11.0f, 12.0f));
+}
@@ -0,0 +1,377 @@
+#include <cmath>
+#include <gtest/gtest.h>
+#include <kernel.h>
+#include <utils.h>
+
+/**
+ * @brief Test fixture with a boid surrounded by a few neighbours of each type, none of which are
+ * close to the edges of the scene.
+ */
+class KernelTest : public testing::Test {
+
+  protected:
+    boids::Rect              m_bounds;
+    boids::Config            m_cfg;
+    boids::FlockState        m_state;
+    boids::SpatialGrid       m_grid;
+    std::vector<boids::Boid> m_flock;
+    std::vector<boids::Boid> m_obstacles;
+    std::vector<boids::Boid> m_predators;
+
+    void SetUp() {
+        m_bounds                  = boids::Rect(0.0f, 0.0f, 400.0f, 400.0f);
+        m_cfg.neighbourhoodRadius = 80.0f;
+        m_cfg.repelMinDist        = 20.0f;
+
+        m_flock.push_back(boids::Boid(0, 200.0f, 200.0f, 1.0f, 0.0f, boids::BOID));
+        m_flock.push_back(boids::Boid(1, 210.0f, 200.0f, 0.0f, 1.0f, boids::BOID));
+        m_flock.push_back(boids::Boid(2, 200.0f, 150.0f, -1.0f, 1.0f, boids::BOID));
+        m_flock.push_back(boids::Boid(3, 180.0f, 230.0f, 2.0f, 2.0f, boids::BOID));
+        m_flock.push_back(boids::Boid(4, 350.0f, 350.0f, 1.0f, 1.0f, boids::BOID));
+        m_obstacles.push_back(boids::Boid(5, 195.0f, 195.0f, 0.0f, 0.0f, boids::OBSTACLE));
+        m_predators.push_back(boids::Boid(6, 240.0f, 200.0f, 0.0f, 0.0f, boids::PREDATOR));
+
+        for (const auto& list : {m_flock, m_obstacles, m_predators}) {
+            for (const auto& b : list) {
+                m_state.push(b);
+            }
+        }
+        m_grid.rebuild(m_state.x, m_state.y, m_cfg.neighbourhoodRadius, m_bounds);
+    }
+};
+
+/**
+ * @brief Check that the sums of the packed kernel match those of the reference kernel, up to
+ * floating point rounding.
+ * @param sums Sums of the packed kernel.
+ * @param ref Sums of the reference kernel.
+ */
+static void expectSumsNear(const boids::kernel::NeighbourhoodSums& sums,
+                           const boids::kernel::NeighbourhoodSums& ref) {
+    EXPECT_EQ(sums.count, ref.count);
+    EXPECT_NEAR(sums.alignX, ref.alignX, 1e-3f);
+    EXPECT_NEAR(sums.alignY, ref.alignY, 1e-3f);
+    EXPECT_NEAR(sums.cohesionX, ref.cohesionX, 1e-2f);
+    EXPECT_NEAR(sums.cohesionY, ref.cohesionY, 1e-2f);
+    EXPECT_NEAR(sums.repelX, ref.repelX, 1e-3f);
+    EXPECT_NEAR(sums.repelY, ref.repelY, 1e-3f);
+    EXPECT_NEAR(sums.obstacleX, ref.obstacleX, 1e-3f);
+    EXPECT_NEAR(sums.obstacleY, ref.obstacleY, 1e-3f);
+    EXPECT_NEAR(sums.predatorX, ref.predatorX, 1e-3f);
+    EXPECT_NEAR(sums.predatorY, ref.predatorY, 1e-3f);
+    EXPECT_NEAR(sums.hue, ref.hue, 1e-2f);
+    if (std::isinf(ref.nearestSq))
+        EXPECT_TRUE(std::isinf(sums.nearestSq));
+    else
+        EXPECT_NEAR(sums.nearestSq, ref.nearestSq, 1e-2f);
+}
+
+/**
+ * @brief Test that only the boids within the radius are counted as neighbours.
+ */
+TEST_F(KernelTest, count) {
+    const auto sums = boids::kernel::accumulateNeighbourhood(m_state, 0, m_grid, m_cfg, m_bounds);
+    ASSERT_EQ(sums.count, 3);
+}
+
+/**
+ * @brief Test that the fused alignment, cohesion and separation sums match the separate utils
+ * functions.
+ */
+TEST_F(KernelTest, matchesUtils) {
+    const boids::Boid& boid = m_flock[0];
+    const float        r    = m_cfg.neighbourhoodRadius;
+
+    const auto neighbours = boids::utils::getBoidNeighbourhood(boid, m_flock, r, m_bounds);
+    const auto obstacles  = boids::utils::getBoidNeighbourhood(boid, m_obstacles, r, m_bounds);
+    const auto predators  = boids::utils::getBoidNeighbourhood(boid, m_predators, r, m_bounds);
+
+    const auto sums = boids::kernel::accumulateNeighbourhood(m_state, 0, m_grid, m_cfg, m_bounds);
+
+    const boids::Vec2 align = boids::utils::calculateAlignmentVector(boid, neighbours);
+    ASSERT_NEAR(sums.alignX, align.x(), 1e-5f);
+    ASSERT_NEAR(sums.alignY, align.y(), 1e-5f);
+
+    const boids::Vec2 cohesion = boids::utils::calculateCohesionVector(boid, neighbours, m_bounds);
+    const boids::Vec2 sumsCohesion =
+        boids::Vec2(sums.cohesionX, sums.cohesionY).normalized() * 0.25f;
+    ASSERT_NEAR(sumsCohesion.x(), cohesion.x(), 1e-5f);
+    ASSERT_NEAR(sumsCohesion.y(), cohesion.y(), 1e-5f);
+
+    const boids::Vec2 repel =
+        boids::utils::calculateSeparationVector(boid, neighbours, m_cfg.repelMinDist, m_bounds);
+    ASSERT_NEAR(sums.repelX, repel.x(), 1e-5f);
+    ASSERT_NEAR(sums.repelY, repel.y(), 1e-5f);
+
+    const boids::Vec2 obstacle =
+        boids::utils::calculateSeparationVector(boid, obstacles, m_cfg.repelMinDist, m_bounds);
+    ASSERT_NEAR(sums.obstacleX, obstacle.x(), 1e-5f);
+    ASSERT_NEAR(sums.obstacleY, obstacle.y(), 1e-5f);
+
+    const boids::Vec2 predator = boids::utils::calculateSeparationVector(
+        boid, predators, m_cfg.repelMinDist * 5.0f, m_bounds);
+    ASSERT_NEAR(sums.predatorX, predator.x(), 1e-5f);
+    ASSERT_NEAR(sums.predatorY, predator.y(), 1e-5f);
+}
+
+/**
+ * @brief Test that the nearest neighbour is the nearest BOID, ignoring the closer obstacle, and
+ * that a boid with no neighbours has none.
+ */
+TEST_F(KernelTest, nearestSq) {
+    const auto sums = boids::kernel::accumulateNeighbourhood(m_state, 0, m_grid, m_cfg, m_bounds);
+    ASSERT_FLOAT_EQ(sums.nearestSq, 100.0f);
+
+    const auto isolated =
+        boids::kernel::accumulateNeighbourhood(m_state, 4, m_grid, m_cfg, m_bounds);
+    ASSERT_TRUE(std::isinf(isolated.nearestSq));
+}
+
+/**
+ * @brief Test that a neighbour at exactly the same position repels along the X axis, without
+ * producing a NaN alignment.
+ */
+TEST_F(KernelTest, coLocatedNeighbour) {
+    m_state.push(boids::Boid(7, 200.0f, 200.0f, 1.0f, 0.0f, boids::BOID));
+    m_grid.rebuild(m_state.x, m_state.y, m_cfg.neighbourhoodRadius, m_bounds);
+
+    const auto sums = boids::kernel::accumulateNeighbourhood(m_state, 0, m_grid, m_cfg, m_bounds);
+    ASSERT_EQ(sums.count, 4);
+    ASSERT_FALSE(std::isnan(sums.alignX));
+    ASSERT_FALSE(std::isnan(sums.hue));
+}
+
+/**
+ * @brief Test that a neighbour across the edge of the scene is only seen when the scene is
+ * periodic, by both kernels.
+ */
+TEST_F(KernelTest, boundaryMode) {
+    m_state.push(boids::Boid(7, 395.0f, 350.0f, 1.0f, 0.0f, boids::BOID));
+    m_state.push(boids::Boid(8, 5.0f, 350.0f, 1.0f, 0.0f, boids::BOID));
+    m_grid.rebuild(m_state.x, m_state.y, m_cfg.neighbourhoodRadius, m_bounds);
+    boids::kernel::PackedNeighbours packed;
+    packed.pack(m_state, m_grid);
+
+    using boids::kernel::accumulateNeighbourhood;
+    const auto periodic = accumulateNeighbourhood<boids::boundary::Periodic>(m_state, 7, m_grid,
+                                                                             m_cfg, m_bounds);
+    ASSERT_EQ(periodic.count, 2);
+    ASSERT_FLOAT_EQ(periodic.nearestSq, 100.0f);
+    ASSERT_FLOAT_EQ(periodic.cohesionX, 10.0f - 45.0f);
+
+    const auto reflecting = accumulateNeighbourhood<boids::boundary::Reflecting>(
+        m_state, 7, m_grid, packed, m_cfg, m_bounds);
+    ASSERT_EQ(reflecting.count, 1);
+    ASSERT_FLOAT_EQ(reflecting.cohesionX, -45.0f);
+
+    const auto unbounded = accumulateNeighbourhood<boids::boundary::Unbounded>(m_state, 7, m_grid,
+                                                                               m_cfg, m_bounds);
+    ASSERT_EQ(unbounded.count, 1);
+}
+
+/**
+ * @brief Test that the packed kernel matches the reference kernel for every instruction set
+ * supported by the host and every boundary mode, including for boids whose neighbourhood wraps
+ * around the scene.
+ */
+TEST_F(KernelTest, packedMatchesReference) {
+    for (std::size_t i = 0; i < 200; ++i) {
+        const float x = boids::utils::generateRandomValue<float>(0.0f, 400.0f);
+        const float y = boids::utils::generateRandomValue<float>(0.0f, 400.0f);
+        m_state.push(boids::Boid(7 + i, x, y, boids::BoidType(i % 3)));
+    }
+    m_grid.rebuild(m_state.x, m_state.y, m_cfg.neighbourhoodRadius, m_bounds);
+
+    boids::kernel::PackedNeighbours packed;
+    packed.pack(m_state, m_grid);
+
+    const boids::kernel::InstructionSet original = boids::kernel::getInstructionSet();
+    for (const auto isa : {boids::kernel::SCALAR, boids::kernel::SSE, boids::kernel::AVX2,
+                           boids::kernel::AVX512}) {
+        if (!boids::kernel::isSupported(isa))
+            continue;
+        boids::kernel::setInstructionSet(isa);
+
+        for (std::size_t n = 0; n < 3 * m_state.size(); ++n) {
+            const std::size_t         i    = n % m_state.size();
+            const boids::BoundaryMode mode = boids::BoundaryMode(n / m_state.size());
+
+            boids::kernel::NeighbourhoodSums ref, sums;
+            boids::boundary::visit(mode, [&](auto policy) {
+                using Policy = decltype(policy);
+                ref  = boids::kernel::accumulateNeighbourhood<Policy>(m_state, i, m_grid, m_cfg,
+                                                                      m_bounds);
+                sums = boids::kernel::accumulateNeighbourhood<Policy>(m_state, i, m_grid, packed,
+                                                                      m_cfg, m_bounds);
+            });
+            expectSumsNear(sums, ref);
+        }
+    }
+    boids::kernel::setInstructionSet(original);
+}
+
+/**
+ * @brief Test that reading the neighbourhood of a periodic scene from the halo gives the same
+ * result as wrapping the displacements, including for boids on the edges of the scene.
+ */
+TEST_F(KernelTest, packedHaloMatchesReference) {
+    for (std::size_t i = 0; i < 300; ++i) {
+        float x = boids::utils::generateRandomValue<float>(0.0f, 400.0f);
+        float y = boids::utils::generateRandomValue<float>(0.0f, 400.0f);
+
+        // Put some of the boids right on the edges of the scene.
+        if (i % 10 == 0)
+            x = 400.0f;
+        if (i % 10 == 1)
+            y = 0.0f;
+        m_state.push(boids::Boid(7 + i, x, y, boids::BoidType(i % 3)));
+    }
+    m_grid.rebuild(m_state.x, m_state.y, m_cfg.neighbourhoodRadius, m_bounds);
+    m_grid.buildHalo();
+    ASSERT_TRUE(m_grid.hasHalo());
+    ASSERT_GT(m_grid.getNumGhosts(), 0);
+
+    boids::kernel::PackedNeighbours packed;
+    packed.pack(m_state, m_grid);
+    ASSERT_TRUE(packed.halo);
+
+    const boids::kernel::InstructionSet original = boids::kernel::getInstructionSet();
+    for (const auto isa : {boids::kernel::SCALAR, boids::kernel::SSE, boids::kernel::AVX2,
+                           boids::kernel::AVX512}) {
+        if (!boids::kernel::isSupported(isa))
+            continue;
+        boids::kernel::setInstructionSet(isa);
+
+        for (std::size_t i = 0; i < m_state.size(); ++i) {
+            const boids::kernel::NeighbourhoodSums ref =
+                boids::kernel::accumulateNeighbourhood(m_state, i, m_grid, m_cfg, m_bounds);
+            const boids::kernel::NeighbourhoodSums sums =
+                boids::kernel::accumulateNeighbourhood(m_state, i, m_grid, packed, m_cfg, m_bounds);
+            expectSumsNear(sums, ref);
+        }
+    }
+    boids::kernel::setInstructionSet(original);
+}
+
+/**
+ * @brief Test that filtering a list of candidates, which holds most of the other boids in grid
+ * order, matches the reference kernel for every instruction set and boundary mode. The lists have
+ * every length modulo the vector widths, so the masked tails of the gathers are covered.
+ */
+TEST_F(KernelTest, listMatchesReference) {
+    for (std::size_t i = 0; i < 60; ++i) {
+        const float x = boids::utils::generateRandomValue<float>(0.0f, 400.0f);
+        const float y = boids::utils::generateRandomValue<float>(0.0f, 400.0f);
+        m_state.push(boids::Boid(7 + i, x, y, boids::BoidType(i % 3)));
+    }
+    m_grid.rebuild(m_state.x, m_state.y, m_cfg.neighbourhoodRadius, m_bounds);
+
+    boids::kernel::PackedNeighbours packed;
+    packed.pack(m_state, m_grid);
+
+    const boids::kernel::InstructionSet original = boids::kernel::getInstructionSet();
+    for (const auto isa : {boids::kernel::SCALAR, boids::kernel::SSE, boids::kernel::AVX2,
+                           boids::kernel::AVX512}) {
+        if (!boids::kernel::isSupported(isa))
+            continue;
+        boids::kernel::setInstructionSet(isa);
+
+        for (std::size_t n = 0; n < 3 * m_state.size(); ++n) {
+            const std::size_t         i    = n % m_state.size();
+            const boids::BoundaryMode mode = boids::BoundaryMode(n / m_state.size());
+
+            // Each boid leaves a different number of the boids that are out of its range, with or
+            // without wrapping, off its list.
+            std::vector<int32_t> candidates;
+            std::size_t          skip = i % 17;
+            for (std::size_t k = 0; k < m_state.size(); ++k) {
+                const std::size_t j = std::size_t(packed.index[k]);
+                if (j == i)
+                    continue;
+
+                const float dx = m_state.x[j] - m_state.x[i];
+                const float dy = m_state.y[j] - m_state.y[i];
+                const float wx = boids::boundary::wrapDisplacement(dx, m_bounds.width());
+                const float wy = boids::boundary::wrapDisplacement(dy, m_bounds.height());
+                const float r  = m_cfg.neighbourhoodRadius;
+                if (skip > 0 && std::min(dx * dx + dy * dy, wx * wx + wy * wy) > r * r)
+                    --skip;
+                else
+                    candidates.push_back(int32_t(k));
+            }
+
+            boids::kernel::NeighbourhoodSums ref, sums;
+            boids::boundary::visit(mode, [&](auto policy) {
+                using Policy = decltype(policy);
+                ref  = boids::kernel::accumulateNeighbourhood<Policy>(m_state, i, m_grid, m_cfg,
+                                                                      m_bounds);
+                sums = boids::kernel::accumulateNeighbourhood<Policy>(m_state, i, packed,
+                                                                      candidates, m_cfg, m_bounds);
+            });
+            expectSumsNear(sums, ref);
+        }
+    }
+    boids::kernel::setInstructionSet(original);
+}
+
+/**
+ * @brief Test that every instruction set finds exactly the slots within the radius of each slot,
+ * for every boundary mode.
+ */
+TEST_F(KernelTest, findSlotsWithin) {
+    for (std::size_t i = 0; i < 60; ++i) {
+        const float x = boids::utils::generateRandomValue<float>(0.0f, 400.0f);
+        const float y = boids::utils::generateRandomValue<float>(0.0f, 400.0f);
+        m_state.push(boids::Boid(7 + i, x, y, boids::BoidType(i % 3)));
+    }
+    m_grid.rebuild(m_state.x, m_state.y, m_cfg.neighbourhoodRadius, m_bounds);
+
+    boids::kernel::PackedNeighbours packed;
+    packed.pack(m_state, m_grid);
+
+    const float                         r        = m_cfg.neighbourhoodRadius;
+    const boids::kernel::InstructionSet original = boids::kernel::getInstructionSet();
+    for (const auto isa : {boids::kernel::SCALAR, boids::kernel::SSE, boids::kernel::AVX2,
+                           boids::kernel::AVX512}) {
+        if (!boids::kernel::isSupported(isa))
+            continue;
+        boids::kernel::setInstructionSet(isa);
+
+        for (const auto mode : {boids::PERIODIC, boids::REFLECTING, boids::UNBOUNDED}) {
+            for (std::size_t k = 0; k < m_state.size(); ++k) {
+                std::vector<int32_t> expected;
+                for (std::size_t j = 0; j < m_state.size(); ++j) {
+                    float dx = packed.x[j] - packed.x[k];
+                    float dy = packed.y[j] - packed.y[k];
+                    if (mode == boids::PERIODIC) {
+                        dx = boids::boundary::wrapDisplacement(dx, m_bounds.width());
+                        dy = boids::boundary::wrapDisplacement(dy, m_bounds.height());
+                    }
+                    if (j != k && dx * dx + dy * dy <= r * r)
+                        expected.push_back(int32_t(j));
+                }
+
+                // A single range over every slot, so that it has a partial vector at its end.
+                const std::size_t    ranges[2] = {0, m_state.size()};
+                std::vector<int32_t> found(m_state.size());
+                boids::boundary::visit(mode, [&](auto policy) {
+                    found.resize(boids::kernel::findSlotsWithin<decltype(policy)>(
+                        packed, k, r, m_bounds, ranges, 1, found.data()));
+                });
+                ASSERT_EQ(found, expected) << "isa " << isa << ", mode " << mode << ", slot " << k;
+            }
+        }
+    }
+    boids::kernel::setInstructionSet(original);
+}
+
+/**
+ * @brief Test that the scalar instruction set can always be selected.
+ */
+TEST(libboids_kernel, setInstructionSet_scalar) {
+    const boids::kernel::InstructionSet original = boids::kernel::getInstructionSet();
+    ASSERT_TRUE(boids::kernel::isSupported(boids::kernel::SCALAR));
+    ASSERT_NO_THROW(boids::kernel::setInstructionSet(boids::kernel::SCALAR));
+    ASSERT_EQ(boids::kernel::getInstructionSet(), boids::kernel::SCALAR);
+    boids::kernel::setInstructionSet(original);
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <mpsc_queue.h>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Test that items pushed from a single thread are popped in order.
+ */
+TEST(libboids_mpsc_queue, fifo) {
+    boids::MpscQueue<int> queue;
+    int                   item = 0;
+    ASSERT_FALSE(queue.tryPop(item));
+
+    for (int i = 0; i < 100; ++i) {
+        queue.push(i);
+    }
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(queue.tryPop(item));
+        ASSERT_EQ(item, i);
+    }
+    ASSERT_FALSE(queue.tryPop(item));
+
+    queue.push(7);
+    ASSERT_TRUE(queue.tryPop(item));
+    ASSERT_EQ(item, 7);
+}
+
+/**
+ * @brief Test that items pushed from several threads at once are all popped exactly once, and
+ * that the items from each thread are popped in the order that thread pushed them.
+ */
+TEST(libboids_mpsc_queue, multipleProducers) {
+    constexpr int                 numProducers = 4;
+    constexpr int                 numItems     = 20000;
+    boids::MpscQueue<int>    queue;
+    std::vector<std::thread> producers;
+
+    for (int p = 0; p < numProducers; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < numItems; ++i) {
+                queue.push(p * numItems + i);
+            }
+        });
+    }
+
+    std::vector<int> last(numProducers, -1);
+    int              count = 0;
+    int              item  = 0;
+    while (count < numProducers * numItems) {
+        if (!queue.tryPop(item))
+            continue;
+        const int p = item / numItems;
+        ASSERT_GT(item % numItems, last[p]);
+        last[p] = item % numItems;
+        ++count;
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    ASSERT_FALSE(queue.tryPop(item));
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <neighbour_lists.h>
+#include <utils.h>
+
+/**
+ * @brief Create a flock state with boids of every type at random positions within the bounds.
+ * @param count Number of boids.
+ * @param bounds Scene bounds.
+ * @return Flock state.
+ */
+static boids::FlockState createRandomState(const std::size_t count, const boids::Rect& bounds) {
+    boids::FlockState state;
+    for (std::size_t i = 0; i < count; ++i) {
+        const float x = boids::utils::generateRandomValue<float>(bounds.left(), bounds.right());
+        const float y = boids::utils::generateRandomValue<float>(bounds.top(), bounds.bottom());
+        state.push(boids::Boid(i, x, y, boids::BoidType(i % 3)));
+    }
+    return state;
+}
+
+/**
+ * @brief Test that the lists hold exactly the slots within the list radius of the type in each
+ * slot, for every boundary mode, and that OBSTACLE slots get empty lists.
+ */
+TEST(libboids_neighbour_lists, matchesBruteForce) {
+    const boids::Rect       bounds(0.0f, 0.0f, 400.0f, 300.0f);
+    const float             boidRadius     = 40.0f;
+    const float             predatorRadius = 55.0f;
+    const boids::FlockState state          = createRandomState(1500, bounds);
+
+    boids::SpatialGrid grid;
+    grid.rebuild(state.x, state.y, predatorRadius, bounds);
+    boids::kernel::PackedNeighbours packed;
+    packed.pack(state, grid);
+
+    for (const auto mode : {boids::PERIODIC, boids::REFLECTING, boids::UNBOUNDED}) {
+        boids::NeighbourLists lists;
+        lists.beginBuild(grid, packed, boidRadius, predatorRadius, bounds, mode);
+        ASSERT_EQ(lists.getNumBlocks(), 2);
+        lists.build(grid, packed, 1, 2);
+        lists.build(grid, packed, 0, 1);
+
+        for (std::size_t k = 0; k < state.size(); ++k) {
+            const float radius = packed.type[k] == boids::BOID ? boidRadius : predatorRadius;
+            std::vector<int32_t> expected;
+            for (std::size_t j = 0; j < state.size() && packed.type[k] != boids::OBSTACLE; ++j) {
+                float dx = packed.x[j] - packed.x[k];
+                float dy = packed.y[j] - packed.y[k];
+                if (mode == boids::PERIODIC) {
+                    dx = boids::boundary::wrapDisplacement(dx, bounds.width());
+                    dy = boids::boundary::wrapDisplacement(dy, bounds.height());
+                }
+                if (j != k && dx * dx + dy * dy <= radius * radius)
+                    expected.push_back(int32_t(j));
+            }
+
+            const std::span<const int32_t> candidates = lists.getCandidates(k);
+            std::vector<int32_t>           found(candidates.begin(), candidates.end());
+            std::sort(found.begin(), found.end());
+            ASSERT_EQ(found, expected) << "mode " << mode << ", slot " << k;
+        }
+    }
+}
+
+/**
+ * @brief Test that the displacement since the build is measured the short way round in a
+ * periodic scene only.
+ */
+TEST(libboids_neighbour_lists, getMaxDisplacement) {
+    const boids::Rect bounds(0.0f, 0.0f, 100.0f, 100.0f);
+    boids::FlockState state;
+    state.push(boids::Boid(0, 99.0f, 50.0f, boids::BOID));
+    state.push(boids::Boid(1, 20.0f, 20.0f, boids::BOID));
+
+    boids::SpatialGrid grid;
+    grid.rebuild(state.x, state.y, 10.0f, bounds);
+    boids::kernel::PackedNeighbours packed;
+    packed.pack(state, grid);
+
+    for (const auto mode : {boids::PERIODIC, boids::REFLECTING}) {
+        boids::NeighbourLists lists;
+        lists.beginBuild(grid, packed, 10.0f, 10.0f, bounds, mode);
+        lists.build(grid, packed, 0, lists.getNumBlocks());
+        ASSERT_FLOAT_EQ(lists.getMaxDisplacement(packed), 0.0f);
+
+        // The first boid crosses the right edge, and the second moves by (3, 4).
+        boids::kernel::PackedNeighbours moved = packed;
+        for (std::size_t k = 0; k < 2; ++k) {
+            moved.x[k] = moved.index[k] == 0 ? 1.0f : 23.0f;
+            moved.y[k] = moved.index[k] == 0 ? 50.0f : 24.0f;
+        }
+        ASSERT_FLOAT_EQ(lists.getMaxDisplacement(moved), mode == boids::PERIODIC ? 5.0f : 98.0f);
+    }
+}
+
+/**
+ * @brief Test that the lists only match the flock and scene they were built for, until they are
+ * invalidated.
+ */
+TEST(libboids_neighbour_lists, matches) {
+    const boids::Rect       bounds(0.0f, 0.0f, 200.0f, 200.0f);
+    const boids::FlockState state = createRandomState(50, bounds);
+
+    boids::SpatialGrid grid;
+    grid.rebuild(state.x, state.y, 30.0f, bounds);
+    boids::kernel::PackedNeighbours packed;
+    packed.pack(state, grid);
+
+    boids::NeighbourLists lists;
+    ASSERT_FALSE(lists.matches(50, 20.0f, 30.0f, bounds, boids::PERIODIC));
+
+    lists.beginBuild(grid, packed, 20.0f, 30.0f, bounds, boids::PERIODIC);
+    lists.build(grid, packed, 0, lists.getNumBlocks());
+    ASSERT_TRUE(lists.matches(50, 20.0f, 30.0f, bounds, boids::PERIODIC));
+    ASSERT_FALSE(lists.matches(49, 20.0f, 30.0f, bounds, boids::PERIODIC));
+    ASSERT_FALSE(lists.matches(50, 21.0f, 30.0f, bounds, boids::PERIODIC));
+    ASSERT_FALSE(lists.matches(50, 20.0f, 31.0f, bounds, boids::PERIODIC));
+    ASSERT_FALSE(lists.matches(50, 20.0f, 30.0f, boids::Rect(0.0f, 0.0f, 200.0f, 100.0f),
+                               boids::PERIODIC));
+    ASSERT_FALSE(lists.matches(50, 20.0f, 30.0f, bounds, boids::REFLECTING));
+
+    lists.invalidate();
+    ASSERT_FALSE(lists.matches(50, 20.0f, 30.0f, bounds, boids::PERIODIC));
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include <random.h>
+
+/**
+ * @brief Test that two generators with the same seed and stream produce the same sequence.
+ */
+TEST(libboids_random, sameSeed) {
+    boids::Random a(42, 7);
+    boids::Random b(42, 7);
+    for (std::size_t i = 0; i < 1000; ++i) {
+        ASSERT_EQ(a.next(), b.next());
+    }
+}
+
+/**
+ * @brief Test that different seeds and different streams produce different sequences.
+ */
+TEST(libboids_random, differentStreams) {
+    boids::Random a(42, 0);
+    boids::Random b(42, 1);
+    boids::Random c(43, 0);
+    std::size_t   sameB = 0;
+    std::size_t   sameC = 0;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        const uint32_t value = a.next();
+        sameB += value == b.next();
+        sameC += value == c.next();
+    }
+    ASSERT_LT(sameB, 5);
+    ASSERT_LT(sameC, 5);
+}
+
+/**
+ * @brief Test that uniform values are within the requested range, and cover it.
+ */
+TEST(libboids_random, uniform) {
+    boids::Random rng(1);
+    float         minValue = 10.0f;
+    float         maxValue = -10.0f;
+    for (std::size_t i = 0; i < 10000; ++i) {
+        const float value = rng.uniform(-3.0f, 3.0f);
+        ASSERT_GE(value, -3.0f);
+        ASSERT_LT(value, 3.0f);
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+    ASSERT_LT(minValue, -2.9f);
+    ASSERT_GT(maxValue, 2.9f);
+}
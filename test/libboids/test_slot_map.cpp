@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <set>
+#include <slot_map.h>
+
+/**
+ * @brief Test that inserted handles are valid and map to their indices, and that erased handles
+ * become stale.
+ */
+TEST(libboids_slot_map, insertErase) {
+    boids::SlotMap      slots;
+    const boids::BoidId a = slots.insert(0);
+    const boids::BoidId b = slots.insert(1);
+    ASSERT_EQ(slots.size(), 2);
+    ASSERT_TRUE(slots.contains(a));
+    ASSERT_EQ(slots.getIndex(a), 0);
+    ASSERT_EQ(slots.getIndex(b), 1);
+
+    slots.erase(a);
+    ASSERT_EQ(slots.size(), 1);
+    ASSERT_FALSE(slots.contains(a));
+    ASSERT_TRUE(slots.contains(b));
+
+    slots.setIndex(b, 0);
+    ASSERT_EQ(slots.getIndex(b), 0);
+}
+
+/**
+ * @brief Test that a freed slot is reused with a new generation, so the old handle stays stale.
+ */
+TEST(libboids_slot_map, reuse) {
+    boids::SlotMap      slots;
+    const boids::BoidId a = slots.insert(0);
+    slots.erase(a);
+    const boids::BoidId b = slots.insert(0);
+    ASSERT_NE(a, b);
+    ASSERT_EQ(a & (boids::SlotMap::MAX_SLOTS - 1), b & (boids::SlotMap::MAX_SLOTS - 1));
+    ASSERT_FALSE(slots.contains(a));
+    ASSERT_TRUE(slots.contains(b));
+    ASSERT_FALSE(slots.contains(b + 1));
+}
+
+/**
+ * @brief Test that a slot is retired once its generations run out, rather than handing out a
+ * handle that was already used.
+ */
+TEST(libboids_slot_map, retire) {
+    boids::SlotMap          slots;
+    std::set<boids::BoidId> seen;
+    for (uint32_t i = 0; i <= boids::SlotMap::MAX_GENERATION + 1; ++i) {
+        const boids::BoidId id = slots.insert(0);
+        ASSERT_TRUE(seen.insert(id).second);
+        slots.erase(id);
+    }
+    ASSERT_EQ(slots.insert(0) & (boids::SlotMap::MAX_SLOTS - 1), 1);
+}
+
+/**
+ * @brief Test that clearing the map makes every handle stale.
+ */
+TEST(libboids_slot_map, clear) {
+    boids::SlotMap             slots;
+    std::vector<boids::BoidId> ids;
+    for (std::size_t i = 0; i < 10; ++i) {
+        ids.push_back(slots.insert(i));
+    }
+    slots.clear();
+    ASSERT_EQ(slots.size(), 0);
+    for (const auto id : ids) {
+        ASSERT_FALSE(slots.contains(id));
+    }
+    ASSERT_EQ(slots.insert(0) & (boids::SlotMap::MAX_SLOTS - 1), 0);
+}
+
+/**
+ * @brief Test that the handles that can still be given out are counted, including the free and the
+ * unused slots but not the retired ones, and that insert() throws once there are none left.
+ */
+TEST(libboids_slot_map, available) {
+    boids::SlotMap slots;
+    ASSERT_EQ(slots.available(), boids::SlotMap::MAX_SLOTS);
+
+    // Retire the first slot.
+    for (uint32_t i = 0; i <= boids::SlotMap::MAX_GENERATION; ++i) {
+        slots.erase(slots.insert(0));
+    }
+    ASSERT_EQ(slots.available(), boids::SlotMap::MAX_SLOTS - 1);
+
+    std::vector<boids::BoidId> ids;
+    while (slots.available() > 0) {
+        ids.push_back(slots.insert(ids.size()));
+    }
+    ASSERT_EQ(ids.size(), boids::SlotMap::MAX_SLOTS - 1);
+    ASSERT_THROW(slots.insert(0), std::length_error);
+
+    slots.erase(ids.back());
+    ASSERT_EQ(slots.available(), 1);
+    ASSERT_TRUE(slots.contains(slots.insert(0)));
+    ASSERT_EQ(slots.available(), 0);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <spatial_grid.h>
+#include <utils.h>
+
+/**
+ * @brief Create a vector of Boids at random positions within (and slightly outside of) the
+ * given bounds.
+ */
+std::vector<boids::Boid> createRandomBoids(const std::size_t count, const boids::Rect& bounds) {
+    std::vector<boids::Boid> ret;
+    for (std::size_t i = 0; i < count; ++i) {
+        const float x = boids::utils::generateRandomValue<float>(bounds.left() - 5.0f,
+                                                                 bounds.right() + 5.0f);
+        const float y = boids::utils::generateRandomValue<float>(bounds.top() - 5.0f,
+                                                                 bounds.bottom() + 5.0f);
+        ret.push_back(boids::Boid(i, x, y, 0.0f, 0.0f));
+    }
+    return ret;
+}
+
+/**
+ * @brief Test that the grid neighbourhood matches the brute-force neighbourhood exactly,
+ * including neighbours across the wrapped edges of the scene.
+ */
+TEST(libboids_spatial_grid, neighbourhoodMatchesBruteForce) {
+    const boids::Rect              bounds(-50.0f, 20.0f, 800.0f, 600.0f);
+    const float                    dist  = 80.0f;
+    const std::vector<boids::Boid> flock = createRandomBoids(500, bounds);
+
+    boids::SpatialGrid grid;
+    grid.rebuild(flock, dist, bounds);
+    ASSERT_EQ(grid.getNumCols(), 10);
+    ASSERT_EQ(grid.getNumRows(), 7);
+
+    for (const boids::Boid& b : flock) {
+        const auto exp = boids::utils::getBoidNeighbourhood(b, flock, dist, bounds);
+        const auto res = boids::utils::getBoidNeighbourhood(b, flock, grid, dist, bounds);
+        ASSERT_EQ(exp.size(), res.size());
+        for (std::size_t i = 0; i < exp.size(); ++i) {
+            ASSERT_EQ(exp[i].getId(), res[i].getId());
+        }
+    }
+}
+
+/**
+ * @brief Test that a grid with fewer than three cells along an axis doesn't return duplicate
+ * candidates.
+ */
+TEST(libboids_spatial_grid, smallGridNoDuplicates) {
+    const boids::Rect              bounds(0.0f, 0.0f, 100.0f, 100.0f);
+    const std::vector<boids::Boid> flock = createRandomBoids(50, bounds);
+
+    boids::SpatialGrid grid;
+    grid.rebuild(flock, 40.0f, bounds);
+    ASSERT_EQ(grid.getNumCols(), 2);
+
+    std::vector<std::size_t> candidates;
+    grid.getCandidates(boids::Vec2(10.0f, 10.0f), candidates);
+    ASSERT_EQ(candidates.size(), flock.size());
+}
+
+/**
+ * @brief Test that empty scene bounds fall back to a single cell containing every boid.
+ */
+TEST(libboids_spatial_grid, emptyBounds) {
+    const std::vector<boids::Boid> flock =
+        createRandomBoids(10, boids::Rect(0.0f, 0.0f, 10.0f, 10.0f));
+
+    boids::SpatialGrid grid;
+    grid.rebuild(flock, 80.0f, boids::Rect());
+    ASSERT_EQ(grid.getNumCols(), 1);
+    ASSERT_EQ(grid.getNumRows(), 1);
+
+    std::vector<std::size_t> candidates;
+    grid.getCandidates(boids::Vec2(0.0f, 0.0f), candidates);
+    ASSERT_EQ(candidates.size(), flock.size());
+}
+
+/**
+ * @brief Test that the halo holds every neighbour of every boid exactly once, at a position from
+ * which the plain displacement is the same as the wrapped one.
+ */
+TEST(libboids_spatial_grid, haloMatchesBruteForce) {
+    const boids::Rect              bounds(-50.0f, 20.0f, 800.0f, 600.0f);
+    const float                    dist  = 80.0f;
+    const std::vector<boids::Boid> flock = createRandomBoids(500, bounds);
+
+    boids::SpatialGrid grid;
+    grid.rebuild(flock, dist, bounds);
+    grid.buildHalo();
+    ASSERT_TRUE(grid.hasHalo());
+
+    // The boid index and position of every slot, with the ghosts after the slots of the grid.
+    std::vector<std::size_t> slotIndex = grid.getEntries();
+    std::vector<boids::Vec2> slotPos;
+    for (const std::size_t& i : slotIndex) {
+        slotPos.push_back(grid.getHaloPosition(flock[i].getPosition()));
+    }
+    grid.forEachHaloCell([&](const std::size_t& ghost, const std::size_t& source,
+                             const std::size_t& count, const float& dx, const float& dy) {
+        ASSERT_EQ(slotIndex.size(), flock.size() + ghost);
+        for (std::size_t s = source; s < source + count; ++s) {
+            slotIndex.push_back(slotIndex[s]);
+            slotPos.push_back(slotPos[s] + boids::Vec2(dx, dy));
+        }
+    });
+    ASSERT_EQ(slotIndex.size(), flock.size() + grid.getNumGhosts());
+
+    for (const boids::Boid& b : flock) {
+        const boids::Vec2 pos = grid.getHaloPosition(b.getPosition());
+        std::size_t       ranges[2 * boids::SpatialGrid::MAX_RANGES];
+        const std::size_t numRanges = grid.getHaloSlotRanges(pos, ranges);
+
+        std::vector<int> seen(flock.size(), 0);
+        for (std::size_t r = 0; r < numRanges; ++r) {
+            for (std::size_t k = ranges[2 * r]; k < ranges[2 * r + 1]; ++k) {
+                const std::size_t i = slotIndex[k];
+                ASSERT_EQ(seen[i]++, 0);
+
+                const float wrapped = boids::utils::distanceBetweenBoids(b, flock[i], bounds);
+                if (wrapped <= dist) {
+                    ASSERT_NEAR((slotPos[k] - pos).length(), wrapped, 1e-3f);
+                }
+            }
+        }
+
+        for (const boids::Boid& n : boids::utils::getBoidNeighbourhood(b, flock, dist, bounds)) {
+            ASSERT_EQ(seen[n.getId()], 1);
+        }
+    }
+}
+
+/**
+ * @brief Test that no halo is laid out for a grid with fewer than three cells along an axis.
+ */
+TEST(libboids_spatial_grid, smallGridNoHalo) {
+    const boids::Rect              bounds(0.0f, 0.0f, 300.0f, 100.0f);
+    const std::vector<boids::Boid> flock = createRandomBoids(50, bounds);
+
+    boids::SpatialGrid grid;
+    grid.rebuild(flock, 40.0f, bounds);
+    ASSERT_EQ(grid.getNumCols(), 7);
+    ASSERT_EQ(grid.getNumRows(), 2);
+
+    grid.buildHalo();
+    ASSERT_FALSE(grid.hasHalo());
+    ASSERT_EQ(grid.getNumGhosts(), 0);
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <step_stats.h>
+
+/**
+ * @brief Test that the window keeps only the most recent steps, oldest first.
+ */
+TEST(libboids_step_stats, window_push) {
+    boids::StepStatsWindow window(3);
+    ASSERT_EQ(window.size(), 0);
+    ASSERT_EQ(window.capacity(), 3);
+
+    for (uint64_t i = 0; i < 5; ++i) {
+        boids::StepStats s;
+        s.step = i;
+        window.push(s);
+    }
+    ASSERT_EQ(window.size(), 3);
+    ASSERT_EQ(window.at(0).step, 2);
+    ASSERT_EQ(window.at(2).step, 4);
+
+    window.clear();
+    ASSERT_EQ(window.size(), 0);
+}
+
+/**
+ * @brief Test that the window mean averages the timings and counters, and keeps the maximum of
+ * the maximum neighbour count.
+ */
+TEST(libboids_step_stats, window_mean) {
+    boids::StepStatsWindow window(4);
+    ASSERT_EQ(window.getMean().totalNs, 0);
+
+    for (uint64_t i = 1; i <= 4; ++i) {
+        boids::StepStats s;
+        s.step          = i;
+        s.totalNs       = 100 * i;
+        s.numBoids      = 10;
+        s.neighbours    = 10 * i;
+        s.maxNeighbours = 5 - i;
+        window.push(s);
+    }
+
+    const boids::StepStats mean = window.getMean();
+    ASSERT_EQ(mean.step, 4);
+    ASSERT_EQ(mean.totalNs, 250);
+    ASSERT_EQ(mean.neighbours, 25);
+    ASSERT_EQ(mean.maxNeighbours, 4);
+    ASSERT_DOUBLE_EQ(mean.getMeanNeighbours(), 2.5);
+}
+
+/**
+ * @brief Test that allocations are recorded per thread.
+ */
+TEST(libboids_step_stats, recordAllocation) {
+    const uint64_t before = boids::getThreadAllocations();
+    boids::recordAllocation();
+    boids::recordAllocation();
+    ASSERT_EQ(boids::getThreadAllocations() - before, 2);
+}
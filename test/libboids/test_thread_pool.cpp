@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <thread_pool.h>
+
+/**
+ * @brief Test that a single threaded pool has no worker threads and still runs the loop.
+ */
+TEST(libboids_thread_pool, singleThread) {
+    boids::ThreadPool pool(1);
+    ASSERT_EQ(pool.getNumThreads(), 1);
+
+    std::size_t sum = 0;
+    pool.parallelFor(100, [&](std::size_t begin, std::size_t end, std::size_t worker) {
+        ASSERT_EQ(worker, 0);
+        for (std::size_t i = begin; i < end; ++i) {
+            sum += i;
+        }
+    });
+    ASSERT_EQ(sum, 4950);
+}
+
+/**
+ * @brief Test that every element of the range is visited exactly once across all the threads,
+ * over multiple jobs on the same pool.
+ */
+TEST(libboids_thread_pool, visitEachElementOnce) {
+    boids::ThreadPool pool(4);
+    ASSERT_EQ(pool.getNumThreads(), 4);
+
+    for (std::size_t job = 0; job < 10; ++job) {
+        std::vector<int> visits(10000, 0);
+        pool.parallelFor(visits.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t i = begin; i < end; ++i) {
+                visits[i]++;
+            }
+        });
+
+        for (const int& v : visits) {
+            ASSERT_EQ(v, 1);
+        }
+    }
+}
+
+/**
+ * @brief Test that an exception thrown on a worker thread is rethrown on the calling thread, and
+ * that the pool can still be used afterwards.
+ */
+TEST(libboids_thread_pool, exceptionIsRethrown) {
+    boids::ThreadPool pool(4);
+
+    ASSERT_THROW(pool.parallelFor(1000,
+                                  [](std::size_t begin, std::size_t, std::size_t) {
+                                      if (begin > 0)
+                                          throw std::invalid_argument("Test");
+                                  }),
+                 std::invalid_argument);
+
+    ASSERT_NO_THROW(pool.parallelFor(1000, [](std::size_t, std::size_t, std::size_t) {}));
+}
+
+/**
+ * @brief Test that a chunk size of one hands out a single element at a time, and still visits
+ * every element once.
+ */
+TEST(libboids_thread_pool, chunkSize) {
+    boids::ThreadPool pool(4);
+
+    std::vector<int> visits(100, 0);
+    pool.parallelFor(
+        visits.size(),
+        [&](std::size_t begin, std::size_t end, std::size_t) {
+            ASSERT_EQ(end - begin, 1);
+            visits[begin]++;
+        },
+        1);
+
+    for (const int& v : visits) {
+        ASSERT_EQ(v, 1);
+    }
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <trace.h>
+
+/**
+ * @brief Count the occurrences of a substring.
+ * @param s String to search.
+ * @param sub Substring to count.
+ * @return Number of occurrences.
+ */
+std::size_t countOccurrences(const std::string& s, const std::string& sub) {
+    std::size_t count = 0;
+    for (std::size_t pos = s.find(sub); pos != std::string::npos; pos = s.find(sub, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Test that zones and flows recorded on different threads are all written out, with the
+ * flow linking the two threads.
+ */
+TEST(libboids_trace, zonesAndFlows) {
+    constexpr uint64_t id = 0x7e57f10;
+
+    boids::trace::setEnabled(true);
+    std::thread producer([&] {
+        boids::trace::setThreadName("test_trace producer");
+        boids::trace::Zone zone("test_trace::produce");
+        boids::trace::flowStart(id);
+    });
+    producer.join();
+    {
+        boids::trace::Zone zone("test_trace::consume");
+        boids::trace::flowEnd(id);
+    }
+    boids::trace::setEnabled(false);
+
+    std::ostringstream out;
+    ASSERT_GE(boids::trace::writeChromeTrace(out), 4);
+    const std::string json = out.str();
+    ASSERT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0);
+    ASSERT_EQ(countOccurrences(json, "\"args\":{\"name\":\"test_trace producer\"}"), 1);
+    ASSERT_EQ(countOccurrences(json, "\"name\":\"test_trace::produce\",\"ph\":\"X\""), 1);
+    ASSERT_EQ(countOccurrences(json, "\"name\":\"test_trace::consume\",\"ph\":\"X\""), 1);
+    ASSERT_EQ(countOccurrences(json, "\"ph\":\"s\",\"id\":" + std::to_string(id) + ","), 1);
+    ASSERT_EQ(countOccurrences(json, "\"ph\":\"f\",\"bp\":\"e\",\"id\":" + std::to_string(id)), 1);
+}
+
+/**
+ * @brief Test that nothing is recorded while tracing is disabled.
+ */
+TEST(libboids_trace, disabled) {
+    boids::trace::setEnabled(false);
+    { boids::trace::Zone zone("test_trace::disabled"); }
+
+    std::ostringstream out;
+    boids::trace::writeChromeTrace(out);
+    ASSERT_EQ(countOccurrences(out.str(), "test_trace::disabled"), 0);
+}
+
+/**
+ * @brief Test that once a thread's buffer is full, its oldest events are overwritten.
+ */
+TEST(libboids_trace, overwriteOldest) {
+    boids::trace::setEnabled(true);
+    std::thread recorder([] {
+        for (std::size_t i = 0; i < boids::trace::EVENTS_PER_THREAD + 10; ++i) {
+            boids::trace::Zone zone(i < 10 ? "test_trace::oldest" : "test_trace::newest");
+        }
+    });
+    recorder.join();
+    boids::trace::setEnabled(false);
+
+    std::ostringstream out;
+    boids::trace::writeChromeTrace(out);
+    ASSERT_EQ(countOccurrences(out.str(), "test_trace::oldest"), 0);
+    ASSERT_EQ(countOccurrences(out.str(), "test_trace::newest"), boids::trace::EVENTS_PER_THREAD);
+}
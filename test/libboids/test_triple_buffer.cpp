@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <triple_buffer.h>
+
+/**
+ * @brief Test that fetching with nothing published returns false, and that a single publish is
+ * picked up once.
+ */
+TEST(libboids_triple_buffer, fetch_once) {
+    boids::TripleBuffer<int> buffer;
+    ASSERT_FALSE(buffer.fetch());
+
+    buffer.getWriteBuffer() = 7;
+    buffer.publish();
+    ASSERT_TRUE(buffer.fetch());
+    ASSERT_EQ(buffer.getReadBuffer(), 7);
+    ASSERT_FALSE(buffer.fetch());
+    ASSERT_EQ(buffer.getReadBuffer(), 7);
+}
+
+/**
+ * @brief Test that the reader only sees the latest of several values published between fetches.
+ */
+TEST(libboids_triple_buffer, fetch_latest) {
+    boids::TripleBuffer<int> buffer;
+    for (int i = 1; i <= 5; ++i) {
+        buffer.getWriteBuffer() = i;
+        buffer.publish();
+    }
+    ASSERT_TRUE(buffer.fetch());
+    ASSERT_EQ(buffer.getReadBuffer(), 5);
+    ASSERT_FALSE(buffer.fetch());
+}
+
+/**
+ * @brief Test that a reader on another thread only ever sees complete values, in the order they
+ * were published.
+ */
+TEST(libboids_triple_buffer, concurrent) {
+    constexpr std::size_t                 size   = 64;
+    constexpr uint64_t                    frames = 20000;
+    boids::TripleBuffer<std::vector<uint64_t>> buffer;
+
+    std::thread writer([&buffer]() {
+        for (uint64_t frame = 1; frame <= frames; ++frame) {
+            std::vector<uint64_t>& v = buffer.getWriteBuffer();
+            v.assign(size, frame);
+            buffer.publish();
+        }
+    });
+
+    uint64_t last = 0;
+    while (last < frames) {
+        if (!buffer.fetch())
+            continue;
+        const std::vector<uint64_t>& v = buffer.getReadBuffer();
+        ASSERT_EQ(v.size(), size);
+        ASSERT_GT(v.front(), last);
+        for (const uint64_t value : v) {
+            ASSERT_EQ(value, v.front());
+        }
+        last = v.front();
+    }
+    writer.join();
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <types.h>
+
+/**
+ * @brief Test that normalising a vector gives a unit vector, and leaves a zero vector as zero.
+ */
+TEST(libboids_types, vec2_normalized) {
+    const boids::Vec2 v = boids::Vec2(3.0f, 4.0f).normalized();
+    ASSERT_FLOAT_EQ(v.x(), 0.6f);
+    ASSERT_FLOAT_EQ(v.y(), 0.8f);
+    ASSERT_EQ(boids::Vec2().normalized(), boids::Vec2());
+}
+
+/**
+ * @brief Test the arithmetic operators of the vector.
+ */
+TEST(libboids_types, vec2_operators) {
+    boids::Vec2 v(1.0f, 2.0f);
+    v += boids::Vec2(1.0f, 1.0f);
+    ASSERT_EQ(v, boids::Vec2(2.0f, 3.0f));
+    ASSERT_EQ(v * 2.0f, boids::Vec2(4.0f, 6.0f));
+    ASSERT_EQ(2.0f * v, boids::Vec2(4.0f, 6.0f));
+    ASSERT_EQ(v / 2.0f, boids::Vec2(1.0f, 1.5f));
+    ASSERT_EQ(v - boids::Vec2(2.0f, 3.0f), boids::Vec2());
+    ASSERT_EQ(-v, boids::Vec2(-2.0f, -3.0f));
+}
+
+/**
+ * @brief Test that the edges of a rectangle are calculated from its corner and size.
+ */
+TEST(libboids_types, rect_edges) {
+    const boids::Rect r(-10.0f, 5.0f, 20.0f, 30.0f);
+    ASSERT_EQ(r.left(), -10.0f);
+    ASSERT_EQ(r.right(), 10.0f);
+    ASSERT_EQ(r.top(), 5.0f);
+    ASSERT_EQ(r.bottom(), 35.0f);
+    ASSERT_FALSE(r.isEmpty());
+    ASSERT_TRUE(boids::Rect().isEmpty());
+}
+
+/**
+ * @brief Test that primary colours are converted to the right hue, and back to RGB.
+ */
+TEST(libboids_types, color_rgbToHsv) {
+    const boids::Color red(255, 0, 0);
+    ASSERT_EQ(red.hsvHue(), 0);
+    ASSERT_EQ(red.saturation(), 255);
+    ASSERT_EQ(red.value(), 255);
+
+    const boids::Color green(0, 255, 0);
+    ASSERT_EQ(green.hsvHue(), 120);
+
+    const boids::Color blue(0, 0, 255);
+    ASSERT_EQ(blue.hsvHue(), 240);
+    ASSERT_EQ(blue.red(), 0);
+    ASSERT_EQ(blue.green(), 0);
+    ASSERT_EQ(blue.blue(), 255);
+
+    const boids::Color grey(100, 100, 100);
+    ASSERT_EQ(grey.hsvHue(), -1);
+    ASSERT_EQ(grey.saturation(), 0);
+    ASSERT_EQ(grey.red(), 100);
+}
+
+/**
+ * @brief Test that a colour set from HSV keeps its exact components.
+ */
+TEST(libboids_types, color_setHsv) {
+    boids::Color c;
+    c.setHsv(200, 128, 64);
+    ASSERT_EQ(c.hsvHue(), 200);
+    ASSERT_EQ(c.saturation(), 128);
+    ASSERT_EQ(c.value(), 64);
+    ASSERT_EQ(c, boids::Color::fromHsv(200, 128, 64));
+}
@@ -8,8 +8,8 @@ TEST_CASE("Test the calculateAlignmentVector() method", "[utils]") {
         const boids::Boid              boid(0, 0.0, 0.0);
         const std::vector<boids::Boid> neighbours;
 
-        const QVector2D exp(0.0, 0.0);
-        const QVector2D res = boids::utils::calculateAlignmentVector(boid, neighbours);
+        const boids::Vec2 exp(0.0, 0.0);
+        const boids::Vec2 res = boids::utils::calculateAlignmentVector(boid, neighbours);
 
         THEN("The alignment vector should be zero") { REQUIRE(exp == res); }
     }
@@ -18,7 +18,7 @@ TEST_CASE("Test the calculateAlignmentVector() method", "[utils]") {
         std::vector<boids::Boid> neighbours;
         neighbours.push_back(boids::Boid(1, 1.0, 1.0, 1.0, 0.0));
 
-        const QVector2D res = boids::utils::calculateAlignmentVector(boid, neighbours);
+        const boids::Vec2 res = boids::utils::calculateAlignmentVector(boid, neighbours);
 
         THEN("The resulting vector should be greater than 0.0") {
             REQUIRE(res.x() >= 0.0);
@@ -36,8 +36,8 @@ TEST_CASE("Test the calculateAlignmentVector() method", "[utils]") {
         neighbours.push_back(boids::Boid(1, 1.0, 1.0, 1.0, 1.0));
         neighbours.push_back(boids::Boid(2, 1.0, 1.0, -1.0, 1.0));
 
-        const QVector2D exp(0.0, 1.0);
-        const QVector2D res = boids::utils::calculateAlignmentVector(boid, neighbours);
+        const boids::Vec2 exp(0.0, 1.0);
+        const boids::Vec2 res = boids::utils::calculateAlignmentVector(boid, neighbours);
 
         THEN("The alignment vector should be straight forward") { REQUIRE(exp == res); }
     }
@@ -47,7 +47,7 @@ TEST_CASE("Test the calculateCohesionVector() method", "[utils]") {
     WHEN("There are no neighbours") {
         const boids::Boid boid(0, 0.0, 0.0);
         const auto        neighbours = std::vector<boids::Boid>();
-        const QRectF      bounds(0.0, 0.0, 1.0, 1.0);
+        const boids::Rect bounds(0.0, 0.0, 1.0, 1.0);
         const auto        result = boids::utils::calculateCohesionVector(boid, neighbours, bounds);
 
         THEN("The output vector should be zero") {
@@ -58,7 +58,7 @@ TEST_CASE("Test the calculateCohesionVector() method", "[utils]") {
     WHEN("There is one neighbour Boid") {
         const boids::Boid boid(0, 0.0, 0.0);
         const auto        neighbours = std::vector<boids::Boid>({boids::Boid(1, 1.0, 0.0)});
-        const QRectF      bounds(0.0, 0.0, 1.0, 1.0);
+        const boids::Rect bounds(0.0, 0.0, 1.0, 1.0);
 
         THEN("The output vector should be zero") {
             const auto result = boids::utils::calculateCohesionVector(boid, neighbours, bounds);
@@ -67,7 +67,7 @@ TEST_CASE("Test the calculateCohesionVector() method", "[utils]") {
         }
     }
     WHEN("There are two nighbours") {
-        const QRectF      bounds(-1.0, -1.0, 2.0, 2.0);
+        const boids::Rect bounds(-1.0, -1.0, 2.0, 2.0);
         const boids::Boid boid(0, 0.0, 0.0);
         const auto        neighbours =
             std::vector<boids::Boid>({boids::Boid(1, 1.0, 0.0), boids::Boid(2, -1.0, 0.0)});
@@ -79,7 +79,7 @@ TEST_CASE("Test the calculateCohesionVector() method", "[utils]") {
         }
     }
     WHEN("There are three neighbours") {
-        const QRectF      bounds(-4.0, -4.0, 8.0, 8.0);
+        const boids::Rect bounds(-4.0, -4.0, 8.0, 8.0);
         const boids::Boid boid(0, 0.0, 0.0);
         const auto        neighbours = std::vector<boids::Boid>(
             {boids::Boid(1, 1.0, 1.0), boids::Boid(2, 2.0, 1.0), boids::Boid(3, 3.0, 1.0)});
@@ -94,7 +94,7 @@ TEST_CASE("Test the calculateCohesionVector() method", "[utils]") {
         }
     }
     WHEN("There is one neighbour, wrapped around the X axis") {
-        const QRectF      bounds(0.0, 0.0, 1.0, 1.0);
+        const boids::Rect bounds(0.0, 0.0, 1.0, 1.0);
         const boids::Boid boid(0, 0.3, 0.0);
         const auto        neighbours = std::vector<boids::Boid>({boids::Boid(1.0, 0.95, 0.0)});
         const auto        result = boids::utils::calculateCohesionVector(boid, neighbours, bounds);
@@ -105,7 +105,7 @@ TEST_CASE("Test the calculateCohesionVector() method", "[utils]") {
         THEN("The vector should be zero in the Y axis") { REQUIRE(result.y() == 0.0); }
     }
     WHEN("There is one neighbour, wrapped around the Y axis") {
-        const QRectF      bounds(0.0, 0.0, 1.0, 1.0);
+        const boids::Rect bounds(0.0, 0.0, 1.0, 1.0);
         const boids::Boid boid(0, 0.1, 0.3);
         const auto        neighbours = std::vector<boids::Boid>({boids::Boid(1.0, 0.1, 0.95)});
         const auto        result = boids::utils::calculateCohesionVector(boid, neighbours, bounds);
@@ -114,7 +114,7 @@ TEST_CASE("Test the calculateCohesionVector() method", "[utils]") {
         THEN("The vector should be negative in the Y axis") { REQUIRE(result.y() < 0.0); }
     }
     WHEN("There is one neighbour wrapped in both the X and Y axis") {
-        const QRectF      bounds(0.0, 0.0, 1.0, 1.0);
+        const boids::Rect bounds(0.0, 0.0, 1.0, 1.0);
         const boids::Boid boid(0, 0.3, 0.3);
         const auto        neighbours = std::vector<boids::Boid>({boids::Boid(1.0, 0.95, 0.95)});
         const auto        result = boids::utils::calculateCohesionVector(boid, neighbours, bounds);
@@ -124,7 +124,7 @@ TEST_CASE("Test the calculateCohesionVector() method", "[utils]") {
     }
 
     GIVEN("A Boid at the very top of the space : (X = 0.5, Y = 0.05)") {
-        const QRectF      bounds(0.0, 0.0, 1.0, 1.0);
+        const boids::Rect bounds(0.0, 0.0, 1.0, 1.0);
         const boids::Boid boid(0, 0.5f, 0.05f);
 
         WHEN("There are two boids at the very bottom of the space") {
@@ -165,12 +165,12 @@ TEST_CASE("Test the calculateCohesionVector() method", "[utils]") {
 
 TEST_CASE("Test the calculateSeparationVector() method", "[utils]") {
     WHEN("A boid with a single neighbour outside the main radius") {
-        const QRectF                   bounds(0.0, 0.0, 1.0, 1.0);
+        const boids::Rect              bounds(0.0, 0.0, 1.0, 1.0);
         const float                    minDist = 0.5f;
         const boids::Boid              boid(0, 0.0f, 0.0f);
         const std::vector<boids::Boid> neighbours;
 
-        const QVector2D result =
+        const boids::Vec2 result =
             boids::utils::calculateSeparationVector(boid, neighbours, minDist, bounds);
 
         THEN("The result vector should be (0.0, 0.0)") {
@@ -179,13 +179,13 @@ TEST_CASE("Test the calculateSeparationVector() method", "[utils]") {
         }
     }
     WHEN("A boid with a different single neighbour outside the main radius") {
-        const QRectF             bounds(0.0, 0.0, 2.0, 2.0);
+        const boids::Rect        bounds(0.0, 0.0, 2.0, 2.0);
         const float              minDist = 0.5f;
         const boids::Boid        boid(0, 0.0f, 0.0f);
         std::vector<boids::Boid> neighbours;
         neighbours.push_back(boids::Boid(1, 1.0f, 0.0f));
 
-        const QVector2D result =
+        const boids::Vec2 result =
             boids::utils::calculateSeparationVector(boid, neighbours, minDist, bounds);
 
         THEN("The result vector should be (0.0, 0.0)") {
@@ -194,12 +194,12 @@ TEST_CASE("Test the calculateSeparationVector() method", "[utils]") {
         }
     }
     WHEN("A boid with a single neighbour within the minimum radius") {
-        const QRectF             bounds(0.0, 0.0, 1.0, 1.0);
+        const boids::Rect        bounds(0.0, 0.0, 1.0, 1.0);
         const float              minDist = 0.5f;
         const boids::Boid        boid(0, 1.0f, 0.0f);
         std::vector<boids::Boid> neighbours = {boids::Boid(1, 1.0f, 0.1f)};
 
-        const QVector2D result =
+        const boids::Vec2 result =
             boids::utils::calculateSeparationVector(boid, neighbours, minDist, bounds);
 
         THEN("The length of the vector should be greater than zero") {
@@ -208,26 +208,26 @@ TEST_CASE("Test the calculateSeparationVector() method", "[utils]") {
     }
     WHEN("Test that a boid with a single neighbour, at exactly the same point has a force vector "
          "magnitude equal to 1.0.") {
-        const QRectF             bounds(0.0, 0.0, 1.0, 1.0);
+        const boids::Rect        bounds(0.0, 0.0, 1.0, 1.0);
         const float              minDist = 1.0f;
         const boids::Boid        boid(0, 0.0f, 0.0f);
         std::vector<boids::Boid> neighbours = {boids::Boid(1, 0.0f, 0.0f)};
 
-        const QVector2D result =
+        const boids::Vec2 result =
             boids::utils::calculateSeparationVector(boid, neighbours, minDist, bounds);
 
         THEN("The result vector should be equal to 1.0") { REQUIRE(result.length() == 1.0f); }
     }
     WHEN("Test that a boid with a neighbour either side results in a separation vector of length "
          "zero because the forces from the neighbours cancel each other out.") {
-        const QRectF             bounds(0.0, 0.0, 1.0, 1.0);
+        const boids::Rect        bounds(0.0, 0.0, 1.0, 1.0);
         const float              minDist = 1.0f;
         const boids::Boid        boid(0, 0.0f, 0.0f);
         std::vector<boids::Boid> neighbours;
         neighbours.push_back(boids::Boid(1, 0.5f, 0.0f));
         neighbours.push_back(boids::Boid(2, -0.5f, 0.0f));
 
-        const QVector2D result =
+        const boids::Vec2 result =
             boids::utils::calculateSeparationVector(boid, neighbours, minDist, bounds);
 
         THEN("The result vector should be nearly 0.0") {
@@ -237,13 +237,13 @@ TEST_CASE("Test the calculateSeparationVector() method", "[utils]") {
     }
     WHEN("Test that a boid with three neighbours, two either side and one behind results in a "
          "forward pointing separation vector.") {
-        const QRectF             bounds(-3.0, -3.0, 6.0, 6.0);
+        const boids::Rect        bounds(-3.0, -3.0, 6.0, 6.0);
         const float              minDist = 2.0f;
         const boids::Boid        boid(0, 0.0f, 0.0f);
         std::vector<boids::Boid> neighbours = {
             boids::Boid(1, -0.5f, 0.0f), boids::Boid(2, 0.0f, 0.5f), boids::Boid(3, 0.0f, -1.0f)};
 
-        const QVector2D res =
+        const boids::Vec2 res =
             boids::utils::calculateSeparationVector(boid, neighbours, minDist, bounds);
 
         THEN("The resulting vector should be (0.0, 0.0)") {
@@ -253,14 +253,14 @@ TEST_CASE("Test the calculateSeparationVector() method", "[utils]") {
     }
     WHEN("Test that a boid with four neighbours all around results in a separation vector of "
          "length zero because the forces from the neighbours cancel each other out.") {
-        const QRectF             bounds(-5.0, 5.0, 10.0, 10.0);
+        const boids::Rect        bounds(-5.0, 5.0, 10.0, 10.0);
         const float              minDist = 2.0f;
         const boids::Boid        boid(0, 0.0f, 0.0f);
         std::vector<boids::Boid> neighbours = {
             boids::Boid(1, 1.0f, 0.0f), boids::Boid(2, 0.0f, 1.0f), boids::Boid(3, 0.0f, -1.0f),
             boids::Boid(4, -1.0f, 0.0f)};
 
-        const QVector2D res =
+        const boids::Vec2 res =
             boids::utils::calculateSeparationVector(boid, neighbours, minDist, bounds);
 
         THEN("The vector values should be zero.") {
@@ -274,17 +274,17 @@ TEST_CASE("Test the clipVectorMagnitude() method", "[utils]") {
     WHEN("The vector length is within the allowed bounds") {
         const float minMag = 0.2f;
         const float maxMag = 5.0f;
-        QVector2D   vec(-0.1f, 0.0f);
+        boids::Vec2 vec(-0.1f, 0.0f);
         boids::utils::clipVectorMangitude(vec, minMag, maxMag);
 
         THEN("The clipped vector X element should be -0.2") { REQUIRE(vec.x() == -0.2f); }
         THEN("The clipped vector Y element should be 0.0") { REQUIRE(vec.y() == 0.0f); }
     }
     WHEN("The vector length is under the maximum value") {
-        const float     minMag = 0.2f;
-        const float     maxMag = 50.0f;
-        const QVector2D exp(10.0f, 0.0f);
-        QVector2D       vec(10.0f, 0.0f);
+        const float       minMag = 0.2f;
+        const float       maxMag = 50.0f;
+        const boids::Vec2 exp(10.0f, 0.0f);
+        boids::Vec2       vec(10.0f, 0.0f);
         boids::utils::clipVectorMangitude(vec, minMag, maxMag);
 
         THEN("The clipped vector X element should be 10.0") { REQUIRE(vec.x() == 10.0f); }
@@ -293,7 +293,7 @@ TEST_CASE("Test the clipVectorMagnitude() method", "[utils]") {
     WHEN("The vector length is over the maximum value") {
         const float minMag = 0.2f;
         const float maxMag = 5.0f;
-        QVector2D   vec(10.0f, 0.0f);
+        boids::Vec2 vec(10.0f, 0.0f);
         boids::utils::clipVectorMangitude(vec, minMag, maxMag);
 
         THEN("The clipped vector X element should be 5.0") { REQUIRE(vec.x() == 5.0f); }
@@ -302,7 +302,7 @@ TEST_CASE("Test the clipVectorMagnitude() method", "[utils]") {
     WHEN("Calling the method when the min/max arguments are mixed up") {
         const float minMag = 2.0f;
         const float maxMag = 1.0f;
-        QVector2D   vec(10.0f, 0.0f);
+        boids::Vec2 vec(10.0f, 0.0f);
 
         THEN("An exception should be thrown") {
             REQUIRE_THROWS(boids::utils::clipVectorMangitude(vec, minMag, maxMag));
@@ -328,7 +328,7 @@ TEST_CASE("Test the distanceBetweenBoids() method", "[utils]") {
         THEN("The distance should be 5.0") { REQUIRE(res == 5.0f); }
     }
     GIVEN("Boids are wrapped around the space") {
-        const QRectF bounds(0.0f, 0.0f, 20.0f, 10.0f);
+        const boids::Rect bounds(0.0f, 0.0f, 20.0f, 10.0f);
         WHEN("The boids are wrapped in the X axis") {
             const boids::Boid b1(0, 19.0f, 1.0f);
             const boids::Boid b2(1, 1.0f, 1.0f);
@@ -351,15 +351,16 @@ TEST_CASE("Test the distanceBetweenBoids() method", "[utils]") {
 }
 
 TEST_CASE("Test the distanceVectorBetweenPoint() method", "[utils]") {
-    const QRectF bounds(0.0, 0.0, 1.0, 1.0);
+    using boids::Vec2;
+    const boids::Rect bounds(0.0, 0.0, 1.0, 1.0);
 
     auto [p1, p2, expected] =
-        GENERATE(std::make_tuple(QPointF(0.0, 0.0), QPointF(0.0, 0.0), QVector2D(0.0, 0.0)),
-                 std::make_tuple(QPointF(0.0, 0.0), QPointF(0.1, 0.1), QVector2D(0.1, 0.1)),
-                 std::make_tuple(QPointF(0.1, 0.0), QPointF(0.9, 0.0), QVector2D(-0.2, 0.0)),
-                 std::make_tuple(QPointF(0.0, 0.1), QPointF(0.0, 0.9), QVector2D(0.0, -0.2)),
-                 std::make_tuple(QPointF(0.9, 0.0), QPointF(0.1, 0.0), QVector2D(0.2, 0.0)),
-                 std::make_tuple(QPointF(0.0, 0.9), QPointF(0.0, 0.1), QVector2D(0.0, 0.2)));
+        GENERATE(std::make_tuple(Vec2(0.0, 0.0), Vec2(0.0, 0.0), Vec2(0.0, 0.0)),
+                 std::make_tuple(Vec2(0.0, 0.0), Vec2(0.1, 0.1), Vec2(0.1, 0.1)),
+                 std::make_tuple(Vec2(0.1, 0.0), Vec2(0.9, 0.0), Vec2(-0.2, 0.0)),
+                 std::make_tuple(Vec2(0.0, 0.1), Vec2(0.0, 0.9), Vec2(0.0, -0.2)),
+                 std::make_tuple(Vec2(0.9, 0.0), Vec2(0.1, 0.0), Vec2(0.2, 0.0)),
+                 std::make_tuple(Vec2(0.0, 0.9), Vec2(0.0, 0.1), Vec2(0.0, 0.2)));
 
     const auto result = boids::utils::distanceVectorBetweenPoints(p1, p2, bounds);
 
@@ -432,8 +433,8 @@ TEST_CASE("Test the generateRandomValue() method", "[utils]") {
 
 TEST_CASE("Test the generateRandomVelocityVector() method", "[utils]") {
     for (std::size_t i = 0; i < 100; ++i) {
-        const float     maxVel = boids::utils::generateRandomValue<float>(1.0f, 10.0f);
-        const QVector2D res    = boids::utils::generateRandomVelocityVector(maxVel);
+        const float       maxVel = boids::utils::generateRandomValue<float>(1.0f, 10.0f);
+        const boids::Vec2 res    = boids::utils::generateRandomVelocityVector(maxVel);
         REQUIRE(res.length() >= 0.0f);
         REQUIRE(res.length() <= maxVel);
     }
@@ -441,8 +442,8 @@ TEST_CASE("Test the generateRandomVelocityVector() method", "[utils]") {
 
 TEST_CASE("Test the getBoidNeighbourhood() method", "[utils]") {
     GIVEN("A flock of Boids") {
-        const QRectF bounds(0.0f, 0.0f, 10.0f, 10.0f);
-        const float  minDist = 1.5f;
+        const boids::Rect bounds(0.0f, 0.0f, 10.0f, 10.0f);
+        const float       minDist = 1.5f;
 
         const boids::Boid boid(0, 0.0f, 0.0f);
 
@@ -481,7 +482,7 @@ TEST_CASE("Test the getBoidNeighbourhood() method", "[utils]") {
         const boids::Boid boid3(3, 0.9f, 0.9f);
         const boids::Boid boid4(4, 0.5f,
                                 0.5f); // This boid should not be part of the neighbourhood.
-        const QRectF      bounds(0.0f, 0.0f, 1.0f, 1.0f);
+        const boids::Rect bounds(0.0f, 0.0f, 1.0f, 1.0f);
         const float       minDist = 0.4;
 
         std::vector<boids::Boid> flock;
@@ -527,7 +528,7 @@ TEST_CASE("Test the getTotalNumBoids() method", "[utils]") {
 
 TEST_CASE("Test the scaleVector() method", "[utils]") {
     GIVEN("A vector with positive values") {
-        const QVector2D vec(3.0f, 4.0f);
+        const boids::Vec2 vec(3.0f, 4.0f);
 
         WHEN("Calling the scaleVector() method with a scalar of 5.0") {
             const float scalar = 5.0f;
@@ -542,7 +543,7 @@ TEST_CASE("Test the scaleVector() method", "[utils]") {
     }
 
     GIVEN("A vector with only a positive X value") {
-        const QVector2D vec(2.0f, 0.0f);
+        const boids::Vec2 vec(2.0f, 0.0f);
 
         WHEN("Calling the scaleVector() method with a scalar of 1.0") {
             const float scalar = 1.0f;
@@ -557,7 +558,7 @@ TEST_CASE("Test the scaleVector() method", "[utils]") {
     }
 
     GIVEN("A vector with only a positive Y value") {
-        const QVector2D vec(0.0f, 4.0f);
+        const boids::Vec2 vec(0.0f, 4.0f);
 
         WHEN("Calling the scaleVector() method with a scalar of 1.0") {
             const float scalar = 1.0f;
@@ -572,7 +573,7 @@ TEST_CASE("Test the scaleVector() method", "[utils]") {
     }
 
     GIVEN("A vector with negative values") {
-        const QVector2D vec(-3.0f, -4.0f);
+        const boids::Vec2 vec(-3.0f, -4.0f);
 
         WHEN("Calling the scaleVector() method with a scalar of 5.0") {
             const float scalar = 5.0f;
@@ -626,8 +627,8 @@ TEST_CASE("Test the shortestDistanceInWrappedSpace() method", "[utils]") {
 }
 
 TEST_CASE("Test the wrapBoidPosition() method", "[utils]") {
-    const QRectF space_rect(0.0f, 0.0f, 1.0f, 1.0f);
-    const float  epsilon = 0.001;
+    const boids::Rect space_rect(0.0f, 0.0f, 1.0f, 1.0f);
+    const float       epsilon = 0.001;
     GIVEN("A boid at (0.0, 1.1)") {
         boids::Boid boid(0, 0.0f, 1.1f);
         WHEN("Calling the wrapBoidPosition() method") {